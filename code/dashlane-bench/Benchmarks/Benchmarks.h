@@ -0,0 +1,12 @@
+#pragma once
+
+#include "MockServer/MockServer.h"
+
+namespace Dashlane
+{
+
+	// SyncBenchmarks.cpp
+	// One in-process mock server per vault size and latency, kept for the whole run
+	CMockServer& GetMockServer(size_t itemCount, uint32_t latencyMs);
+
+}
\ No newline at end of file
@@ -0,0 +1,591 @@
+#include "StdAfx.h"
+#include "SyntheticVault.h"
+
+#include <Encryption.h>
+#include <EnvelopeCodec.h>
+#include <Utility/Arena.h>
+#include <Utility/Base64.h>
+#include <Utility/Cryptography.h>
+#include <Utility/Transaction.h>
+#include <Utility/Vector.h>
+#include <Utility/Zip.h>
+
+#include <benchmark/benchmark.h>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		// Exposes the individual steps of CEncryption::DecryptFromContext
+		class CStagedEncryption : public CEncryption
+		{
+		public:
+			using CEncryption::CreateSignatureHash;
+			using CEncryption::DecryptWithAES256;
+		};
+
+		// Every intermediate representation of a single item along the decode path
+		struct SDecodeStages
+		{
+			explicit SDecodeStages(size_t noteSize)
+				: vault({ 1, noteSize, ESizeDistribution::Fixed })
+			{
+				const SRawTransactionBackupEdit& transaction = vault.GetTransactions().front();
+				content = transaction.content;
+				decoded = base64pp::decode(content).value();
+				CSerializer::DoDeserialize(decoded, encryptedData);
+				hash = encryptedData.cipherData.hash;
+
+				CEncryption encryption;
+				SEncryptedData copy;
+				CSerializer::DoDeserialize(decoded, copy);
+				encryption.SetContextFromEncryptedData(vault.GetContext().secrets.localKey, decoded, copy);
+				encryption.DecryptFromContext();
+				decrypted.assign(encryption.GetOutput().begin(), encryption.GetOutput().end());
+
+				xml = Utility::InflateRaw(Utility::SliceVectorBySpan(decrypted, 6));
+				json = Utility::XmlToJsonTransaction(xml);
+			}
+
+			CSyntheticVault vault;
+			std::string content;
+			std::vector<uint8_t> decoded;
+			SEncryptedData encryptedData;
+			std::pmr::vector<uint8_t> hash;
+			std::vector<uint8_t> decrypted;
+			std::vector<uint8_t> xml;
+			nlohmann::ordered_json json;
+		};
+
+		const SDecodeStages& GetDecodeStages(size_t noteSize)
+		{
+			static std::map<size_t, std::unique_ptr<SDecodeStages>> s_stages;
+
+			auto& pStages = s_stages[noteSize];
+			if (!pStages)
+				pStages = std::make_unique<SDecodeStages>(noteSize);
+
+			return *pStages;
+		}
+
+		CSyntheticVault& GetVault(size_t itemCount, EEnvelopeDerivation derivation)
+		{
+			static std::map<std::pair<size_t, EEnvelopeDerivation>, std::unique_ptr<CSyntheticVault>> s_vaults;
+
+			auto& pVault = s_vaults[{ itemCount, derivation }];
+			if (!pVault)
+				pVault = std::make_unique<CSyntheticVault>(SSyntheticVaultConfig{ itemCount, 256, ESizeDistribution::Exponential, derivation });
+
+			return *pVault;
+		}
+
+		// Local vault database holding the synthetic items, recreated for every vault size
+		CDatabase& GetDatabase(CSyntheticVault& vault)
+		{
+			static std::map<const CSyntheticVault*, std::unique_ptr<CDatabase>> s_databases;
+
+			auto& pDatabase = s_databases[&vault];
+			if (!pDatabase)
+			{
+				const std::filesystem::path path = std::filesystem::temp_directory_path() / std::format("dashlane-bench-{}.db", vault.GetTransactions().size());
+				std::filesystem::remove(path);
+
+				pDatabase = std::make_unique<CDatabase>(path);
+				pDatabase->Connect();
+				pDatabase->Prepare();
+
+				std::vector<STransactionRow> rows;
+				for (const SRawTransactionBackupEdit& transaction : vault.GetTransactions())
+					rows.emplace_back(vault.GetContext().login, transaction.identifier, transaction.type, transaction.GetActionName(), transaction.content, transaction.backupDate);
+
+				pDatabase->AddMultipleTransactionData(rows);
+			}
+
+			return *pDatabase;
+		}
+
+		void SetItemCounters(benchmark::State& state, size_t items, size_t bytes)
+		{
+			state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * items));
+			state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+		}
+
+		// Single item stages, the argument is the note size in characters
+
+		// The second argument selects the codec: 0 for base64pp, then the Utility::EBase64Kernel value plus one.
+		// Every kernel is checked against base64pp before being measured
+		bool SelectBase64Kernel(benchmark::State& state, Utility::EBase64Kernel& kernel)
+		{
+			kernel = static_cast<Utility::EBase64Kernel>(state.range(1) - 1);
+
+			const Utility::SCpuFeatures& features = Utility::GetCpuFeatures();
+			if ((kernel == Utility::EBase64Kernel::SSE41 && !features.sse41) || (kernel == Utility::EBase64Kernel::AVX2 && !features.avx2))
+			{
+				state.SkipWithError("Kernel not supported by this CPU");
+				return false;
+			}
+
+			return true;
+		}
+
+		void BM_Base64Decode(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			if (state.range(1) == 0)
+			{
+				for (auto _ : state)
+					benchmark::DoNotOptimize(base64pp::decode(stages.content));
+			}
+			else
+			{
+				Utility::EBase64Kernel kernel;
+				if (!SelectBase64Kernel(state, kernel))
+					return;
+
+				std::vector<uint8_t> decoded(Utility::GetBase64DecodedMaxSize(stages.content.size()));
+				size_t written = 0;
+				if (!Utility::DecodeBase64(stages.content, decoded.data(), written, kernel)
+					|| !std::equal(decoded.begin(), decoded.begin() + written, stages.decoded.begin(), stages.decoded.end()))
+				{
+					state.SkipWithError("Decoded content differs from base64pp");
+					return;
+				}
+
+				for (auto _ : state)
+				{
+					Utility::DecodeBase64(stages.content, decoded.data(), written, kernel);
+					benchmark::DoNotOptimize(decoded.data());
+				}
+			}
+
+			SetItemCounters(state, 1, stages.content.size());
+		}
+
+		void BM_Base64Encode(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			if (state.range(1) == 0)
+			{
+				for (auto _ : state)
+					benchmark::DoNotOptimize(base64pp::encode(stages.decoded));
+			}
+			else
+			{
+				Utility::EBase64Kernel kernel;
+				if (!SelectBase64Kernel(state, kernel))
+					return;
+
+				std::string encoded(Utility::GetBase64EncodedSize(stages.decoded.size()), '\0');
+				Utility::EncodeBase64(stages.decoded, encoded.data(), kernel);
+				if (encoded != base64pp::encode(stages.decoded))
+				{
+					state.SkipWithError("Encoded content differs from base64pp");
+					return;
+				}
+
+				for (auto _ : state)
+				{
+					Utility::EncodeBase64(stages.decoded, encoded.data(), kernel);
+					benchmark::DoNotOptimize(encoded.data());
+				}
+			}
+
+			SetItemCounters(state, 1, stages.decoded.size());
+		}
+
+		// The second argument selects the parser: 0 for CSerializer, 1 for the envelope codec, 2 for the codec views
+		void BM_Deserialize(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			switch (state.range(1))
+			{
+			case 0:
+				for (auto _ : state)
+				{
+					SEncryptedData encryptedData;
+					CSerializer::DoDeserialize(stages.decoded, encryptedData);
+					benchmark::DoNotOptimize(encryptedData);
+				}
+				break;
+			case 1:
+				for (auto _ : state)
+				{
+					SEncryptedData encryptedData;
+					ReadEnvelope(stages.decoded, encryptedData);
+					benchmark::DoNotOptimize(encryptedData);
+				}
+				break;
+			default:
+				for (auto _ : state)
+				{
+					SEncryptedDataView encryptedData;
+					ReadEnvelope(stages.decoded, encryptedData);
+					benchmark::DoNotOptimize(encryptedData);
+				}
+				break;
+			}
+
+			SetItemCounters(state, 1, stages.decoded.size());
+		}
+
+		// The second argument selects the writer: 0 for CSerializer, 1 for the envelope codec
+		void BM_Serialize(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+			const bool useCodec = state.range(1) != 0;
+
+			std::vector<uint8_t> serialized;
+			for (auto _ : state)
+			{
+				serialized.clear();
+
+				if (useCodec)
+					WriteEnvelope(stages.encryptedData, serialized);
+				else
+					CSerializer::DoSerialize(serialized, stages.encryptedData);
+
+				benchmark::DoNotOptimize(serialized.data());
+			}
+
+			SetItemCounters(state, 1, stages.decoded.size());
+		}
+
+		void BM_HmacVerify(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			SEncryptedData encryptedData;
+			CSerializer::DoDeserialize(stages.decoded, encryptedData);
+
+			CStagedEncryption encryption;
+			encryption.SetContextFromEncryptedData(stages.vault.GetContext().secrets.localKey, stages.decoded, encryptedData);
+
+			for (auto _ : state)
+			{
+				const bool isValid = encryption.CreateSignatureHash() == stages.hash;
+				benchmark::DoNotOptimize(isValid);
+			}
+
+			SetItemCounters(state, 1, stages.encryptedData.cipherData.encryptedPayload.size());
+		}
+
+		void BM_AesDecrypt(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			SEncryptedData encryptedData;
+			CSerializer::DoDeserialize(stages.decoded, encryptedData);
+
+			CStagedEncryption encryption;
+			encryption.SetContextFromEncryptedData(stages.vault.GetContext().secrets.localKey, stages.decoded, encryptedData);
+
+			for (auto _ : state)
+			{
+				encryption.DecryptWithAES256();
+				benchmark::DoNotOptimize(encryption.GetOutput().data());
+			}
+
+			SetItemCounters(state, 1, stages.encryptedData.cipherData.encryptedPayload.size());
+		}
+
+		void BM_Inflate(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+			const auto compressed = Utility::SliceVectorBySpan(stages.decrypted, 6);
+
+			for (auto _ : state)
+				benchmark::DoNotOptimize(Utility::InflateRaw(compressed));
+
+			SetItemCounters(state, 1, stages.xml.size());
+		}
+
+		void BM_XmlToJson(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			for (auto _ : state)
+				benchmark::DoNotOptimize(Utility::XmlToJsonTransaction(stages.xml));
+
+			SetItemCounters(state, 1, stages.xml.size());
+		}
+
+		void BM_FilterMatch(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			// Key filter and an any-field filter that does not match, the worst case scans every field
+			DashlaneQueryContextInternal query;
+			query.filters["Url"] = "does-not-exist";
+			query.filters["nothing-matches"] = "";
+
+			for (auto _ : state)
+				benchmark::DoNotOptimize(MatchesQueryFilters(query, stages.json));
+
+			SetItemCounters(state, 1, 0);
+		}
+
+		void BM_JsonDump(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+
+			for (auto _ : state)
+				benchmark::DoNotOptimize(stages.json.dump());
+
+			SetItemCounters(state, 1, 0);
+		}
+
+		// Result of a matching item from its XML: 0 builds and dumps the JSON, 1 fills the typed view
+		void BM_QueryResult(benchmark::State& state)
+		{
+			const SDecodeStages& stages = GetDecodeStages(state.range(0));
+			const bool typed = state.range(1) == 1;
+
+			Utility::CTransientArena arena;
+
+			for (auto _ : state)
+			{
+				arena.Rewind();
+
+				std::pmr::vector<uint8_t> xml(stages.xml.begin(), stages.xml.end(), &arena);
+				Utility::TransactionFields fields(&arena);
+				const ETransactionType type = Utility::XmlToTransactionFields(xml, fields);
+
+				if (typed)
+				{
+					DashlaneAuthentifiantView authentifiant;
+					DashlaneSecureNoteView secureNote;
+					DashlaneTransactionView view;
+					FillTransactionView(type, fields, authentifiant, secureNote, view);
+					benchmark::DoNotOptimize(view);
+				}
+				else
+				{
+					std::pmr::string dump(&arena);
+					Utility::DumpJsonTransaction(Utility::TransactionFieldsToJson(type, fields, &arena), dump);
+					benchmark::DoNotOptimize(dump.data());
+				}
+			}
+
+			SetItemCounters(state, 1, stages.xml.size());
+		}
+
+		// Key derivation of a master password envelope, paid once per vault thanks to the key registry
+		void BM_KeyDerivation(benchmark::State& state)
+		{
+			const auto derivation = static_cast<EEnvelopeDerivation>(state.range(0));
+
+			CSyntheticVault& vault = GetVault(1, derivation);
+			const std::vector<uint8_t> decoded = base64pp::decode(vault.GetTransactions().front().content).value();
+
+			SEncryptedData encryptedData;
+			CSerializer::DoDeserialize(decoded, encryptedData);
+
+			CEncryption encryption;
+			Utility::SecureBuffer symmetricKey;
+			for (auto _ : state)
+			{
+				encryption.GetSymmetricKeyViaDerivate(encryptedData.GetKeyDerivation(), encryptedData.cipherData.salt, vault.GetContext().secrets.masterPassword, symmetricKey);
+				benchmark::DoNotOptimize(symmetricKey.data());
+			}
+
+			SetItemCounters(state, 1, 0);
+		}
+
+		// Whole vault stages, the arguments are the item count and the envelope derivation
+
+		void BM_SqliteFetch(benchmark::State& state)
+		{
+			CSyntheticVault& vault = GetVault(state.range(0), EEnvelopeDerivation::None);
+			CDatabase& database = GetDatabase(vault);
+
+			for (auto _ : state)
+			{
+				std::vector<SRawTransactionBackupEdit> transactions;
+				database.GetTransactions(vault.GetContext(), ERawTransactionType::Authentifiant, transactions);
+				benchmark::DoNotOptimize(transactions.data());
+			}
+
+			SetItemCounters(state, vault.GetTransactions().size(), 0);
+		}
+
+		// The third argument selects the transient allocations: 0 for the default heap, 1 for the query arena
+		void BM_ProcessTransactions(benchmark::State& state)
+		{
+			CSyntheticVault& vault = GetVault(state.range(0), static_cast<EEnvelopeDerivation>(state.range(1)));
+			const bool useArena = state.range(2) != 0;
+
+			// Warm the key registry, derivation is measured by BM_KeyDerivation
+			nlohmann::ordered_json json;
+			ProcessTransaction(vault.GetContext(), vault.GetTransactions().front(), json);
+
+			Utility::CTransientArena arena;
+			std::pmr::memory_resource* pResource = useArena ? &arena : std::pmr::get_default_resource();
+
+			for (auto _ : state)
+			{
+				for (const SRawTransactionBackupEdit& transaction : vault.GetTransactions())
+				{
+					arena.Rewind();
+
+					if (ProcessTransaction(vault.GetContext(), transaction, json, pResource) != EDashlaneError::NoError)
+					{
+						state.SkipWithError("Failed to decode synthetic item");
+						return;
+					}
+
+					benchmark::DoNotOptimize(json);
+				}
+			}
+
+			SetItemCounters(state, vault.GetTransactions().size(), 0);
+		}
+
+		// Verify and decrypt every item of the vault. The second argument selects the path: 0 for one CEncryption per
+		// item, 1 for a batch through the OpenSSL backend, 2 for a batch through the AES-NI backend, 3 for a batch through
+		// the multi-buffer backend (AES-NI and AVX2 HMAC lanes)
+		void BM_BatchDecrypt(benchmark::State& state)
+		{
+			CSyntheticVault& vault = GetVault(state.range(0), EEnvelopeDerivation::None);
+			const std::span<const uint8_t> localKey = vault.GetContext().secrets.localKey;
+
+			std::vector<std::vector<uint8_t>> decoded;
+			std::vector<SEncryptedDataView> envelopes(vault.GetTransactions().size());
+			decoded.reserve(envelopes.size());
+			for (size_t i = 0; i < envelopes.size(); ++i)
+			{
+				Utility::DecodeBase64(vault.GetTransactions()[i].content, decoded.emplace_back());
+				ReadEnvelope(decoded.back(), envelopes[i]);
+			}
+
+			std::vector<std::pmr::vector<uint8_t>> outputs(envelopes.size());
+
+			if (state.range(1) == 0)
+			{
+				for (auto _ : state)
+				{
+					for (const SEncryptedDataView& envelope : envelopes)
+					{
+						CEncryption encryption;
+						benchmark::DoNotOptimize(encryption.DecryptFromView(localKey, envelope));
+					}
+				}
+			}
+			else
+			{
+				static constexpr ECryptoBackend s_backends[] = { ECryptoBackend::Auto, ECryptoBackend::OpenSSL, ECryptoBackend::AesNi, ECryptoBackend::MultiBuffer };
+				const ECryptoBackend backendType = s_backends[state.range(1)];
+
+				CBatchDecryption batch(backendType);
+				if (batch.GetBackendType() != backendType)
+				{
+					state.SkipWithError("Backend not supported by this CPU");
+					return;
+				}
+
+				for (auto _ : state)
+				{
+					batch.Clear();
+					for (size_t i = 0; i < envelopes.size(); ++i)
+						batch.Add(localKey, envelopes[i], outputs[i]);
+
+					batch.Run();
+					benchmark::DoNotOptimize(outputs.data());
+				}
+
+				if (!batch.Succeeded(0))
+				{
+					state.SkipWithError("Failed to decrypt synthetic item");
+					return;
+				}
+			}
+
+			SetItemCounters(state, envelopes.size(), 0);
+		}
+
+		// Query path of Dash_QueryTransactions (without sync/secrets): fetch, decode, filter and write every item
+		void BM_QueryEndToEnd(benchmark::State& state)
+		{
+			CSyntheticVault& vault = GetVault(state.range(0), EEnvelopeDerivation::None);
+			CDatabase& database = GetDatabase(vault);
+
+			DashlaneQueryContextInternal query;
+			query.filters["Url"] = "service1";
+
+			for (auto _ : state)
+			{
+				std::vector<SRawTransactionBackupEdit> transactions;
+				database.GetTransactions(vault.GetContext(), ERawTransactionType::Authentifiant, transactions);
+
+				Utility::CTransientArena arena;
+
+				size_t written = 0;
+				for (const SRawTransactionBackupEdit& transaction : transactions)
+				{
+					arena.Rewind();
+
+					nlohmann::ordered_json json;
+					ProcessTransaction(vault.GetContext(), transaction, json, &arena);
+
+					if (MatchesQueryFilters(query, json))
+					{
+						std::pmr::string dump(&arena);
+						Utility::DumpJsonTransaction(json, dump);
+						written += dump.size();
+					}
+				}
+
+				benchmark::DoNotOptimize(written);
+			}
+
+			SetItemCounters(state, vault.GetTransactions().size(), 0);
+		}
+
+	}
+
+	BENCHMARK(BM_Base64Decode)
+		->ArgsProduct({ { 0, 256, 4096, 65536 }, { 0, 1, 2, 3 } })
+		->ArgNames({ "noteSize", "codec" });
+	BENCHMARK(BM_Base64Encode)
+		->ArgsProduct({ { 0, 256, 4096, 65536 }, { 0, 1, 2, 3 } })
+		->ArgNames({ "noteSize", "codec" });
+	BENCHMARK(BM_Deserialize)
+		->ArgsProduct({ { 0, 256, 4096, 65536 }, { 0, 1, 2 } })
+		->ArgNames({ "noteSize", "codec" });
+	BENCHMARK(BM_Serialize)
+		->ArgsProduct({ { 0, 256, 4096, 65536 }, { 0, 1 } })
+		->ArgNames({ "noteSize", "codec" });
+	BENCHMARK(BM_HmacVerify)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536);
+	BENCHMARK(BM_AesDecrypt)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536);
+	BENCHMARK(BM_Inflate)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536);
+	BENCHMARK(BM_XmlToJson)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536);
+	BENCHMARK(BM_FilterMatch)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536);
+	BENCHMARK(BM_JsonDump)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536);
+	BENCHMARK(BM_QueryResult)
+		->ArgsProduct({ { 0, 256, 4096, 65536 }, { 0, 1 } })
+		->ArgNames({ "noteSize", "typed" });
+
+	BENCHMARK(BM_KeyDerivation)
+		->Arg((int64_t)EEnvelopeDerivation::Argon2)
+		->Arg((int64_t)EEnvelopeDerivation::Pbkdf2)
+		->Unit(benchmark::kMillisecond);
+
+	BENCHMARK(BM_SqliteFetch)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+	BENCHMARK(BM_ProcessTransactions)
+		->ArgsProduct({ { 100, 1000 }, { (int64_t)EEnvelopeDerivation::None, (int64_t)EEnvelopeDerivation::Argon2, (int64_t)EEnvelopeDerivation::Pbkdf2 }, { 0, 1 } })
+		->ArgNames({ "items", "derivation", "arena" })
+		->Unit(benchmark::kMicrosecond);
+
+	BENCHMARK(BM_BatchDecrypt)
+		->ArgsProduct({ { 100, 1000 }, { 0, 1, 2, 3 } })
+		->ArgNames({ "items", "backend" })
+		->Unit(benchmark::kMicrosecond);
+
+	BENCHMARK(BM_QueryEndToEnd)->Arg(100)->Arg(1000)->Arg(10000)->ArgName("items")->Unit(benchmark::kMillisecond);
+
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "StdAfx.h"
+#include "Benchmarks.h"
+#include "RegisteredDevice.h"
+
+#include <Encryption.h>
+
+#include <benchmark/benchmark.h>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		static constexpr char APPLICATION_NAME[] = "dashlane-bench";
+
+		// What a CLI invocation such as `dcli password <filter>` does between main() and its first output: create a
+		// context, open the local vault, unlock it and read the first item, then free everything. Everything runs
+		// in-process, so process creation and loading the library are not measured. The process-wide key registry is
+		// cleared before each iteration, so the first item gets its key from the stored derived keys as in a new
+		// process. The argument is the item count
+		void BM_ColdStartFirstResult(benchmark::State& state)
+		{
+			CMockServer& server = GetMockServer(state.range(0), 0);
+			const std::filesystem::path dataFolder = std::filesystem::temp_directory_path() / "dashlane-bench-startup";
+			const CMockServerEnvironment environment(server, dataFolder);
+
+			if (!PrepareRegisteredDevice(server, dataFolder, APPLICATION_NAME))
+			{
+				state.SkipWithError("Failed to prepare the local vault");
+				return;
+			}
+
+			const std::string login = server.GetVault().GetContext().login;
+
+			for (auto _ : state)
+			{
+				state.PauseTiming();
+				CEncryption::ClearKeyRegistry();
+				state.ResumeTiming();
+
+				DashlaneContext* pContext = nullptr;
+				DashlaneQueryContext* pQueryContext = nullptr;
+				DashlaneQueryCursor* pCursor = nullptr;
+				bool hasResult = false;
+
+				auto rc = static_cast<EDashlaneError>(Dash_InitContextWithSecretStore(&pContext, APPLICATION_NAME, login.c_str(), MOCK_APP_KEY, MOCK_APP_KEY, ESecretStore::Memory));
+				if (rc == EDashlaneError::NoError)
+					rc = static_cast<EDashlaneError>(Dash_AssignMasterPassword(pContext, CSyntheticVault::masterPassword));
+				if (rc == EDashlaneError::NoError)
+					rc = static_cast<EDashlaneError>(Dash_InitQueryContext(&pQueryContext));
+				if (rc == EDashlaneError::NoError)
+					rc = static_cast<EDashlaneError>(Dash_SetQueryWriter(pQueryContext, [](void*, const char* json, uint32_t) { benchmark::DoNotOptimize(json); }));
+				if (rc == EDashlaneError::NoError)
+					rc = static_cast<EDashlaneError>(Dash_QueryOpen(pContext, pQueryContext, &pCursor));
+				if (rc == EDashlaneError::NoError)
+					rc = static_cast<EDashlaneError>(Dash_QueryNext(pCursor, &hasResult));
+
+				if (pCursor != nullptr)
+					Dash_QueryClose(pCursor);
+				Dash_FreeQueryContext(pQueryContext);
+				Dash_FreeContext(pContext);
+
+				if (rc != EDashlaneError::NoError || !hasResult)
+				{
+					state.SkipWithError("Failed to read the first item of the local vault");
+					return;
+				}
+			}
+		}
+
+	}
+
+	BENCHMARK(BM_ColdStartFirstResult)
+		->Arg(1000)
+		->Arg(10000)
+		->ArgName("items")
+		->Unit(benchmark::kMillisecond)
+		->UseRealTime();
+
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "StdAfx.h"
+#include "Benchmarks.h"
+#include "RegisteredDevice.h"
+
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+namespace Dashlane
+{
+
+	CMockServer& GetMockServer(size_t itemCount, uint32_t latencyMs)
+	{
+		static std::map<std::pair<size_t, uint32_t>, std::unique_ptr<CMockServer>> s_servers;
+
+		auto& pServer = s_servers[{ itemCount, latencyMs }];
+		if (!pServer)
+		{
+			SMockServerConfig config;
+			config.vault = { itemCount, 256, ESizeDistribution::Exponential, EEnvelopeDerivation::Argon2 };
+			config.latencyMs = latencyMs;
+
+			pServer = std::make_unique<CMockServer>(config);
+			if (!pServer->Start())
+				throw std::runtime_error("Failed to start the mock server");
+		}
+
+		return *pServer;
+	}
+
+	namespace
+	{
+
+		static constexpr char APPLICATION_NAME[] = "dashlane-bench";
+
+		// Full synchronization of an empty local vault: request, transfer, parse, recrypt and store every item.
+		// The arguments are the item count, the latency added by the server to every response and whether items are
+		// stored as server envelopes (lazy recrypt) instead of being recrypted
+		void BM_SyncFromMockServer(benchmark::State& state)
+		{
+			CMockServer& server = GetMockServer(state.range(0), static_cast<uint32_t>(state.range(1)));
+			const bool lazyRecrypt = state.range(2) != 0;
+			const std::filesystem::path databasePath = std::filesystem::temp_directory_path() / "dashlane-bench-sync.db";
+
+			// Warm the key registry, derivation is measured by BM_KeyDerivation
+			{
+				auto pContext = MakeRegisteredContext(server, databasePath, APPLICATION_NAME);
+				pContext->syncPolicy.lazyRecrypt = lazyRecrypt;
+				if (SynchronizeVaultData(*pContext) != EDashlaneError::NoError)
+				{
+					state.SkipWithError("Failed to synchronize with the mock server");
+					return;
+				}
+			}
+
+			for (auto _ : state)
+			{
+				state.PauseTiming();
+				auto pContext = MakeRegisteredContext(server, databasePath, APPLICATION_NAME);
+				pContext->syncPolicy.lazyRecrypt = lazyRecrypt;
+				state.ResumeTiming();
+
+				if (SynchronizeVaultData(*pContext) != EDashlaneError::NoError)
+				{
+					state.SkipWithError("Failed to synchronize with the mock server");
+					return;
+				}
+			}
+
+			state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * server.GetVault().GetTransactions().size()));
+		}
+
+		// Incremental synchronization with nothing to apply, dominated by the request round-trip
+		void BM_SyncUpToDate(benchmark::State& state)
+		{
+			CMockServer& server = GetMockServer(state.range(0), static_cast<uint32_t>(state.range(1)));
+			const std::filesystem::path databasePath = std::filesystem::temp_directory_path() / "dashlane-bench-sync.db";
+
+			auto pContext = MakeRegisteredContext(server, databasePath, APPLICATION_NAME);
+			if (SynchronizeVaultData(*pContext) != EDashlaneError::NoError)
+			{
+				state.SkipWithError("Failed to synchronize with the mock server");
+				return;
+			}
+
+			for (auto _ : state)
+			{
+				if (SynchronizeVaultData(*pContext) != EDashlaneError::NoError)
+				{
+					state.SkipWithError("Failed to synchronize with the mock server");
+					return;
+				}
+			}
+		}
+
+		// Lookups by identifier from several threads while another thread keeps storing a full synchronization delta in
+		// the same vault file. Lookups borrow read-only connections from the pool and should not wait for the writer.
+		// The arguments are the item count and whether the synchronization runs during the lookups
+		void BM_LookupDuringSync(benchmark::State& state)
+		{
+			struct SSharedState
+			{
+				std::unique_ptr<DashlaneContextInternal> pContext;
+				std::vector<std::string> identifiers;
+				std::vector<STransactionRow> rows;
+				std::atomic<bool> stop{ false };
+				std::atomic<uint64_t> syncCount{ 0 };
+				std::thread writer;
+			};
+
+			// Set up by the first thread, the others only read it once the measured loop starts
+			static std::unique_ptr<SSharedState> s_pState;
+
+			if (state.thread_index() == 0)
+			{
+				CMockServer& server = GetMockServer(state.range(0), 0);
+				const std::filesystem::path databasePath = std::filesystem::temp_directory_path() / "dashlane-bench-lookup.db";
+
+				s_pState = std::make_unique<SSharedState>();
+				s_pState->pContext = MakeRegisteredContext(server, databasePath, APPLICATION_NAME);
+				if (SynchronizeVaultData(*s_pState->pContext) != EDashlaneError::NoError)
+				{
+					// Still entering the loop below, every thread waits for the others to start it
+					s_pState.reset();
+					state.SkipWithError("Failed to synchronize with the mock server");
+				}
+			}
+
+			if (state.thread_index() == 0 && s_pState)
+			{
+				DashlaneContextInternal& context = *s_pState->pContext;
+				std::vector<SRawTransactionBackupEdit> transactions;
+				context.pDatabase->GetTransactions(context, bitmask<ERawTransactionType>::none(), transactions);
+				for (const SRawTransactionBackupEdit& transaction : transactions)
+				{
+					s_pState->identifiers.emplace_back(transaction.identifier);
+					s_pState->rows.emplace_back(context.login, transaction.identifier, transaction.type, transaction.GetActionName(),
+						transaction.content, transaction.backupDate);
+				}
+
+				// Same storage stage as a synchronization, a single database transaction rewriting every item
+				if (state.range(1) != 0)
+				{
+					s_pState->writer = std::thread([pState = s_pState.get()]()
+					{
+						while (!pState->stop)
+						{
+							pState->pContext->pDatabase->ApplyTransactionChanges(*pState->pContext, pState->rows, {}, 0);
+							++pState->syncCount;
+						}
+					});
+				}
+			}
+
+			size_t position = static_cast<size_t>(state.thread_index()) * 7919;
+			for (auto _ : state)
+			{
+				if (!s_pState)
+					break;
+
+				DashlaneContextInternal& context = *s_pState->pContext;
+				SRawTransactionBackupEdit transaction;
+				const EDashlaneError rc = context.pDatabase->GetTransaction(context,
+					s_pState->identifiers[position++ % s_pState->identifiers.size()], transaction);
+
+				if (rc != EDashlaneError::NoError)
+				{
+					state.SkipWithError("Failed to look up a stored item");
+					break;
+				}
+
+				benchmark::DoNotOptimize(transaction.content.data());
+			}
+
+			state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+
+			if (state.thread_index() == 0 && s_pState)
+			{
+				s_pState->stop = true;
+				if (s_pState->writer.joinable())
+					s_pState->writer.join();
+
+				state.counters["syncs"] = static_cast<double>(s_pState->syncCount);
+				s_pState.reset();
+			}
+		}
+
+	}
+
+	BENCHMARK(BM_SyncFromMockServer)
+		->ArgsProduct({ { 100, 1000, 10000 }, { 0, 50 }, { 0, 1 } })
+		->ArgNames({ "items", "latencyMs", "lazy" })
+		->Unit(benchmark::kMillisecond)
+		->UseRealTime();
+
+	BENCHMARK(BM_SyncUpToDate)
+		->ArgsProduct({ { 1000 }, { 0, 50 } })
+		->ArgNames({ "items", "latencyMs" })
+		->Unit(benchmark::kMillisecond)
+		->UseRealTime();
+
+	BENCHMARK(BM_LookupDuringSync)
+		->ArgsProduct({ { 1000 }, { 0, 1 } })
+		->ArgNames({ "items", "sync" })
+		->ThreadRange(1, 8)
+		->Unit(benchmark::kMicrosecond)
+		->UseRealTime();
+
+}
\ No newline at end of file
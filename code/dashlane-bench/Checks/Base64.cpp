@@ -0,0 +1,158 @@
+#include "StdAfx.h"
+#include "Checks.h"
+
+#include <Utility/Base64.h>
+
+#include <random>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		// Crosses every kernel threshold (16 and 28 input bytes to encode, 24 and 44 characters to decode) several times
+		static constexpr size_t MAX_INPUT_SIZE = 300;
+
+		static constexpr Utility::EBase64Kernel KERNELS[] = { Utility::EBase64Kernel::Scalar, Utility::EBase64Kernel::SSE41, Utility::EBase64Kernel::AVX2 };
+
+		std::string_view GetKernelName(Utility::EBase64Kernel kernel)
+		{
+			switch (kernel)
+			{
+			case Utility::EBase64Kernel::SSE41:
+				return "SSE4.1";
+			case Utility::EBase64Kernel::AVX2:
+				return "AVX2";
+			default:
+				return "scalar";
+			}
+		}
+
+		bool IsSupported(Utility::EBase64Kernel kernel)
+		{
+			const Utility::SCpuFeatures& features = Utility::GetCpuFeatures();
+			return (kernel != Utility::EBase64Kernel::SSE41 || features.sse41) && (kernel != Utility::EBase64Kernel::AVX2 || features.avx2);
+		}
+
+		// Same outcome as base64pp: both reject the input, or both accept it and decode the same bytes
+		bool DecodesAsBase64pp(std::string_view input, Utility::EBase64Kernel kernel)
+		{
+			const std::optional<std::vector<uint8_t>> expected = base64pp::decode(input);
+
+			std::vector<uint8_t> decoded(Utility::GetBase64DecodedMaxSize(input.size()));
+			size_t written = 0;
+			const bool success = Utility::DecodeBase64(input, decoded.data(), written, kernel);
+
+			if (!expected.has_value())
+				return !success;
+
+			return success && std::equal(decoded.begin(), decoded.begin() + written, expected->begin(), expected->end());
+		}
+
+		// Printable form of an input for a failure message
+		std::string Quote(std::string_view input)
+		{
+			std::string quoted = "\"";
+			for (const char c : input)
+			{
+				if (c >= 0x20 && c < 0x7F)
+					quoted.push_back(c);
+				else
+					quoted += std::format("\\x{:02x}", static_cast<uint8_t>(c));
+			}
+
+			return quoted + "\"";
+		}
+
+	}
+
+	// Every base64 kernel supported by the CPU encodes and decodes as base64pp, for every input size up to a few hundred
+	// bytes. Invalid characters at any position, bad padding and lengths which are not a multiple of 4 fail or succeed
+	// as they do with base64pp
+	bool CheckBase64Kernels(std::string& failure)
+	{
+		std::mt19937 generator(39);
+
+		std::vector<std::string> encodings;
+		for (size_t size = 0; size <= MAX_INPUT_SIZE; ++size)
+		{
+			std::vector<uint8_t> input(size);
+			for (uint8_t& byte : input)
+				byte = static_cast<uint8_t>(generator());
+
+			encodings.push_back(base64pp::encode(input));
+
+			for (const Utility::EBase64Kernel kernel : KERNELS)
+			{
+				if (!IsSupported(kernel))
+					continue;
+
+				std::string encoded(Utility::GetBase64EncodedSize(size), '\0');
+				Utility::EncodeBase64(input, encoded.data(), kernel);
+				if (encoded != encodings.back())
+				{
+					failure = std::format("The {} kernel encodes {} bytes differently", GetKernelName(kernel), size);
+					return false;
+				}
+			}
+		}
+
+		const auto decodesAsBase64pp = [&](std::string_view input)
+		{
+			for (const Utility::EBase64Kernel kernel : KERNELS)
+			{
+				if (IsSupported(kernel) && !DecodesAsBase64pp(input, kernel))
+				{
+					failure = std::format("The {} kernel does not decode {} as base64pp", GetKernelName(kernel), Quote(input));
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		// Padding, in place of and around complete groups
+		static constexpr std::string_view PADDINGS[] = { "=", "==", "===", "====", "A===", "AB=C", "A=BC", "=ABC", "AB==CD==", "ABC=ABC=", "QQ==QUJD", "QQ=", "QUI", "QUJDR", "QR==", "QUK=" };
+		for (const std::string_view input : PADDINGS)
+		{
+			if (!decodesAsBase64pp(input))
+				return false;
+		}
+
+		for (const std::string& encoding : encodings)
+		{
+			if (!decodesAsBase64pp(encoding))
+				return false;
+
+			// Truncated and extended, so that the length is not a multiple of 4
+			for (size_t count = 1; count < 4; ++count)
+			{
+				if ((count <= encoding.size() && !decodesAsBase64pp(std::string_view(encoding).substr(0, encoding.size() - count)))
+					|| !decodesAsBase64pp(encoding + std::string(count, 'A')))
+				{
+					return false;
+				}
+			}
+
+			// Characters outside of the alphabet at every position, padding characters included, so that each SIMD
+			// block is rejected or handed over to the scalar code
+			static constexpr char INVALID_CHARACTERS[] = { '=', '-', '_', '\0', '\x80' };
+			std::string corrupted = encoding;
+			for (size_t position = 0; position < encoding.size(); ++position)
+			{
+				for (const char c : INVALID_CHARACTERS)
+				{
+					corrupted[position] = c;
+					if (!decodesAsBase64pp(corrupted))
+						return false;
+				}
+
+				corrupted[position] = encoding[position];
+			}
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
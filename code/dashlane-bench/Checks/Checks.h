@@ -0,0 +1,29 @@
+#pragma once
+
+#include "RegisteredDevice.h"
+
+namespace Dashlane
+{
+
+	// Scenarios run by dashlane-check against the in-process mock server. A check returns false and describes the
+	// expectation that was not met in failure
+	using CheckFunc = bool(*)(std::string& failure);
+
+	// Network.cpp
+	bool CheckRetryOnServerErrors(std::string& failure);
+	bool CheckRetryBudget(std::string& failure);
+	bool CheckClockSkewRecovery(std::string& failure);
+
+	// Base64.cpp
+	bool CheckBase64Kernels(std::string& failure);
+
+	// Envelope.cpp
+	bool CheckEnvelopeCodec(std::string& failure);
+
+	// Concurrency.cpp
+	bool CheckLookupDuringSync(std::string& failure);
+
+	// Application name of the contexts created by the checks
+	static constexpr char APPLICATION_NAME[] = "dashlane-check";
+
+}
\ No newline at end of file
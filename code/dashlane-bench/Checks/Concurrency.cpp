@@ -0,0 +1,228 @@
+#include "StdAfx.h"
+#include "Checks.h"
+
+#include <condition_variable>
+#include <ranges>
+#include <set>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		// Item returned by a lookup, none when the identifier is not in the local vault
+		using LookupResult = std::optional<std::string>;
+
+		EDashlaneError LookUp(DashlaneContext* pContext, const std::string& identifier, LookupResult& result)
+		{
+			std::string json;
+			const auto rc = static_cast<EDashlaneError>(Dash_GetTransactionById(pContext, identifier.c_str(),
+				[](void* pUserPointer, const char* szJson, uint32_t size) { static_cast<std::string*>(pUserPointer)->assign(szJson, size); }, &json));
+
+			result.reset();
+			if (rc == EDashlaneError::NoError)
+				result = std::move(json);
+
+			return rc == EDashlaneError::TransactionNotFound ? EDashlaneError::NoError : rc;
+		}
+
+		EDashlaneError LookUpAll(DashlaneContext* pContext, const std::vector<std::string>& identifiers, std::vector<LookupResult>& results)
+		{
+			results.resize(identifiers.size());
+			for (size_t i = 0; i < identifiers.size(); ++i)
+			{
+				if (const EDashlaneError rc = LookUp(pContext, identifiers[i], results[i]); rc != EDashlaneError::NoError)
+					return rc;
+			}
+
+			return EDashlaneError::NoError;
+		}
+
+	}
+
+	// Lookups through the public API on several threads while another thread synchronizes the same context with
+	// changed, added and removed items. Every reader completes lookups while the synchronization is held by the server,
+	// and every lookup returns the item as it was before the synchronization or as it is after it
+	bool CheckLookupDuringSync(std::string& failure)
+	{
+		static constexpr uint32_t READER_COUNT = 4;
+		static constexpr SVaultChanges CHANGES{ 10, 5, 5 };
+
+		// Only bounds a deadlock, the outcome does not depend on timing
+		static constexpr auto DEADLOCK_TIMEOUT = std::chrono::seconds(60);
+
+		SMockServerConfig config;
+		config.vault = { 50, 64, ESizeDistribution::Fixed, EEnvelopeDerivation::Argon2 };
+
+		CMockServer server(config);
+		if (!server.Start())
+		{
+			failure = "Failed to start the mock server";
+			return false;
+		}
+
+		const std::filesystem::path dataFolder = std::filesystem::temp_directory_path() / "dashlane-check-lookup";
+		if (!PrepareRegisteredDevice(server, dataFolder, APPLICATION_NAME))
+		{
+			failure = "Failed to prepare the local vault";
+			return false;
+		}
+
+		const CMockServerEnvironment environment(server, dataFolder);
+
+		// Another device edits the vault, the identifiers looked up are the ones of the vault before and after the edit
+		if (!server.ApplyVaultChanges(CHANGES))
+		{
+			failure = "Failed to change the server vault";
+			return false;
+		}
+
+		std::vector<std::string> identifiers;
+		for (const SRawTransactionBackupEdit& transaction : server.GetVault().GetTransactions())
+			identifiers.push_back(transaction.identifier);
+		for (const SRawTransactionBackupRemove& removal : server.GetVault().GetRemovals())
+			identifiers.push_back(removal.identifier);
+
+		DashlaneContext* pContext = nullptr;
+		auto rc = static_cast<EDashlaneError>(Dash_InitContextWithSecretStore(&pContext, APPLICATION_NAME, server.GetVault().GetContext().login.c_str(), MOCK_APP_KEY, MOCK_APP_KEY, ESecretStore::Memory));
+		if (rc == EDashlaneError::NoError)
+			rc = static_cast<EDashlaneError>(Dash_AssignMasterPassword(pContext, CSyntheticVault::masterPassword));
+
+		std::vector<LookupResult> before;
+		if (rc == EDashlaneError::NoError)
+			rc = LookUpAll(pContext, identifiers, before);
+
+		if (rc != EDashlaneError::NoError)
+		{
+			failure = std::format("Failed to look up the local vault ({})", Dash_GetErrorMessage(static_cast<uint32_t>(rc)));
+			Dash_FreeContext(pContext);
+			return false;
+		}
+
+		// The synchronization sends its request, then waits for the response until the readers are done with the
+		// lookups expected to complete meanwhile
+		server.HoldResponses();
+
+		std::atomic<bool> isSyncDone{ false };
+		std::atomic<uint32_t> syncRc{ 0 };
+		std::thread syncThread([&]()
+		{
+			syncRc = Dash_SynchronizeVaultData(pContext);
+			isSyncDone = true;
+		});
+
+		const bool isSyncHeld = server.WaitForHeldResponse(DEADLOCK_TIMEOUT);
+
+		std::mutex resultMutex;
+		std::condition_variable heldPassesChanged;
+		uint32_t heldPassCount = 0;
+		std::string readerFailure;
+		std::set<std::pair<size_t, LookupResult>> observed;
+
+		std::vector<std::thread> readers;
+		for (uint32_t i = 0; i < READER_COUNT && isSyncHeld; ++i)
+		{
+			readers.emplace_back([&, i]()
+			{
+				std::set<std::pair<size_t, LookupResult>> results;
+				std::string error;
+
+				// The first pass over every item runs while the server holds the synchronization, the following ones
+				// until it is done
+				for (uint32_t pass = 0; error.empty() && (pass == 0 || !isSyncDone); ++pass)
+				{
+					for (size_t n = 0; n < identifiers.size() && error.empty(); ++n)
+					{
+						const size_t index = (i + n) % identifiers.size();
+
+						LookupResult result;
+						if (const EDashlaneError lookupRc = LookUp(pContext, identifiers[index], result); lookupRc != EDashlaneError::NoError)
+							error = std::format("Lookup of {} failed ({})", identifiers[index], Dash_GetErrorMessage(static_cast<uint32_t>(lookupRc)));
+						else if (pass == 0 && result != before[index])
+							error = std::format("Lookup of {} returned another item while the synchronization was held", identifiers[index]);
+						else if (result != before[index])
+							results.emplace(index, std::move(result));
+					}
+
+					if (pass == 0)
+					{
+						std::lock_guard<std::mutex> lock(resultMutex);
+						++heldPassCount;
+						heldPassesChanged.notify_all();
+					}
+				}
+
+				std::lock_guard<std::mutex> lock(resultMutex);
+				observed.merge(results);
+				if (readerFailure.empty())
+					readerFailure = error;
+			});
+		}
+
+		bool isEveryPassHeld = false;
+		{
+			std::unique_lock<std::mutex> lock(resultMutex);
+			isEveryPassHeld = isSyncHeld && heldPassesChanged.wait_for(lock, DEADLOCK_TIMEOUT, [&]() { return heldPassCount == READER_COUNT; });
+		}
+
+		server.ReleaseResponses();
+
+		syncThread.join();
+		for (std::thread& reader : readers)
+			reader.join();
+
+		std::vector<LookupResult> after;
+		if (static_cast<EDashlaneError>(syncRc.load()) == EDashlaneError::NoError)
+			rc = LookUpAll(pContext, identifiers, after);
+
+		Dash_FreeContext(pContext);
+		server.Stop();
+
+		if (!isSyncHeld)
+		{
+			failure = "The synchronization did not reach the server, the scenario does not overlap lookups with it";
+			return false;
+		}
+
+		if (!isEveryPassHeld)
+		{
+			failure = "Lookups waited for the synchronization held by the server";
+			return false;
+		}
+
+		if (!readerFailure.empty())
+		{
+			failure = readerFailure;
+			return false;
+		}
+
+		if (static_cast<EDashlaneError>(syncRc.load()) != EDashlaneError::NoError || rc != EDashlaneError::NoError)
+		{
+			failure = std::format("Synchronization failed ({})", Dash_GetErrorMessage(syncRc != 0 ? syncRc.load() : static_cast<uint32_t>(rc)));
+			return false;
+		}
+
+		// Changed items are read again, added ones appear and removed ones are gone
+		const size_t changedCount = std::ranges::count_if(std::views::iota(size_t(0), identifiers.size()), [&](size_t i) { return after[i] != before[i]; });
+		const size_t addedCount = std::ranges::count(before, LookupResult());
+		const size_t removedCount = std::ranges::count(after, LookupResult());
+		if (changedCount != CHANGES.changedCount + CHANGES.addedCount + CHANGES.removedCount || addedCount != CHANGES.addedCount || removedCount != CHANGES.removedCount)
+		{
+			failure = std::format("The synchronization applied {} changes, {} additions and {} removals", changedCount - addedCount - removedCount, addedCount, removedCount);
+			return false;
+		}
+
+		for (const auto& [index, result] : observed)
+		{
+			if (result != after[index])
+			{
+				failure = std::format("Lookup of {} returned neither the item before the synchronization nor the one after it", identifiers[index]);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "StdAfx.h"
+#include "Checks.h"
+
+#include <EnvelopeCodec.h>
+
+#include <random>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		static constexpr uint32_t ENVELOPES_PER_DERIVATION = 1000;
+		static constexpr EDerivationAlgorithm DERIVATIONS[] = { EDerivationAlgorithm::None, EDerivationAlgorithm::PBKDF2, EDerivationAlgorithm::Argon2D };
+
+		template<typename T>
+		void FillRandom(std::mt19937& generator, T& buffer, size_t size)
+		{
+			buffer.resize(size);
+			for (auto& byte : buffer)
+				byte = static_cast<uint8_t>(generator());
+		}
+
+		// Fields of every range CSerializer can read back: IVs are never empty, as an empty vector would consume the
+		// rest of its input
+		SEncryptedData MakeRandomEnvelope(std::mt19937& generator, EDerivationAlgorithm algorithm)
+		{
+			SEncryptedData envelope;
+			envelope.version = generator() % 3 == 0 ? generator() : SEncryptedData::expectedVersion;
+
+			EmplaceDerivationConfig(envelope.keyDerivation, algorithm);
+			std::visit([&](auto& config)
+			{
+				if constexpr (requires { config.tCost; })
+				{
+					config.tCost = generator() % 8;
+					config.mCost = generator();
+					config.parallelism = generator() % 16;
+				}
+
+				if constexpr (requires { config.iterations; })
+				{
+					static constexpr const char* HASH_METHODS[] = { "sha2", "sha256", "sha512" };
+					config.iterations = generator();
+					config.hashMethod = HASH_METHODS[generator() % std::size(HASH_METHODS)];
+				}
+
+				if constexpr (requires { config.saltLength; })
+				{
+					config.saltLength = generator() % 33;
+					FillRandom(generator, envelope.cipherData.salt, config.saltLength);
+				}
+			}, envelope.keyDerivation);
+
+			envelope.cipherConfig.cipherMode = generator() % 2 == 0 ? ECipherMode::CBCHMAC : ECipherMode::CBCHMAC64;
+			envelope.cipherConfig.ivLength = 1 + generator() % 16;
+
+			FillRandom(generator, envelope.cipherData.iv, envelope.cipherConfig.ivLength);
+			FillRandom(generator, envelope.cipherData.hash, ENVELOPE_HASH_SIZE);
+			FillRandom(generator, envelope.cipherData.encryptedPayload, 1 + generator() % 512);
+
+			return envelope;
+		}
+
+		template<typename T>
+		bool HasSameFields(const T& left, const T& right)
+		{
+			return std::apply([&](auto... members) { return ((left.*members == right.*members) && ...); }, SEnvelopeFields<T>::fields);
+		}
+
+		bool HasSameBytes(std::span<const uint8_t> left, std::span<const uint8_t> right)
+		{
+			return std::ranges::equal(left, right);
+		}
+
+		// Same fields as the envelope read by CSerializer, for SEncryptedData and SEncryptedDataView
+		template<typename TEnvelope>
+		bool HasSameEnvelope(const SEncryptedData& expected, const TEnvelope& envelope)
+		{
+			if (envelope.version != expected.version || envelope.keyDerivation.index() != expected.keyDerivation.index())
+				return false;
+
+			const bool hasSameDerivation = std::visit([&](const auto& config)
+			{
+				return HasSameFields(config, std::get<std::decay_t<decltype(config)>>(envelope.keyDerivation));
+			}, expected.keyDerivation);
+
+			return hasSameDerivation
+				&& HasSameFields(expected.cipherConfig, envelope.cipherConfig)
+				&& HasSameBytes(expected.cipherData.salt, envelope.cipherData.salt)
+				&& HasSameBytes(expected.cipherData.iv, envelope.cipherData.iv)
+				&& HasSameBytes(expected.cipherData.hash, envelope.cipherData.hash)
+				&& HasSameBytes(expected.cipherData.encryptedPayload, envelope.cipherData.encryptedPayload);
+		}
+
+		bool IsRejected(std::span<const uint8_t> input)
+		{
+			SEncryptedDataView view;
+			SEncryptedData envelope;
+			return !ReadEnvelope(input, view) && !ReadEnvelope(input, envelope);
+		}
+
+		// Input with the delimited token at index replaced by value
+		std::vector<uint8_t> ReplaceToken(std::span<const uint8_t> input, size_t index, std::string_view value)
+		{
+			auto begin = input.begin();
+			for (size_t i = 0; i < index; ++i)
+				begin = std::find(begin, input.end(), ENVELOPE_SEPARATOR) + 1;
+
+			const auto end = std::find(begin, input.end(), ENVELOPE_SEPARATOR);
+
+			std::vector<uint8_t> output(input.begin(), begin);
+			output.insert(output.end(), value.begin(), value.end());
+			output.insert(output.end(), end, input.end());
+
+			return output;
+		}
+
+		// Inputs the codec must reject: every truncation before the end of the hash, and corrupted delimited fields
+		bool CheckRejections(const SEncryptedData& envelope, std::span<const uint8_t> serialized, std::string& failure)
+		{
+			const std::string_view algorithm = GetEnumName(envelope.GetKeyDerivation().GetDerivation());
+			const size_t derivationFieldCount = std::visit([](const auto& config)
+			{
+				return std::tuple_size_v<std::decay_t<decltype(SEnvelopeFields<std::decay_t<decltype(config)>>::fields)>>;
+			}, envelope.keyDerivation);
+
+			const size_t payloadOffset = serialized.size() - envelope.cipherData.encryptedPayload.size();
+			for (size_t size = 0; size < payloadOffset; ++size)
+			{
+				if (!IsRejected(serialized.first(size)))
+				{
+					failure = std::format("{} envelope truncated to {} of {} bytes was read", algorithm, size, serialized.size());
+					return false;
+				}
+			}
+
+			const size_t versionToken = 1;
+			const size_t ivLengthToken = 3 + derivationFieldCount + 2;
+			const std::pair<size_t, std::string_view> corruptions[] =
+			{
+				{ 0, "x" },								// Leading token must be empty
+				{ versionToken, "1x" },					// Trailing characters after a number
+				{ versionToken, "" },					// Empty number
+				{ versionToken, "4294967296" },			// Number out of range
+				{ ivLengthToken, "-1" },				// Negative length
+				{ ivLengthToken, "4294967295" },		// Length beyond the input
+			};
+
+			for (const auto& [token, value] : corruptions)
+			{
+				if (!IsRejected(ReplaceToken(serialized, token, value)))
+				{
+					failure = std::format("{} envelope with \"{}\" as field {} was read", algorithm, value, token);
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	}
+
+	// The envelope codec writes the bytes of CSerializer and reads back the fields it reads, for random envelopes of
+	// every derivation. Truncated and corrupted envelopes are rejected by both ReadEnvelope overloads
+	bool CheckEnvelopeCodec(std::string& failure)
+	{
+		std::mt19937 generator(38);
+
+		for (const EDerivationAlgorithm derivation : DERIVATIONS)
+		{
+			const std::string_view algorithm = GetEnumName(derivation);
+
+			for (uint32_t i = 0; i < ENVELOPES_PER_DERIVATION; ++i)
+			{
+				const SEncryptedData envelope = MakeRandomEnvelope(generator, derivation);
+
+				std::vector<uint8_t> serialized;
+				std::vector<uint8_t> written;
+				if (!CSerializer::DoSerialize(serialized, envelope) || !WriteEnvelope(envelope, written))
+				{
+					failure = std::format("Failed to write {} envelope {}", algorithm, i);
+					return false;
+				}
+
+				if (written != serialized)
+				{
+					failure = std::format("{} envelope {} is written as {} bytes, CSerializer writes {} different ones", algorithm, i, written.size(), serialized.size());
+					return false;
+				}
+
+				SEncryptedData expected;
+				SEncryptedData envelopeRead;
+				SEncryptedDataView viewRead;
+				if (!CSerializer::DoDeserialize(serialized, expected) || !ReadEnvelope(serialized, envelopeRead) || !ReadEnvelope(serialized, viewRead))
+				{
+					failure = std::format("Failed to read {} envelope {}", algorithm, i);
+					return false;
+				}
+
+				if (!HasSameEnvelope(envelope, expected))
+				{
+					failure = std::format("CSerializer does not read back {} envelope {}, the check builds an invalid envelope", algorithm, i);
+					return false;
+				}
+
+				if (!HasSameEnvelope(expected, envelopeRead) || !HasSameEnvelope(expected, viewRead))
+				{
+					failure = std::format("{} envelope {} is not read as CSerializer reads it", algorithm, i);
+					return false;
+				}
+
+				if (!CheckRejections(envelope, serialized, failure))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "StdAfx.h"
+#include "Checks.h"
+
+#include <Api/RequestScheduler.h>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		struct SSyncRun
+		{
+			EDashlaneError rc{ EDashlaneError::NoError };	// First failed synchronization, the next ones are skipped
+			uint64_t requestCount{ 0 };						// Received by the server, injected failures included
+			int64_t serverClockOffset{ 0 };					// Measured by the context at the end of the run
+		};
+
+		// Synchronizes an empty local vault syncCount times in a row (a full synchronization, then up to date ones)
+		// against a server of its own, so its request count only covers this run
+		SSyncRun RunSynchronizations(SMockServerConfig config, uint32_t syncCount)
+		{
+			config.vault = { 20, 64, ESizeDistribution::Fixed, EEnvelopeDerivation::Argon2 };
+
+			SSyncRun run;
+
+			CMockServer server(config);
+			if (!server.Start())
+			{
+				run.rc = EDashlaneError::UnkownRequestError;
+				return run;
+			}
+
+			{
+				auto pContext = MakeRegisteredContext(server, std::filesystem::temp_directory_path() / "dashlane-check-network.db", APPLICATION_NAME);
+				for (uint32_t i = 0; i < syncCount && run.rc == EDashlaneError::NoError; ++i)
+					run.rc = SynchronizeVaultData(*pContext);
+
+				run.serverClockOffset = pContext->network.serverClockOffset;
+			}
+
+			run.requestCount = server.GetRequestCount();
+			server.Stop();
+
+			return run;
+		}
+
+	}
+
+	// Every request answered with a 503 is sent again, once, and the synchronizations still succeed
+	bool CheckRetryOnServerErrors(std::string& failure)
+	{
+		const SSyncRun healthy = RunSynchronizations({}, 3);
+		if (healthy.rc != EDashlaneError::NoError)
+		{
+			failure = std::format("Synchronization against a healthy server failed ({})", Dash_GetErrorMessage(static_cast<uint32_t>(healthy.rc)));
+			return false;
+		}
+
+		SMockServerConfig config;
+		config.failEvery = 2;
+
+		const SSyncRun faulty = RunSynchronizations(config, 3);
+		if (faulty.rc != EDashlaneError::NoError)
+		{
+			failure = std::format("Synchronization failed with a 503 every {} requests ({})", config.failEvery, Dash_GetErrorMessage(static_cast<uint32_t>(faulty.rc)));
+			return false;
+		}
+
+		const uint64_t injectedFailures = faulty.requestCount / config.failEvery;
+		if (injectedFailures == 0)
+		{
+			failure = "No failure was injected, the scenario does not exercise retries";
+			return false;
+		}
+
+		const uint64_t retries = faulty.requestCount - healthy.requestCount;
+		if (retries != injectedFailures)
+		{
+			failure = std::format("{} retries for {} injected failures", retries, injectedFailures);
+			return false;
+		}
+
+		return true;
+	}
+
+	// A server failing every request gets exactly the attempts allowed by the endpoint policy, then the error is returned
+	bool CheckRetryBudget(std::string& failure)
+	{
+		SMockServerConfig config;
+		config.failEvery = 1;
+
+		const SSyncRun run = RunSynchronizations(config, 1);
+		if (run.rc == EDashlaneError::NoError)
+		{
+			failure = "Synchronization succeeded against a server failing every request";
+			return false;
+		}
+
+		const uint32_t maxAttempts = GetRequestPolicy("sync/GetLatestContent").maxAttempts;
+		if (run.requestCount != maxAttempts)
+		{
+			failure = std::format("{} attempts, the policy allows {}", run.requestCount, maxAttempts);
+			return false;
+		}
+
+		return true;
+	}
+
+	// A server clock an hour ahead rejects the first request only, the offset measured from its Date header is used for
+	// the retry and for the next synchronizations
+	bool CheckClockSkewRecovery(std::string& failure)
+	{
+		const SSyncRun healthy = RunSynchronizations({}, 2);
+		if (healthy.rc != EDashlaneError::NoError)
+		{
+			failure = std::format("Synchronization against a healthy server failed ({})", Dash_GetErrorMessage(static_cast<uint32_t>(healthy.rc)));
+			return false;
+		}
+
+		SMockServerConfig config;
+		config.clockSkewSeconds = 3600;
+
+		const SSyncRun skewed = RunSynchronizations(config, 2);
+		if (skewed.rc != EDashlaneError::NoError)
+		{
+			failure = std::format("Synchronization failed with a server clock skew of {}s ({})", config.clockSkewSeconds, Dash_GetErrorMessage(static_cast<uint32_t>(skewed.rc)));
+			return false;
+		}
+
+		// Date headers have a one second resolution and the clock may tick between the two reads
+		if (std::abs(skewed.serverClockOffset - config.clockSkewSeconds) > 2)
+		{
+			failure = std::format("Measured a clock offset of {}s for a skew of {}s", skewed.serverClockOffset, config.clockSkewSeconds);
+			return false;
+		}
+
+		if (skewed.requestCount != healthy.requestCount + 1)
+		{
+			failure = std::format("{} requests, {} expected (a single rejected request)", skewed.requestCount, healthy.requestCount + 1);
+			return false;
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
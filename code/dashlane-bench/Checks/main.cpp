@@ -0,0 +1,56 @@
+#include "StdAfx.h"
+#include "Checks.h"
+
+#include <iostream>
+
+namespace
+{
+
+	struct SCheck
+	{
+		const char* szName;
+		Dashlane::CheckFunc function;
+	};
+
+	const SCheck s_checks[] =
+	{
+		{ "RetryOnServerErrors", Dashlane::CheckRetryOnServerErrors },
+		{ "RetryBudget", Dashlane::CheckRetryBudget },
+		{ "ClockSkewRecovery", Dashlane::CheckClockSkewRecovery },
+		{ "LookupDuringSync", Dashlane::CheckLookupDuringSync },
+		{ "EnvelopeCodec", Dashlane::CheckEnvelopeCodec },
+		{ "Base64Kernels", Dashlane::CheckBase64Kernels },
+	};
+
+}
+
+// Runs every check, or only the ones named on the command line. Exits with 1 if any check failed
+int main(int argc, char** argv)
+{
+	const std::vector<std::string> selected(argv + 1, argv + argc);
+
+	uint32_t failedCount = 0;
+	for (const SCheck& check : s_checks)
+	{
+		if (!selected.empty() && std::find(selected.begin(), selected.end(), check.szName) == selected.end())
+			continue;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		std::string failure;
+		const bool passed = check.function(failure);
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		if (passed)
+		{
+			std::cout << "[PASS] " << check.szName << " (" << elapsed.count() << " ms)" << std::endl;
+		}
+		else
+		{
+			std::cout << "[FAIL] " << check.szName << ": " << failure << std::endl;
+			++failedCount;
+		}
+	}
+
+	return failedCount == 0 ? 0 : 1;
+}
\ No newline at end of file
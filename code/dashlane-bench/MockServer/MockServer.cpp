@@ -0,0 +1,524 @@
+#include "StdAfx.h"
+#include "MockServer.h"
+
+#include <ctime>
+#include <set>
+#include <sstream>
+
+#if defined(WINDOWS)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		using SocketHandle = CMockServer::SocketHandle;
+
+		static constexpr SocketHandle invalidSocket = -1;
+		static constexpr int pollIntervalMs = 100;
+		static constexpr size_t maxRequestSize = 16 * 1024 * 1024;
+
+#if defined(WINDOWS)
+		using NativeSocket = SOCKET;
+		void CloseSocket(SocketHandle handle) { closesocket(static_cast<NativeSocket>(handle)); }
+		int PollSocket(pollfd* pfd, int timeoutMs) { return WSAPoll(pfd, 1, timeoutMs); }
+
+		bool InitializeSockets()
+		{
+			static const bool s_initialized = []()
+			{
+				WSADATA data;
+				return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+			}();
+
+			return s_initialized;
+		}
+#else
+		using NativeSocket = int;
+		void CloseSocket(SocketHandle handle) { close(static_cast<NativeSocket>(handle)); }
+		int PollSocket(pollfd* pfd, int timeoutMs) { return poll(pfd, 1, timeoutMs); }
+		bool InitializeSockets() { return true; }
+#endif
+
+		NativeSocket ToNative(SocketHandle handle)
+		{
+			return static_cast<NativeSocket>(handle);
+		}
+
+		// Waits for data while checking the stop flag, returns false on timeout, error or stop
+		bool WaitReadable(SocketHandle handle, const std::atomic<bool>& stopping, int timeoutMs)
+		{
+			for (int waited = 0; waited < timeoutMs && !stopping; waited += pollIntervalMs)
+			{
+				pollfd pfd{};
+				pfd.fd = ToNative(handle);
+				pfd.events = POLLIN;
+
+				const int ready = PollSocket(&pfd, pollIntervalMs);
+				if (ready > 0)
+					return true;
+				if (ready < 0)
+					return false;
+			}
+
+			return false;
+		}
+
+		bool SendAll(SocketHandle handle, const std::string& data)
+		{
+			size_t sent = 0;
+			while (sent < data.size())
+			{
+				const int count = send(ToNative(handle), data.data() + sent, static_cast<int>(std::min<size_t>(data.size() - sent, INT32_MAX)), 0);
+				if (count <= 0)
+					return false;
+				sent += static_cast<size_t>(count);
+			}
+
+			return true;
+		}
+
+		std::string ToLower(std::string value)
+		{
+			std::ranges::transform(value, value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return value;
+		}
+
+		std::string Trim(const std::string& value)
+		{
+			const size_t begin = value.find_first_not_of(" \t");
+			const size_t end = value.find_last_not_of(" \t\r");
+			return begin == std::string::npos ? "" : value.substr(begin, end - begin + 1);
+		}
+
+		// "Sun, 06 Nov 1994 08:49:37 GMT"
+		std::string FormatHttpDate(int64_t timestamp)
+		{
+			const std::time_t time = static_cast<std::time_t>(timestamp);
+			std::tm utc{};
+#if defined(WINDOWS)
+			gmtime_s(&utc, &time);
+#else
+			gmtime_r(&time, &utc);
+#endif
+
+			char buffer[64];
+			std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+			return buffer;
+		}
+
+		const char* GetStatusText(int status)
+		{
+			switch (status)
+			{
+			case 200: return "OK";
+			case 400: return "Bad Request";
+			case 404: return "Not Found";
+			case 503: return "Service Unavailable";
+			default: return "Error";
+			}
+		}
+
+		SHttpResponse MakeError(int status, const std::string& type, const std::string& code, const std::string& message)
+		{
+			const nlohmann::ordered_json body = { { "errors", { { { "type", type }, { "code", code }, { "message", message } } } } };
+			return { status, body.dump() };
+		}
+
+		// Reads one request from the connection, data past the request stays in the buffer for the next one
+		bool ReadRequest(SocketHandle handle, const std::atomic<bool>& stopping, std::string& buffer, SHttpRequest& request)
+		{
+			static constexpr int idleTimeoutMs = 30000;
+
+			char chunk[16 * 1024];
+			const auto receive = [&]() -> bool
+			{
+				if (!WaitReadable(handle, stopping, idleTimeoutMs))
+					return false;
+
+				const int count = recv(ToNative(handle), chunk, sizeof(chunk), 0);
+				if (count <= 0)
+					return false;
+
+				buffer.append(chunk, static_cast<size_t>(count));
+				return buffer.size() <= maxRequestSize;
+			};
+
+			size_t headerEnd = std::string::npos;
+			while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+			{
+				if (!receive())
+					return false;
+			}
+
+			std::istringstream header(buffer.substr(0, headerEnd));
+			buffer.erase(0, headerEnd + 4);
+
+			std::string line;
+			std::getline(header, line);
+
+			std::istringstream requestLine(line);
+			requestLine >> request.method >> request.path;
+
+			request.headers.clear();
+			while (std::getline(header, line))
+			{
+				if (const size_t colon = line.find(':'); colon != std::string::npos)
+					request.headers[ToLower(Trim(line.substr(0, colon)))] = Trim(line.substr(colon + 1));
+			}
+
+			size_t contentLength = 0;
+			if (const auto it = request.headers.find("content-length"); it != request.headers.end())
+				contentLength = std::strtoull(it->second.c_str(), nullptr, 10);
+
+			if (contentLength > maxRequestSize)
+				return false;
+
+			// curl waits for this before sending larger bodies
+			if (const auto it = request.headers.find("expect"); it != request.headers.end() && ToLower(it->second) == "100-continue")
+			{
+				if (!SendAll(handle, "HTTP/1.1 100 Continue\r\n\r\n"))
+					return false;
+			}
+
+			while (buffer.size() < contentLength)
+			{
+				if (!receive())
+					return false;
+			}
+
+			request.body = buffer.substr(0, contentLength);
+			buffer.erase(0, contentLength);
+
+			return true;
+		}
+
+	}
+
+	CMockServer::CMockServer(const SMockServerConfig& config)
+		: m_config(config)
+		, m_vault(config.vault)
+	{
+		SerializeVault();
+	}
+
+	void CMockServer::SerializeVault()
+	{
+		nlohmann::ordered_json summary = nlohmann::ordered_json::object();
+
+		m_transactions.clear();
+		m_transactions.reserve(m_vault.GetTransactions().size() + m_vault.GetRemovals().size());
+		for (const SRawTransactionBackupEdit& transaction : m_vault.GetTransactions())
+		{
+			m_transactions.push_back({ transaction.identifier, transaction.backupDate, nlohmann::ordered_json{
+				{ "backupDate", transaction.backupDate },
+				{ "identifier", transaction.identifier },
+				{ "time", transaction.backupDate },
+				{ "content", transaction.content },
+				{ "type", transaction.type },
+				{ "action", transaction.GetActionName() }
+			}.dump() });
+
+			summary[transaction.type][transaction.identifier] = transaction.backupDate;
+			m_vaultTimestamp = std::max(m_vaultTimestamp, transaction.backupDate);
+		}
+
+		// Removed items are left out of the summary
+		for (const SRawTransactionBackupRemove& removal : m_vault.GetRemovals())
+		{
+			m_transactions.push_back({ removal.identifier, removal.backupDate, nlohmann::ordered_json{
+				{ "backupDate", removal.backupDate },
+				{ "identifier", removal.identifier },
+				{ "time", removal.time },
+				{ "type", removal.type },
+				{ "action", removal.GetActionName() }
+			}.dump() });
+
+			m_vaultTimestamp = std::max(m_vaultTimestamp, removal.backupDate);
+		}
+
+		m_summaryJson = summary.dump();
+	}
+
+	bool CMockServer::ApplyVaultChanges(const SVaultChanges& changes)
+	{
+		std::unique_lock<std::shared_mutex> lock(m_vaultMutex);
+
+		const bool applied = m_vault.ApplyChanges(changes);
+		SerializeVault();
+
+		return applied;
+	}
+
+	void CMockServer::HoldResponses()
+	{
+		std::lock_guard<std::mutex> lock(m_holdMutex);
+		m_isHolding = true;
+	}
+
+	void CMockServer::ReleaseResponses()
+	{
+		std::lock_guard<std::mutex> lock(m_holdMutex);
+		m_isHolding = false;
+		m_holdChanged.notify_all();
+	}
+
+	bool CMockServer::WaitForHeldResponse(std::chrono::milliseconds timeout)
+	{
+		std::unique_lock<std::mutex> lock(m_holdMutex);
+		return m_holdChanged.wait_for(lock, timeout, [this]() { return m_heldResponses > 0; });
+	}
+
+	void CMockServer::WaitWhileHeld()
+	{
+		std::unique_lock<std::mutex> lock(m_holdMutex);
+		if (!m_isHolding)
+			return;
+
+		++m_heldResponses;
+		m_holdChanged.notify_all();
+		m_holdChanged.wait(lock, [this]() { return !m_isHolding || m_stopping; });
+		--m_heldResponses;
+	}
+
+	CMockServer::~CMockServer()
+	{
+		Stop();
+	}
+
+	bool CMockServer::Start()
+	{
+		if (!InitializeSockets())
+			return false;
+
+		const NativeSocket listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (static_cast<SocketHandle>(listenSocket) == invalidSocket)
+			return false;
+
+#if !defined(WINDOWS)
+		// Restarting the server must not wait for the sockets of the previous run to leave TIME_WAIT
+		const int reuse = 1;
+		setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(m_config.port);
+
+		socklen_t addressLength = sizeof(address);
+		if (bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+			|| listen(listenSocket, 64) != 0
+			|| getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0)
+		{
+			CloseSocket(static_cast<SocketHandle>(listenSocket));
+			return false;
+		}
+
+		m_listenSocket = static_cast<SocketHandle>(listenSocket);
+		m_port = ntohs(address.sin_port);
+		m_stopping = false;
+		m_acceptThread = std::thread(&CMockServer::AcceptConnections, this);
+
+		return true;
+	}
+
+	void CMockServer::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_holdMutex);
+			m_stopping = true;
+			m_holdChanged.notify_all();
+		}
+
+		if (m_acceptThread.joinable())
+			m_acceptThread.join();
+
+		if (m_listenSocket != invalidSocket)
+		{
+			CloseSocket(m_listenSocket);
+			m_listenSocket = invalidSocket;
+		}
+
+		// Connection threads notice the stop flag within one poll interval
+		std::unique_lock<std::mutex> lock(m_connectionsMutex);
+		m_connectionsDone.wait(lock, [this]() { return m_activeConnections == 0; });
+	}
+
+	void CMockServer::AcceptConnections()
+	{
+		while (!m_stopping)
+		{
+			if (!WaitReadable(m_listenSocket, m_stopping, pollIntervalMs))
+				continue;
+
+			const NativeSocket clientSocket = accept(ToNative(m_listenSocket), nullptr, nullptr);
+			if (static_cast<SocketHandle>(clientSocket) == invalidSocket)
+				continue;
+
+			{
+				std::lock_guard<std::mutex> lock(m_connectionsMutex);
+				++m_activeConnections;
+			}
+
+			// One thread per connection, the library opens a connection per request
+			std::thread(&CMockServer::ServeConnection, this, static_cast<SocketHandle>(clientSocket)).detach();
+		}
+	}
+
+	void CMockServer::ServeConnection(SocketHandle clientSocket)
+	{
+		std::string buffer;
+		SHttpRequest request;
+
+		while (!m_stopping && ReadRequest(clientSocket, m_stopping, buffer, request))
+		{
+			const SHttpResponse response = HandleRequest(request);
+
+			if (m_config.latencyMs > 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(m_config.latencyMs));
+
+			WaitWhileHeld();
+
+			const std::string header = std::format(
+				"HTTP/1.1 {} {}\r\n"
+				"Date: {}\r\n"
+				"Content-Type: application/json\r\n"
+				"Content-Length: {}\r\n"
+				"Connection: keep-alive\r\n\r\n",
+				response.status, GetStatusText(response.status), FormatHttpDate(GetServerTime()), response.body.size());
+
+			if (!SendAll(clientSocket, header) || !SendAll(clientSocket, response.body))
+				break;
+		}
+
+		CloseSocket(clientSocket);
+
+		std::lock_guard<std::mutex> lock(m_connectionsMutex);
+		if (--m_activeConnections == 0)
+			m_connectionsDone.notify_all();
+	}
+
+	int64_t CMockServer::GetServerTime() const
+	{
+		return static_cast<int64_t>(std::time(nullptr)) + m_config.clockSkewSeconds;
+	}
+
+	SHttpResponse CMockServer::HandleRequest(const SHttpRequest& request)
+	{
+		const uint64_t requestNumber = ++m_requestCount;
+
+		if (m_config.failEvery > 0 && requestNumber % m_config.failEvery == 0)
+			return MakeError(503, "server_error", "service_unavailable", "Injected failure");
+
+		if (request.method != "POST")
+			return MakeError(404, "invalid_request_error", "invalid_endpoint", "Only POST is supported");
+
+		// Same tolerance as the API, lets clients exercise their clock skew recovery
+		if (const auto it = request.headers.find("authorization"); it != request.headers.end())
+		{
+			if (const size_t position = it->second.find("Timestamp="); position != std::string::npos)
+			{
+				const int64_t timestamp = std::strtoll(it->second.c_str() + position + 10, nullptr, 10);
+				if (std::abs(timestamp - GetServerTime()) > 60)
+					return MakeError(400, "invalid_request_error", "out_of_bounds_timestamp", "Request timestamp is out of bounds");
+			}
+		}
+
+		const nlohmann::ordered_json payload = nlohmann::ordered_json::parse(request.body, nullptr, false);
+		if (payload.is_discarded())
+			return MakeError(400, "invalid_request_error", "invalid_payload", "Request body is not valid JSON");
+
+		static constexpr std::string_view prefix = "/v1/";
+		const std::string endpoint = request.path.starts_with(prefix) ? request.path.substr(prefix.size()) : request.path;
+
+		if (endpoint == "sync/GetLatestContent")
+			return { 200, MakeLatestContent(payload) };
+
+		if (endpoint == "authentication/GetAuthenticationMethodsForDevice")
+			return { 200, R"({"data":{"verifications":[{"type":"email_token"}]}})" };
+
+		if (endpoint == "authentication/RequestEmailTokenVerification")
+			return { 200, R"({"data":{}})" };
+
+		if (endpoint == "authentication/PerformEmailTokenVerification"
+			|| endpoint == "authentication/PerformTotpVerification"
+			|| endpoint == "authentication/PerformDuoPushVerification"
+			|| endpoint == "authentication/PerformDashlaneAuthenticatorVerification")
+			return { 200, R"({"data":{"authTicket":"mock-auth-ticket"}})" };
+
+		if (endpoint == "authentication/CompleteDeviceRegistrationWithAuthTicket")
+			return { 200, MakeDeviceRegistration().dump() };
+
+		return MakeError(400, "invalid_request_error", "invalid_endpoint", std::format("Unknown endpoint {}", endpoint));
+	}
+
+	nlohmann::ordered_json CMockServer::MakeDeviceRegistration() const
+	{
+		std::shared_lock<std::shared_mutex> lock(m_vaultMutex);
+
+		return {
+			{ "data", {
+				{ "deviceAccessKey", "mockdeviceaccesskey" },
+				{ "deviceSecretKey", std::string(64, 'a') },
+				{ "settings", {
+					{ "backupDate", m_vaultTimestamp },
+					{ "identifier", "SETTINGS_userId" },
+					{ "time", m_vaultTimestamp },
+					{ "content", "" },
+					{ "type", "SETTINGS" },
+					{ "action", "BACKUP_EDIT" }
+				} },
+				{ "numberOfDevices", 1 },
+				{ "hasDesktopDevices", false },
+				{ "publicUserId", "mock-public-user" },
+				{ "userAnalyticsId", "mock-user-analytics" },
+				{ "deviceAnalyticsId", "mock-device-analytics" }
+			} }
+		};
+	}
+
+	std::string CMockServer::MakeLatestContent(const nlohmann::ordered_json& payload) const
+	{
+		const uint64_t timestamp = payload.value("timestamp", uint64_t(0));
+
+		std::set<std::string> requested;
+		if (const auto it = payload.find("transactions"); it != payload.end() && it->is_array())
+		{
+			for (const auto& identifier : *it)
+			{
+				if (identifier.is_string())
+					requested.insert(identifier.get<std::string>());
+			}
+		}
+
+		std::shared_lock<std::shared_mutex> lock(m_vaultMutex);
+
+		std::string transactions;
+		for (const SServedTransaction& transaction : m_transactions)
+		{
+			if (transaction.backupDate <= timestamp && !requested.contains(transaction.identifier))
+				continue;
+
+			if (!transactions.empty())
+				transactions.push_back(',');
+			transactions += transaction.json;
+		}
+
+		return std::format(
+			R"({{"data":{{"transactions":[{}],"fullBackup":{{}},"timestamp":{},)"
+			R"("sharing2":{{"itemGroups":[],"items":[],"userGroups":[]}},"syncAllowed":true,"uploadEnabled":true,"summary":{}}}}})",
+			transactions, m_vaultTimestamp, m_summaryJson);
+	}
+
+}
\ No newline at end of file
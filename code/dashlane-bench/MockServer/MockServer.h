@@ -0,0 +1,119 @@
+#pragma once
+
+#include "SyntheticVault.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace Dashlane
+{
+
+	struct SMockServerConfig
+	{
+		uint16_t port{ 0 };					// 0 picks a free port
+		SSyntheticVaultConfig vault{ 1000, 256, ESizeDistribution::Exponential, EEnvelopeDerivation::Argon2 };
+		uint32_t latencyMs{ 0 };			// Added before every response
+		uint32_t failEvery{ 0 };			// Every Nth request is answered with a 503 (0 = never)
+		int32_t clockSkewSeconds{ 0 };		// Offset of the server clock, requests signed more than 60s away from it are rejected
+	};
+
+	struct SHttpRequest
+	{
+		std::string method;
+		std::string path;
+		std::map<std::string, std::string> headers; // Lower case names
+		std::string body;
+	};
+
+	struct SHttpResponse
+	{
+		int status{ 200 };
+		std::string body;
+	};
+
+	// Minimal HTTP/1.1 server answering the API endpoints used by the library (authentication,
+	// device registration and sync) from a synthetic vault. Only listens on the loopback interface.
+	class CMockServer
+	{
+
+	public:
+
+		using SocketHandle = intptr_t;
+
+		CMockServer(const SMockServerConfig& config);
+		CMockServer(const CMockServer&) = delete;
+		~CMockServer();
+
+		bool Start();
+		void Stop();
+
+		uint16_t GetPort() const { return m_port; }
+		std::string GetBaseUrl() const { return std::format("http://127.0.0.1:{}", m_port); }
+		uint64_t GetRequestCount() const { return m_requestCount; }
+
+		// Vault served by GetLatestContent, its context holds the master password able to decrypt it
+		CSyntheticVault& GetVault() { return m_vault; }
+
+		// Serves the vault with the changes applied from the next GetLatestContent request
+		bool ApplyVaultChanges(const SVaultChanges& changes);
+
+		// While held, responses wait after their request is handled until the responses are released
+		void HoldResponses();
+		void ReleaseResponses();
+
+		// Waits until a response is held, false after the timeout
+		bool WaitForHeldResponse(std::chrono::milliseconds timeout);
+
+	protected:
+
+		void AcceptConnections();
+		void ServeConnection(SocketHandle clientSocket);
+
+		SHttpResponse HandleRequest(const SHttpRequest& request);
+		nlohmann::ordered_json MakeDeviceRegistration() const;
+		std::string MakeLatestContent(const nlohmann::ordered_json& payload) const;
+
+		int64_t GetServerTime() const;
+
+		void SerializeVault();
+		void WaitWhileHeld();
+
+	private:
+
+		const SMockServerConfig m_config;
+		CSyntheticVault m_vault;
+
+		struct SServedTransaction
+		{
+			std::string identifier;
+			uint32_t backupDate{ 0 };
+			std::string json;
+		};
+
+		// Transactions serialized once per vault revision, a full synchronization only concatenates them
+		mutable std::shared_mutex m_vaultMutex;
+		std::vector<SServedTransaction> m_transactions;
+		std::string m_summaryJson;
+		uint32_t m_vaultTimestamp{ 0 };
+
+		std::mutex m_holdMutex;
+		std::condition_variable m_holdChanged;
+		bool m_isHolding{ false };
+		size_t m_heldResponses{ 0 };
+
+		SocketHandle m_listenSocket{ -1 };
+		uint16_t m_port{ 0 };
+		std::thread m_acceptThread;
+		std::atomic<bool> m_stopping{ false };
+		std::atomic<uint64_t> m_requestCount{ 0 };
+
+		std::mutex m_connectionsMutex;
+		std::condition_variable m_connectionsDone;
+		size_t m_activeConnections{ 0 };
+
+	};
+
+}
\ No newline at end of file
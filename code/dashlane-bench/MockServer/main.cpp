@@ -0,0 +1,99 @@
+#include "StdAfx.h"
+#include "MockServer.h"
+
+#include <CLI/CLI.hpp>
+
+#include <csignal>
+#include <iostream>
+
+namespace
+{
+
+	volatile std::sig_atomic_t s_stopRequested = 0;
+
+	void HandleStopSignal(int)
+	{
+		s_stopRequested = 1;
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	using namespace Dashlane;
+
+	SMockServerConfig config;
+	config.port = 8080;
+
+	std::string distribution = "exponential";
+	std::string derivation = "argon2";
+
+	CLI::App app{ "Local mock of the Dashlane API serving a synthetic vault, for offline end-to-end and sync benchmarks" };
+	app.add_option("--port", config.port, "Port to listen on (loopback only), 0 picks a free port")->default_val(8080);
+	app.add_option("--items", config.vault.itemCount, "Number of items in the synthetic vault")->default_val(1000);
+	app.add_option("--note-size", config.vault.noteSize, "Mean size of the item notes in characters")->default_val(256);
+	app.add_option("--distribution", distribution, "Note size distribution: fixed, uniform or exponential")->default_val("exponential");
+	app.add_option("--derivation", derivation, "Item key derivation: argon2 or pbkdf2")->default_val("argon2");
+	app.add_option("--seed", config.vault.seed, "Seed of the synthetic vault content")->default_val(1);
+	app.add_option("--latency-ms", config.latencyMs, "Delay added before every response")->default_val(0);
+	app.add_option("--fail-every", config.failEvery, "Answer every Nth request with a 503, 0 to never fail")->default_val(0);
+	app.add_option("--clock-skew", config.clockSkewSeconds, "Offset of the server clock in seconds")->default_val(0);
+
+	try
+	{
+		app.parse(argc, argv);
+	}
+	catch (const CLI::ParseError& e)
+	{
+		return app.exit(e);
+	}
+
+	if (distribution == "fixed")
+		config.vault.distribution = ESizeDistribution::Fixed;
+	else if (distribution == "uniform")
+		config.vault.distribution = ESizeDistribution::Uniform;
+	else if (distribution == "exponential")
+		config.vault.distribution = ESizeDistribution::Exponential;
+	else
+	{
+		std::cerr << "Unknown distribution: " << distribution << std::endl;
+		return 1;
+	}
+
+	if (derivation == "argon2")
+		config.vault.derivation = EEnvelopeDerivation::Argon2;
+	else if (derivation == "pbkdf2")
+		config.vault.derivation = EEnvelopeDerivation::Pbkdf2;
+	else
+	{
+		std::cerr << "Unknown derivation: " << derivation << std::endl;
+		return 1;
+	}
+
+	std::cout << "Generating " << config.vault.itemCount << " items..." << std::endl;
+
+	CMockServer server(config);
+	if (!server.Start())
+	{
+		std::cerr << "Failed to listen on port " << config.port << std::endl;
+		return 1;
+	}
+
+	std::signal(SIGINT, HandleStopSignal);
+	std::signal(SIGTERM, HandleStopSignal);
+
+	std::cout << "Mock API listening on " << server.GetBaseUrl() << std::endl;
+	std::cout << "\tDASHLANE_API_URL=" << server.GetBaseUrl() << std::endl;
+	std::cout << "\tLogin: " << CSyntheticVault::login << std::endl;
+	std::cout << "\tMaster password: " << CSyntheticVault::masterPassword << std::endl;
+	std::cout << "\tAny email token or OTP code is accepted" << std::endl;
+
+	while (s_stopRequested == 0)
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+	server.Stop();
+
+	std::cout << "Served " << server.GetRequestCount() << " requests" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
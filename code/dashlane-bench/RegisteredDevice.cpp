@@ -0,0 +1,68 @@
+#include "StdAfx.h"
+#include "RegisteredDevice.h"
+
+#include <Keychain.h>
+#include <SecretStore.h>
+#include <Utility/Environment.h>
+
+namespace Dashlane
+{
+
+	std::unique_ptr<DashlaneContextInternal> MakeRegisteredContext(CMockServer& server, const std::filesystem::path& databasePath,
+		const char* szApplicationName)
+	{
+		DashlaneContextInternal& vaultContext = server.GetVault().GetContext();
+
+		auto pContext = std::make_unique<DashlaneContextInternal>(vaultContext.login.c_str(), szApplicationName);
+		pContext->secrets = vaultContext.secrets;
+		pContext->secrets.app = { MOCK_APP_KEY, MOCK_APP_KEY };
+		pContext->secrets.device = { MOCK_APP_KEY, Utility::SecureString(64, 'a') };
+		pContext->network.apiBaseUrl = server.GetBaseUrl();
+
+		std::filesystem::remove(databasePath);
+		pContext->pDatabase = std::make_unique<CDatabase>(databasePath);
+		pContext->pDatabase->Connect();
+		pContext->pDatabase->Prepare();
+
+		return pContext;
+	}
+
+	bool PrepareRegisteredDevice(CMockServer& server, const std::filesystem::path& dataFolder, const char* szApplicationName)
+	{
+		std::filesystem::remove_all(dataFolder);
+		std::filesystem::create_directories(dataFolder);
+
+		auto pContext = MakeRegisteredContext(server, dataFolder / "userdata.db", szApplicationName);
+		if (SynchronizeVaultData(*pContext) != EDashlaneError::NoError)
+			return false;
+
+		if (UpdateDeviceConfiguration(*pContext) != EDashlaneError::NoError)
+			return false;
+
+		const auto pSecretStore = CreateSecretStore(ESecretStore::Memory, dataFolder);
+		return pSecretStore && pSecretStore->SetSecret(szApplicationName, pContext->login, pContext->secrets.localKey);
+	}
+
+	CMockServerEnvironment::CMockServerEnvironment(const CMockServer& server, const std::filesystem::path& dataFolder)
+	{
+		const std::pair<const char*, std::string> values[] =
+		{
+			{ "DASHLANE_DATA_DIR", dataFolder.string() },
+			{ "DASHLANE_API_URL", server.GetBaseUrl() },
+		};
+
+		for (const auto& [szName, value] : values)
+		{
+			m_previousValues.emplace(szName, Utility::ReadEnvironmentVariable(szName));
+			Utility::WriteEnvironmentVariable(szName, value);
+		}
+	}
+
+	CMockServerEnvironment::~CMockServerEnvironment()
+	{
+		// An empty value reads as not set
+		for (const auto& [name, value] : m_previousValues)
+			Utility::WriteEnvironmentVariable(name.c_str(), value.value_or(""));
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "MockServer/MockServer.h"
+
+namespace Dashlane
+{
+
+	// Application keys of the contexts registered to the mock server, which does not check the request signatures
+	static constexpr char MOCK_APP_KEY[] = "mock";
+
+	// Unlocked context of a device registered to the mock server, with an empty local vault at databasePath
+	std::unique_ptr<DashlaneContextInternal> MakeRegisteredContext(CMockServer& server, const std::filesystem::path& databasePath,
+		const char* szApplicationName);
+
+	// Registered device with a synchronized local vault in dataFolder, as left by a first `dcli sync`. The local key is
+	// kept in the memory secret store, which outlives the contexts of the process like a keychain entry would, so a
+	// context created with ESecretStore::Memory unlocks the vault with the master password only
+	bool PrepareRegisteredDevice(CMockServer& server, const std::filesystem::path& dataFolder, const char* szApplicationName);
+
+	// Points the contexts created by Dash_InitContext to dataFolder and the mock server, as a user running the CLI
+	// against the mock server would. The previous values are restored on destruction
+	class CMockServerEnvironment
+	{
+
+	public:
+
+		CMockServerEnvironment(const CMockServer& server, const std::filesystem::path& dataFolder);
+		CMockServerEnvironment(const CMockServerEnvironment&) = delete;
+		~CMockServerEnvironment();
+
+	private:
+
+		std::map<std::string, std::optional<std::string>> m_previousValues;
+
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "StdAfx.h"
+#include "SyntheticVault.h"
+
+#include <Encryption.h>
+#include <Utility/Cryptography.h>
+
+#include <zlib/zlib.h>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		// Parameters used by the Dashlane clients for server transactions
+		DerivationConfig MakeDerivationConfig(EEnvelopeDerivation derivation)
+		{
+			switch (derivation)
+			{
+			case EEnvelopeDerivation::Argon2:
+			{
+				SDerivationConfigArgon2 config;
+				config.saltLength = 16;
+				config.tCost = 3;
+				config.mCost = 32768;
+				config.parallelism = 2;
+				return config;
+			}
+
+			case EEnvelopeDerivation::Pbkdf2:
+			{
+				SDerivationConfigPbkdf2 config;
+				config.saltLength = 32;
+				config.iterations = 200000;
+				config.hashMethod = "sha2";
+				return config;
+			}
+
+			default:
+				return SDerivationConfigNone();
+			}
+		}
+
+	}
+
+	CSyntheticVault::CSyntheticVault(const SSyntheticVaultConfig& config)
+		: m_config(config)
+		, m_context(login, "dashlane-bench")
+	{
+		m_context.secrets.masterPassword = masterPassword;
+		m_context.secrets.localKey = Utility::GenerateSecureRandomData(32);
+
+		// One salt for the whole vault, like a vault encrypted by a single client session
+		const DerivationConfig derivationConfig = MakeDerivationConfig(m_config.derivation);
+		if (const IDerivationConfig& config = GetDerivationConfig(derivationConfig); config.HasSalt())
+		{
+			m_salt = Utility::GenerateRandomData(config.GetSaltLength());
+
+			CEncryption encryption;
+			encryption.GetSymmetricKeyViaDerivate(config, m_salt, m_context.secrets.masterPassword, m_derivedKey);
+		}
+
+		std::mt19937 generator(m_config.seed);
+
+		m_transactions.resize(m_config.itemCount);
+		for (SRawTransactionBackupEdit& transaction : m_transactions)
+		{
+			if (!MakeTransaction(m_nextIndex++, generator, transaction))
+				throw std::runtime_error("Failed to encrypt synthetic item");
+		}
+	}
+
+	bool CSyntheticVault::ApplyChanges(const SVaultChanges& changes)
+	{
+		if (changes.changedCount + changes.removedCount > m_transactions.size())
+			return false;
+
+		// Seeded by the revision, the same changes give the same vault
+		++m_revision;
+		std::mt19937 generator(m_config.seed + m_revision);
+
+		for (size_t i = 0; i < changes.removedCount; ++i)
+		{
+			SRawTransactionBackupRemove removal;
+			removal.identifier = m_transactions.back().identifier;
+			removal.type = m_transactions.back().type;
+			removal.backupDate = m_revision;
+			removal.time = m_revision;
+
+			m_removals.emplace_back(std::move(removal));
+			m_transactions.pop_back();
+		}
+
+		for (size_t i = 0; i < changes.changedCount; ++i)
+		{
+			// Index of "{BENCH-%08d}", the item keeps its identifier
+			const size_t index = std::stoul(m_transactions[i].identifier.substr(7, 8));
+			if (!MakeTransaction(index, generator, m_transactions[i]))
+				return false;
+		}
+
+		for (size_t i = 0; i < changes.addedCount; ++i)
+		{
+			if (!MakeTransaction(m_nextIndex++, generator, m_transactions.emplace_back()))
+				return false;
+		}
+
+		return true;
+	}
+
+	std::vector<uint8_t> CSyntheticVault::MakeItemXml(size_t index, const std::string& note)
+	{
+		const std::map<std::string, std::string> fields =
+		{
+			{ "Category", "" },
+			{ "Email", std::format("user{}@example.com", index) },
+			{ "Id", std::format("{{BENCH-{:08}}}", index) },
+			{ "Login", std::format("user{}", index) },
+			{ "Note", note },
+			{ "Password", std::format("p@ss-{:016x}", index * 0x9E3779B97F4A7C15ull) },
+			{ "SecondaryLogin", "" },
+			{ "Title", std::format("Service {}", index) },
+			{ "Url", std::format("https://service{}.example.com/login", index) },
+		};
+
+		std::string xml = R"(<?xml version="1.0" encoding="UTF-8"?><root><KWAuthentifiant>)";
+		for (const auto& [key, value] : fields)
+			xml += std::format(R"(<KWDataItem key="{}"><![CDATA[{}]]></KWDataItem>)", key, value);
+		xml += "</KWAuthentifiant></root>";
+
+		return std::vector<uint8_t>(xml.begin(), xml.end());
+	}
+
+	std::vector<uint8_t> CSyntheticVault::Compress(const std::vector<uint8_t>& xml)
+	{
+		// Big endian uncompressed size followed by a zlib stream, the reader skips the size and the zlib header
+		const uint32_t size = static_cast<uint32_t>(xml.size());
+		std::vector<uint8_t> compressed = { uint8_t(size >> 24), uint8_t(size >> 16), uint8_t(size >> 8), uint8_t(size) };
+
+		uLongf compressedSize = compressBound(static_cast<uLong>(xml.size()));
+		compressed.resize(4 + compressedSize);
+		compress2(compressed.data() + 4, &compressedSize, xml.data(), static_cast<uLong>(xml.size()), Z_DEFAULT_COMPRESSION);
+		compressed.resize(4 + compressedSize);
+
+		return compressed;
+	}
+
+	std::string CSyntheticVault::MakeNote(std::mt19937& generator) const
+	{
+		static constexpr char charset[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ 0123456789 .,;:-";
+
+		size_t size = m_config.noteSize;
+		switch (m_config.distribution)
+		{
+		case ESizeDistribution::Uniform:
+			size = std::uniform_int_distribution<size_t>(0, 2 * m_config.noteSize)(generator);
+			break;
+
+		case ESizeDistribution::Exponential:
+			size = static_cast<size_t>(std::exponential_distribution<double>(1.0 / std::max<size_t>(m_config.noteSize, 1))(generator));
+			break;
+
+		default:
+			break;
+		}
+
+		std::uniform_int_distribution<size_t> character(0, sizeof(charset) - 2);
+
+		std::string note(size, ' ');
+		for (char& c : note)
+			c = charset[character(generator)];
+
+		return note;
+	}
+
+	bool CSyntheticVault::MakeTransaction(size_t index, std::mt19937& generator, SRawTransactionBackupEdit& transaction)
+	{
+		transaction.identifier = std::format("{{BENCH-{:08}}}", index);
+		transaction.type = "AUTHENTIFIANT";
+		transaction.backupDate = m_revision;
+
+		return Encrypt(Compress(MakeItemXml(index, MakeNote(generator))), transaction.content);
+	}
+
+	bool CSyntheticVault::Encrypt(const std::vector<uint8_t>& compressed, std::string& content)
+	{
+		if (m_config.derivation == EEnvelopeDerivation::None)
+			return EncryptAndSerialize(m_context, compressed, content) == EDashlaneError::NoError;
+
+		CEncryption encryption;
+		SEncryptedData encryptedData;
+		if (!encryption.EncryptData(m_derivedKey, compressed, encryptedData))
+			return false;
+
+		encryptedData.keyDerivation = MakeDerivationConfig(m_config.derivation);
+		encryptedData.cipherData.salt.assign(m_salt.begin(), m_salt.end());
+
+		std::vector<uint8_t> serialized;
+		CSerializer::DoSerialize(serialized, encryptedData);
+		content = base64pp::encode(serialized);
+
+		return true;
+	}
+
+}
\ No newline at end of file
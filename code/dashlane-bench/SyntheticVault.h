@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Dashlane.h>
+
+#include <random>
+
+namespace Dashlane
+{
+
+	// Key derivation used for the item envelopes, matches the envelopes found in real vaults
+	enum class EEnvelopeDerivation
+	{
+		None,		// Local key, as stored in the local database after a sync
+		Argon2,		// Master password, Argon2d (server transactions)
+		Pbkdf2		// Master password, PBKDF2 (legacy server transactions)
+	};
+
+	enum class ESizeDistribution
+	{
+		Fixed,		// Every note has noteSize characters
+		Uniform,	// Uniform in [0, 2 * noteSize]
+		Exponential	// Mostly small notes with a long tail, mean of noteSize
+	};
+
+	struct SSyntheticVaultConfig
+	{
+		size_t itemCount{ 1000 };
+		size_t noteSize{ 64 };
+		ESizeDistribution distribution{ ESizeDistribution::Exponential };
+		EEnvelopeDerivation derivation{ EEnvelopeDerivation::None };
+		uint32_t seed{ 1 };
+	};
+
+	// Edit made to the vault by another device, in a single later revision
+	struct SVaultChanges
+	{
+		size_t changedCount{ 0 };	// First items, with a new note
+		size_t addedCount{ 0 };		// New items appended to the vault
+		size_t removedCount{ 0 };	// Last items, served as BACKUP_REMOVE transactions
+	};
+
+	// Generates a vault of authentifiant transactions, each item goes through the same
+	// XML / compression / envelope encoding as the items stored by a real synchronization
+	class CSyntheticVault
+	{
+
+	public:
+
+		static constexpr char login[] = "bench@dashlane.local";
+		static constexpr char masterPassword[] = "correct horse battery staple";
+
+		CSyntheticVault(const SSyntheticVaultConfig& config);
+		CSyntheticVault(const CSyntheticVault&) = delete;
+
+		// Context able to decrypt the vault (local key and master password assigned)
+		DashlaneContextInternal& GetContext() { return m_context; }
+
+		const std::vector<SRawTransactionBackupEdit>& GetTransactions() const { return m_transactions; }
+		const std::vector<SRawTransactionBackupRemove>& GetRemovals() const { return m_removals; }
+
+		// Applies the changes with a backupDate after every item of the vault, false if they do not fit in it
+		bool ApplyChanges(const SVaultChanges& changes);
+
+		// Intermediate representations of a single item, for the per-stage benchmarks
+		static std::vector<uint8_t> MakeItemXml(size_t index, const std::string& note);
+		static std::vector<uint8_t> Compress(const std::vector<uint8_t>& xml);
+
+	protected:
+
+		std::string MakeNote(std::mt19937& generator) const;
+		bool MakeTransaction(size_t index, std::mt19937& generator, SRawTransactionBackupEdit& transaction);
+		bool Encrypt(const std::vector<uint8_t>& compressed, std::string& content);
+
+	private:
+
+		const SSyntheticVaultConfig m_config;
+		DashlaneContextInternal m_context;
+		std::vector<SRawTransactionBackupEdit> m_transactions;
+		std::vector<SRawTransactionBackupRemove> m_removals;
+		uint32_t m_revision{ 1700000000 };
+		size_t m_nextIndex{ 0 };
+
+		std::vector<uint8_t> m_salt;
+		Utility::SecureBuffer m_derivedKey;
+
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <Application.h>
+#include "Command.h"
+#include "Common.h"
+
+#include <nlohmann/json.hpp>
+
+#include <deque>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		struct SBatchQuery
+		{
+			nlohmann::ordered_json id;
+			uint32_t types{ (uint32_t)ETransactionType::Authentifiant };
+			std::map<std::string, std::string> filters;
+			std::vector<std::string> jsonData;
+		};
+
+		// One request per line: {"id": <any>, "types": <mask>, "filters": {"<param>": "<value>"}}, all fields optional
+		std::vector<SBatchQuery> ReadBatchQueries(std::istream& input)
+		{
+			std::vector<SBatchQuery> queries;
+
+			std::string line;
+			for (size_t lineNumber = 1; std::getline(input, line); ++lineNumber)
+			{
+				if (line.find_first_not_of(" \t\r") == std::string::npos)
+					continue;
+
+				const nlohmann::ordered_json request = nlohmann::ordered_json::parse(line, nullptr, false);
+				if (request.is_discarded() || !request.is_object())
+					throw std::runtime_error(std::format("Invalid batch request on line {}", lineNumber));
+
+				SBatchQuery& query = queries.emplace_back();
+				query.id = request.value("id", nlohmann::ordered_json(queries.size() - 1));
+				query.types = request.value("types", query.types);
+
+				if (const auto it = request.find("filters"); it != request.end())
+				{
+					if (!it->is_object())
+						throw std::runtime_error(std::format("Invalid filters on line {}", lineNumber));
+
+					for (const auto& [name, wildcard] : it->items())
+					{
+						if (!wildcard.is_string())
+							throw std::runtime_error(std::format("Invalid filter '{}' on line {}", name, lineNumber));
+
+						query.filters[name] = wildcard.get<std::string>();
+					}
+				}
+			}
+
+			return queries;
+		}
+
+		CLI::App* BatchCommand(CLI::App* pApp)
+		{
+			// Stdin carries the queries, it cannot be used to prompt for the login
+			if (HeadlessParameters::s_email.empty())
+				throw std::runtime_error("Batch mode requires the login to be provided with --email");
+
+			std::vector<SBatchQuery> queries = ReadBatchQueries(std::cin);
+			if (queries.empty())
+				return nullptr;
+
+			const std::string login = GetUserInput(EUserInputType::Login);
+
+			CDashlaneContextWrapper dctx;
+			ThrowOnError(dctx.Init(applicationName, login.c_str(), szAppAccessKey, szAppSecretKey));
+
+			std::deque<CQueryContextWrapper> queryContexts;
+			std::vector<DashlaneQueryContext*> pQueryContexts;
+			for (SBatchQuery& query : queries)
+			{
+				CQueryContextWrapper& qctx = queryContexts.emplace_back();
+				ThrowOnError(qctx.Init());
+				ThrowOnError(Dash_AddQueryTransactionTypes(qctx.Get(), query.types));
+
+				for (const auto& filter : query.filters)
+					ThrowOnError(Dash_AddQueryFilter(qctx.Get(), filter.first.c_str(), filter.second.c_str()));
+
+				ThrowOnError(Dash_SetQueryWriter(qctx.Get(), WriteQueryJson<decltype(query.jsonData)>, &query.jsonData));
+				pQueryContexts.emplace_back(qctx.Get());
+			}
+
+			const uint32_t count = (uint32_t)pQueryContexts.size();
+
+			// Nothing can be prompted for, only the headless master password is supported (device must already be registered)
+			EDashlaneError rc = (EDashlaneError)Dash_QueryTransactionsBatch(dctx.Get(), pQueryContexts.data(), count);
+			if (rc == EDashlaneError::RequireMasterPassword && !HeadlessParameters::s_masterPassword.empty())
+			{
+				ThrowOnError(Dash_AssignMasterPassword(dctx.Get(), HeadlessParameters::s_masterPassword.c_str()));
+
+				for (SBatchQuery& query : queries)
+					query.jsonData.clear();
+
+				rc = (EDashlaneError)Dash_QueryTransactionsBatch(dctx.Get(), pQueryContexts.data(), count);
+			}
+
+			ThrowOnError(rc);
+
+			// One result per line, in request order
+			for (const SBatchQuery& query : queries)
+				std::cout << std::format("{{\"id\":{},\"items\":[{}]}}", query.id.dump(), strutil::join(query.jsonData, ",")) << '\n';
+
+			std::cout.flush();
+
+			return nullptr;
+		}
+
+		void AdditionalRegistrator(CLI::App* pCommand)
+		{
+			pCommand->alias("b");
+		}
+
+		static auto _ = COMMAND(
+			"batch",
+			"Resolve many queries in one invocation, reads one JSON query per line from stdin and writes one JSON result per line",
+			&BatchCommand,
+			&AdditionalRegistrator
+		);
+
+	}
+
+}
\ No newline at end of file
@@ -1,107 +1,153 @@
-#pragma once
-
-#include <CoreConfig.h>
-#include <Utility/DashlaneContext.h>
-#include <Utility/UserInput.h>
-
-#include <strutil.h>
-
-namespace Dashlane
-{
-
-	inline bool HandleReturnCode(CDashlaneContextWrapper& dctx, EDashlaneError rc)
-	{
-		switch (rc)
-		{
-		case EDashlaneError::RequireMasterPassword:
-		{
-			do
-			{
-				std::string masterPassword = GetUserInput(EUserInputType::MasterPassword);
-				rc = (EDashlaneError)Dash_AssignMasterPassword(dctx.Get(), masterPassword.c_str());
-			} while (rc != EDashlaneError::NoError);
-		} break;
-
-		case EDashlaneError::RequireEmailToken:
-		{
-			do
-			{
-				std::string emailToken = GetUserInput(EUserInputType::EmailToken);
-				rc = (EDashlaneError)Dash_AssignEmailToken(dctx.Get(), emailToken.c_str());
-			} while (rc != EDashlaneError::NoError);
-		} break;
-
-		case EDashlaneError::Require2FACode:
-		{
-			do
-			{
-				std::string otpCode = GetUserInput(EUserInputType::OTPCode);
-				rc = (EDashlaneError)Dash_Assign2FACode(dctx.Get(), otpCode.c_str());
-			} while (rc != EDashlaneError::NoError);
-		} break;
-
-		case EDashlaneError::InvalidMasterPassword:
-		{
-			std::cerr << "Master password is not valid" << std::endl;
-		} break;
-
-		case EDashlaneError::InvalidEmailToken:
-		{
-			std::cerr << "Email token is not valid" << std::endl;
-		} break;
-
-		case EDashlaneError::Invalid2FACode:
-		{
-			std::cerr << "2FA Code is not valid" << std::endl;
-		} break;
-
-		case EDashlaneError::NoError:
-			return false;
-
-		default:
-			std::cerr << Dash_GetErrorMessage((uint32_t)rc) << std::endl;
-			return false;
-		}
-
-		return true;
-	}
-
-	template <typename T>
-		requires std::is_same_v<T, EDashlaneError> || std::is_same_v<T, uint32_t>
-	inline void ThrowOnError(const T rc)
-	{
-		if ((EDashlaneError)rc != EDashlaneError::NoError)
-		{
-			std::cerr << Dash_GetErrorMessage((uint32_t)rc) << std::endl;
-			throw CLI::RuntimeError((int)rc);
-		}
-	}
-
-	inline std::map<std::string, std::string> ParseFilters(std::vector<std::string>& filters)
-	{
-		std::map<std::string, std::string> map;
-
-		for (auto filter : filters)
-		{
-			auto split = strutil::split(filter, '=');
-			if (split.size() == 2)
-			{
-				map[split[0]] = split[1];
-			}
-			else if (split.size() == 1)
-			{
-				map[split[0]] = "";
-			}
-		}
-
-		return map;
-	}
-
-	template<typename T>
-	inline void WriteQueryJson(void* pUserPointer, const char* json, uint32_t size)
-	{
-		T& buffer = *reinterpret_cast<T*>(pUserPointer);
-		buffer.emplace_back(json);
-	}
-
+#pragma once
+
+#include <CoreConfig.h>
+#include <Utility/DaemonSocket.h>
+#include <Utility/DashlaneContext.h>
+#include <Utility/UserInput.h>
+
+#include <nlohmann/json.hpp>
+#include <strutil.h>
+
+namespace Dashlane
+{
+
+	inline bool HandleReturnCode(CDashlaneContextWrapper& dctx, EDashlaneError rc)
+	{
+		switch (rc)
+		{
+		case EDashlaneError::RequireMasterPassword:
+		{
+			do
+			{
+				std::string masterPassword = GetUserInput(EUserInputType::MasterPassword);
+				rc = (EDashlaneError)Dash_AssignMasterPassword(dctx.Get(), masterPassword.c_str());
+			} while (rc != EDashlaneError::NoError);
+		} break;
+
+		case EDashlaneError::RequireEmailToken:
+		{
+			do
+			{
+				std::string emailToken = GetUserInput(EUserInputType::EmailToken);
+				rc = (EDashlaneError)Dash_AssignEmailToken(dctx.Get(), emailToken.c_str());
+			} while (rc != EDashlaneError::NoError);
+		} break;
+
+		case EDashlaneError::Require2FACode:
+		{
+			do
+			{
+				std::string otpCode = GetUserInput(EUserInputType::OTPCode);
+				rc = (EDashlaneError)Dash_Assign2FACode(dctx.Get(), otpCode.c_str());
+			} while (rc != EDashlaneError::NoError);
+		} break;
+
+		case EDashlaneError::InvalidMasterPassword:
+		{
+			std::cerr << "Master password is not valid" << std::endl;
+		} break;
+
+		case EDashlaneError::InvalidEmailToken:
+		{
+			std::cerr << "Email token is not valid" << std::endl;
+		} break;
+
+		case EDashlaneError::Invalid2FACode:
+		{
+			std::cerr << "2FA Code is not valid" << std::endl;
+		} break;
+
+		case EDashlaneError::NoError:
+			return false;
+
+		default:
+			std::cerr << Dash_GetErrorMessage((uint32_t)rc) << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	template <typename T>
+		requires std::is_same_v<T, EDashlaneError> || std::is_same_v<T, uint32_t>
+	inline void ThrowOnError(const T rc)
+	{
+		if ((EDashlaneError)rc != EDashlaneError::NoError)
+		{
+			std::cerr << Dash_GetErrorMessage((uint32_t)rc) << std::endl;
+			throw CLI::RuntimeError((int)rc);
+		}
+	}
+
+	inline std::map<std::string, std::string> ParseFilters(std::vector<std::string>& filters)
+	{
+		std::map<std::string, std::string> map;
+
+		for (auto filter : filters)
+		{
+			auto split = strutil::split(filter, '=');
+			if (split.size() == 2)
+			{
+				map[split[0]] = split[1];
+			}
+			else if (split.size() == 1)
+			{
+				map[split[0]] = "";
+			}
+		}
+
+		return map;
+	}
+
+	template<typename T>
+	inline void WriteQueryJson(void* pUserPointer, const char* json, uint32_t size)
+	{
+		T& buffer = *reinterpret_cast<T*>(pUserPointer);
+		buffer.emplace_back(json, size);
+	}
+
+	// Sends the request to the daemon if one is serving this account, returns false to fall back to the local vault
+	inline bool SendDaemonItemsRequest(nlohmann::ordered_json& request, std::vector<std::string>& jsonData, EDashlaneError& rc)
+	{
+		if (!HeadlessParameters::s_email.empty())
+			request["login"] = HeadlessParameters::s_email;
+
+		std::string line;
+		if (!SendDaemonRequest(request.dump(), line))
+			return false;
+
+		// Ordered to keep the item fields in vault order
+		const nlohmann::ordered_json response = nlohmann::ordered_json::parse(line, nullptr, false);
+		if (response.is_discarded() || !response.is_object())
+			return false;
+
+		rc = (EDashlaneError)response.value("status", (uint32_t)EDashlaneError::InvalidParameter);
+
+		// Another account, or the daemon needs input it cannot prompt for
+		if (rc == EDashlaneError::InvalidContext || (rc >= EDashlaneError::RequireMasterPassword && rc < EDashlaneError::InvalidContext))
+			return false;
+
+		if (const auto it = response.find("items"); it != response.end() && it->is_array())
+		{
+			for (const auto& item : *it)
+				jsonData.emplace_back(item.dump());
+		}
+
+		return true;
+	}
+
+	// Runs the query on the daemon if one is serving this account, returns false to fall back to an in-process query
+	inline bool QueryDaemon(uint32_t types, const std::map<std::string, std::string>& filters, std::vector<std::string>& jsonData, EDashlaneError& rc)
+	{
+		nlohmann::ordered_json request = { { "command", "query" }, { "types", types }, { "filters", filters } };
+		return SendDaemonItemsRequest(request, jsonData, rc);
+	}
+
+	// Reads a single item by identifier from the daemon, same fallback as QueryDaemon
+	inline bool GetDaemonItem(const std::string& identifier, std::vector<std::string>& jsonData, EDashlaneError& rc)
+	{
+		nlohmann::ordered_json request = { { "command", "get" }, { "identifier", identifier } };
+		return SendDaemonItemsRequest(request, jsonData, rc);
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+#include <Application.h>
+#include "Command.h"
+#include "Common.h"
+
+#include <Utility/DaemonSocket.h>
+
+#include <nlohmann/json.hpp>
+
+#ifndef WINDOWS
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#ifdef LINUX
+#include <sys/prctl.h>
+#endif
+#endif
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		static uint32_t s_idleTimeout = 900;
+		static bool s_stop = false;
+
+#ifndef WINDOWS
+
+		static volatile std::sig_atomic_t s_stopRequested = 0;
+
+		void HandleStopSignal(int)
+		{
+			s_stopRequested = 1;
+		}
+
+		// Keeps the unlocked vault out of swap, core dumps and ptrace
+		void HardenProcessMemory()
+		{
+			const rlimit noCoreDump{ 0, 0 };
+			setrlimit(RLIMIT_CORE, &noCoreDump);
+
+#ifdef LINUX
+			prctl(PR_SET_DUMPABLE, 0, 0, 0, 0);
+#endif
+
+			// Under a finite RLIMIT_MEMLOCK, locking future mappings makes later allocations (sync thread stacks, curl
+			// buffers) fail with ENOMEM once the limit is reached. Key material and plaintexts are kept in the locked secure
+			// pool either way, the whole process is only locked when the limit can be lifted
+			rlimit memlockLimit{};
+			if (getrlimit(RLIMIT_MEMLOCK, &memlockLimit) != 0)
+				return;
+
+			if (memlockLimit.rlim_cur != RLIM_INFINITY && memlockLimit.rlim_max == RLIM_INFINITY)
+			{
+				memlockLimit.rlim_cur = RLIM_INFINITY;
+				if (setrlimit(RLIMIT_MEMLOCK, &memlockLimit) != 0)
+					return;
+			}
+
+			if (memlockLimit.rlim_cur != RLIM_INFINITY)
+				return;
+
+			if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+				std::cerr << "Warning: failed to lock daemon memory (" << std::strerror(errno) << "), only secrets are kept out of swap" << std::endl;
+		}
+
+		std::string MakeDaemonError(EDashlaneError rc)
+		{
+			return nlohmann::ordered_json{ { "status", (uint32_t)rc }, { "error", Dash_GetErrorMessage((uint32_t)rc) } }.dump();
+		}
+
+		std::string ServeQuery(CDashlaneContextWrapper& dctx, const nlohmann::json& request)
+		{
+			CQueryContextWrapper qctx;
+			EDashlaneError rc = qctx.Init();
+			if (rc != EDashlaneError::NoError)
+				return MakeDaemonError(rc);
+
+			rc = (EDashlaneError)Dash_AddQueryTransactionTypes(qctx.Get(), request.value("types", (uint32_t)ETransactionType::Authentifiant));
+			if (rc != EDashlaneError::NoError)
+				return MakeDaemonError(rc);
+
+			if (const auto it = request.find("filters"); it != request.end() && it->is_object())
+			{
+				for (const auto& [name, wildcard] : it->items())
+				{
+					if (!wildcard.is_string())
+						return MakeDaemonError(EDashlaneError::InvalidParameter);
+
+					rc = (EDashlaneError)Dash_AddQueryFilter(qctx.Get(), name.c_str(), wildcard.get_ref<const std::string&>().c_str());
+					if (rc != EDashlaneError::NoError)
+						return MakeDaemonError(rc);
+				}
+			}
+
+			std::vector<std::string> jsonData;
+			Dash_SetQueryWriter(qctx.Get(), WriteQueryJson<decltype(jsonData)>, &jsonData);
+
+			rc = (EDashlaneError)Dash_QueryTransactions(dctx.Get(), qctx.Get());
+			if (rc != EDashlaneError::NoError)
+				return MakeDaemonError(rc);
+
+			// Items are already serialized JSON objects
+			return std::format("{{\"status\":0,\"items\":[{}]}}", strutil::join(jsonData, ","));
+		}
+
+		std::string ServeGet(CDashlaneContextWrapper& dctx, const nlohmann::json& request)
+		{
+			const auto it = request.find("identifier");
+			if (it == request.end() || !it->is_string())
+				return MakeDaemonError(EDashlaneError::InvalidParameter);
+
+			std::vector<std::string> jsonData;
+			const EDashlaneError rc = (EDashlaneError)Dash_GetTransactionById(dctx.Get(), it->get_ref<const std::string&>().c_str(),
+				WriteQueryJson<decltype(jsonData)>, &jsonData);
+			if (rc != EDashlaneError::NoError)
+				return MakeDaemonError(rc);
+
+			return std::format("{{\"status\":0,\"items\":[{}]}}", strutil::join(jsonData, ","));
+		}
+
+		std::string HandleDaemonRequest(CDashlaneContextWrapper& dctx, const std::string& login, const std::string& line, bool& stop)
+		{
+			const nlohmann::json request = nlohmann::json::parse(line, nullptr, false);
+			if (request.is_discarded() || !request.is_object())
+				return MakeDaemonError(EDashlaneError::InvalidParameter);
+
+			// The daemon serves a single account, clients for other accounts fall back to in-process queries
+			if (const auto it = request.find("login"); it != request.end() && (!it->is_string() || it->get_ref<const std::string&>() != login))
+				return MakeDaemonError(EDashlaneError::InvalidContext);
+
+			const std::string command = request.value("command", "");
+			if (command == "query")
+				return ServeQuery(dctx, request);
+
+			if (command == "get")
+				return ServeGet(dctx, request);
+
+			if (command == "ping")
+				return R"({"status":0})";
+
+			if (command == "stop")
+			{
+				stop = true;
+				return R"({"status":0})";
+			}
+
+			return MakeDaemonError(EDashlaneError::InvalidParameter);
+		}
+
+		void ServeDaemon(CDashlaneContextWrapper& dctx, const std::string& login, const std::filesystem::path& socketPath)
+		{
+			sockaddr_un address;
+			if (!FillSocketAddress(socketPath, address))
+				throw std::runtime_error("Daemon socket path is too long");
+
+			// Stale socket from a daemon that did not shut down cleanly
+			unlink(socketPath.c_str());
+
+			const int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (listenFd < 0)
+				throw std::runtime_error(std::format("Failed to create daemon socket ({})", std::strerror(errno)));
+
+			const mode_t previousMask = umask(0177);
+			const bool bound = bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+			umask(previousMask);
+
+			if (!bound || chmod(socketPath.c_str(), 0600) != 0 || listen(listenFd, 16) != 0)
+			{
+				const std::string error = std::strerror(errno);
+				close(listenFd);
+				unlink(socketPath.c_str());
+				throw std::runtime_error(std::format("Failed to listen on {} ({})", socketPath.string(), error));
+			}
+
+			struct sigaction stopAction {};
+			stopAction.sa_handler = HandleStopSignal;
+			sigemptyset(&stopAction.sa_mask);
+			sigaction(SIGINT, &stopAction, nullptr);
+			sigaction(SIGTERM, &stopAction, nullptr);
+			std::signal(SIGPIPE, SIG_IGN);
+
+			std::cout << "Daemon listening on " << socketPath.string() << std::endl;
+
+			const auto idleTimeout = std::chrono::seconds(s_idleTimeout);
+			auto lastActivity = std::chrono::steady_clock::now();
+
+			while (s_stopRequested == 0)
+			{
+				int timeoutMs = -1;
+				if (s_idleTimeout > 0)
+				{
+					const auto remaining = idleTimeout - (std::chrono::steady_clock::now() - lastActivity);
+					if (remaining <= std::chrono::steady_clock::duration::zero())
+						break;
+
+					timeoutMs = (int)std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+				}
+
+				pollfd pfd{ listenFd, POLLIN, 0 };
+				if (poll(&pfd, 1, timeoutMs) <= 0)
+					continue;
+
+				const int clientFd = accept(listenFd, nullptr, nullptr);
+				if (clientFd < 0)
+					continue;
+
+				lastActivity = std::chrono::steady_clock::now();
+
+				std::string line;
+				if (IsPeerCurrentUser(clientFd) && ReadSocketLine(clientFd, line, 5000))
+				{
+					bool stop = false;
+					WriteSocketLine(clientFd, HandleDaemonRequest(dctx, login, line, stop));
+					if (stop)
+						s_stopRequested = 1;
+				}
+
+				close(clientFd);
+			}
+
+			close(listenFd);
+			unlink(socketPath.c_str());
+
+			std::cout << "Daemon stopped" << std::endl;
+		}
+
+#endif
+
+		CLI::App* DaemonCommand(CLI::App* pApp)
+		{
+#ifdef WINDOWS
+			throw std::runtime_error("The daemon is not supported on Windows");
+#else
+			const std::filesystem::path socketPath = GetDaemonSocketPath();
+			if (socketPath.empty())
+				throw std::runtime_error("Cannot create a private directory for the daemon socket");
+
+			std::string response;
+			if (s_stop)
+			{
+				if (!SendDaemonRequest(R"({"command":"stop"})", response, 5000))
+					throw std::runtime_error("No daemon is running");
+
+				std::cout << "Stopped daemon" << std::endl;
+				return nullptr;
+			}
+
+			if (SendDaemonRequest(R"({"command":"ping"})", response, 1000))
+				throw std::runtime_error("A daemon is already running");
+
+			const std::string login = GetUserInput(EUserInputType::Login);
+
+			// Before any secret is loaded
+			HardenProcessMemory();
+
+			CDashlaneContextWrapper dctx;
+			ThrowOnError(dctx.Init(applicationName, login.c_str(), szAppAccessKey, szAppSecretKey));
+
+			// Unlock once (prompting if needed) and decrypt the vault to warm the key caches
+			{
+				CQueryContextWrapper qctx;
+				ThrowOnError(qctx.Init());
+				ThrowOnError(Dash_AddQueryTransactionTypes(qctx.Get(), (uint32_t)ETransactionType::Authentifiant));
+				ThrowOnError(Dash_SetQueryWriter(qctx.Get(), [](void*, const char*, uint32_t) {}));
+
+				EDashlaneError rc = EDashlaneError::NoError;
+				while (true)
+				{
+					rc = (EDashlaneError)Dash_QueryTransactions(dctx.Get(), qctx.Get());
+					if (!HandleReturnCode(dctx, rc))
+						break;
+				};
+
+				ThrowOnError(rc);
+			}
+
+			ServeDaemon(dctx, login, socketPath);
+
+			return nullptr;
+#endif
+		}
+
+		void AdditionalRegistrator(CLI::App* pCommand)
+		{
+			pCommand->add_option("--idle-timeout", s_idleTimeout, "Seconds without requests before the daemon exits, 0 to never exit")
+				->default_val(900);
+
+			pCommand->add_flag("--stop", s_stop, "Stop the running daemon");
+		}
+
+		static auto _ = COMMAND(
+			"daemon",
+			"Keep the vault unlocked in memory and serve queries from other invocations over a private socket",
+			&DaemonCommand,
+			&AdditionalRegistrator
+		);
+
+	}
+
+}
\ No newline at end of file
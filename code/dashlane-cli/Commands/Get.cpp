@@ -0,0 +1,90 @@
+#include <Application.h>
+#include "Command.h"
+#include "Common.h"
+
+#include <nlohmann/json.hpp>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		static auto s_pIdentifier = std::make_shared<std::string>();
+		static auto s_pField = std::make_shared<std::string>();
+
+		EDashlaneError GetLocalItem(const std::string& identifier, std::vector<std::string>& jsonData)
+		{
+			const std::string login = GetUserInput(EUserInputType::Login);
+
+			CDashlaneContextWrapper dctx;
+			ThrowOnError(dctx.Init(applicationName, login.c_str(), szAppAccessKey, szAppSecretKey));
+
+			EDashlaneError rc = EDashlaneError::NoError;
+			while (true)
+			{
+				rc = (EDashlaneError)Dash_GetTransactionById(dctx.Get(), identifier.c_str(), WriteQueryJson<std::vector<std::string>>, &jsonData);
+				if (!HandleReturnCode(dctx, rc))
+					break;
+			};
+
+			return rc;
+		}
+
+		CLI::App* GetCommand(CLI::App* pApp)
+		{
+			std::vector<std::string> jsonData;
+			EDashlaneError rc = EDashlaneError::NoError;
+
+			// A running daemon answers without unlocking the vault again
+			if (!GetDaemonItem(*s_pIdentifier, jsonData, rc))
+			{
+				jsonData.clear();
+				rc = GetLocalItem(*s_pIdentifier, jsonData);
+			}
+
+			ThrowOnError(rc);
+
+			if (jsonData.empty())
+				return nullptr;
+
+			if (s_pField->empty())
+			{
+				std::cout << jsonData[0] << std::endl;
+				return nullptr;
+			}
+
+			const nlohmann::ordered_json json = nlohmann::ordered_json::parse(jsonData[0]);
+			const auto it = json.find(*s_pField);
+			if (it == json.end())
+			{
+				std::cerr << "The item has no field " << *s_pField << std::endl;
+				throw CLI::RuntimeError((int)EDashlaneError::InvalidParameter);
+			}
+
+			std::cout << it->get<std::string>() << std::endl;
+
+			return nullptr;
+		}
+
+		void AdditionalRegistrator(CLI::App* pCommand)
+		{
+			pCommand->alias("g");
+
+			// Options
+			pCommand->add_option("--field", *s_pField, "Only print this field of the item, e.g. `Password`");
+
+			pCommand->add_option("identifier", *s_pIdentifier, "Identifier of the item (its `Id` field)")
+				->required();
+		}
+
+		static auto _ = COMMAND(
+			"get",
+			"Retrieve a single item of the local vault by its identifier",
+			&GetCommand,
+			&AdditionalRegistrator
+		);
+
+	}
+
+}
\ No newline at end of file
@@ -1,24 +1,24 @@
-#include "Command.h"
-#include <License-Gen.h>
-
-namespace Dashlane
-{
-
-	namespace
-	{
-
-		CLI::App* LicenseCommand(CLI::App* pApp)
-		{
-			std::cout << g_licenseText;
-			return nullptr;
-		}
-
-		static auto _ = COMMAND(
-			"license",
-			"Output the licenses associated with this application",
-			&LicenseCommand
-		);
-
-	}
-
+#include "Command.h"
+#include <License-Gen.h>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		CLI::App* LicenseCommand(CLI::App* pApp)
+		{
+			std::cout << g_licenseText;
+			return nullptr;
+		}
+
+		static auto _ = COMMAND(
+			"license",
+			"Output the licenses associated with this application",
+			&LicenseCommand
+		);
+
+	}
+
 }
\ No newline at end of file
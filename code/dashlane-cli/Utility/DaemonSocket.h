@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#ifndef WINDOWS
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace Dashlane
+{
+
+	// Requests and responses are single JSON lines, anything longer is rejected
+	static constexpr size_t daemonMaxMessageSize = 64 * 1024;
+
+#ifndef WINDOWS
+
+	// Private per-user directory holding the daemon socket, created with 0700 if missing.
+	// Returns an empty path if the directory exists but is not owned by us or is accessible by others.
+	inline std::filesystem::path GetDaemonDirectory()
+	{
+		std::filesystem::path directory;
+		if (const char* szRuntimeDir = std::getenv("XDG_RUNTIME_DIR"); szRuntimeDir != nullptr && szRuntimeDir[0] != '\0')
+			directory = std::filesystem::path(szRuntimeDir) / "dccli";
+		else
+			directory = std::filesystem::temp_directory_path() / std::format("dccli-{}", getuid());
+
+		if (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST)
+			return {};
+
+		struct stat info {};
+		if (lstat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != getuid() || (info.st_mode & 0077) != 0)
+			return {};
+
+		return directory;
+	}
+
+	inline std::filesystem::path GetDaemonSocketPath()
+	{
+		const std::filesystem::path directory = GetDaemonDirectory();
+		return directory.empty() ? directory : directory / "daemon.sock";
+	}
+
+	inline bool FillSocketAddress(const std::filesystem::path& path, sockaddr_un& address)
+	{
+		address = {};
+		address.sun_family = AF_UNIX;
+
+		const std::string native = path.string();
+		if (native.empty() || native.size() >= sizeof(address.sun_path))
+			return false;
+
+		std::memcpy(address.sun_path, native.c_str(), native.size() + 1);
+		return true;
+	}
+
+	inline bool IsPeerCurrentUser(int fd)
+	{
+#if defined(LINUX)
+		struct ucred credentials {};
+		socklen_t length = sizeof(credentials);
+		if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0)
+			return false;
+		return credentials.uid == getuid();
+#else
+		uid_t uid = 0;
+		gid_t gid = 0;
+		if (getpeereid(fd, &uid, &gid) != 0)
+			return false;
+		return uid == getuid();
+#endif
+	}
+
+	inline bool WriteSocketLine(int fd, const std::string& message)
+	{
+#ifdef MSG_NOSIGNAL
+		constexpr int flags = MSG_NOSIGNAL;
+#else
+		constexpr int flags = 0;
+#endif
+
+		std::string line = message;
+		line.push_back('\n');
+
+		size_t written = 0;
+		while (written < line.size())
+		{
+			const ssize_t count = send(fd, line.data() + written, line.size() - written, flags);
+			if (count < 0 && errno == EINTR)
+				continue;
+			if (count <= 0)
+				return false;
+			written += static_cast<size_t>(count);
+		}
+
+		return true;
+	}
+
+	inline bool ReadSocketLine(int fd, std::string& message, int timeoutMs)
+	{
+		message.clear();
+
+		char buffer[4096];
+		while (message.size() < daemonMaxMessageSize)
+		{
+			pollfd pfd{ fd, POLLIN, 0 };
+			const int ready = poll(&pfd, 1, timeoutMs);
+			if (ready < 0 && errno == EINTR)
+				continue;
+			if (ready <= 0)
+				return false;
+
+			const ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+			if (count < 0 && errno == EINTR)
+				continue;
+			if (count <= 0)
+				return false;
+
+			message.append(buffer, static_cast<size_t>(count));
+			if (const size_t end = message.find('\n'); end != std::string::npos)
+			{
+				message.resize(end);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Sends a single request to the running daemon, returns false if no daemon is reachable
+	inline bool SendDaemonRequest(const std::string& request, std::string& response, int timeoutMs = 60000)
+	{
+		sockaddr_un address;
+		if (!FillSocketAddress(GetDaemonSocketPath(), address))
+			return false;
+
+		const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return false;
+
+		bool success = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0
+			&& IsPeerCurrentUser(fd)
+			&& WriteSocketLine(fd, request)
+			&& ReadSocketLine(fd, response, timeoutMs);
+
+		close(fd);
+		return success;
+	}
+
+#else
+
+	inline bool SendDaemonRequest(const std::string& request, std::string& response, int timeoutMs = 60000)
+	{
+		return false;
+	}
+
+#endif
+
+}
\ No newline at end of file
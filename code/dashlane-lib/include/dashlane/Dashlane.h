@@ -1,87 +1,255 @@
-#pragma once
-
-#include "API.h"
-#include "Errors.h"
-
-struct DashlaneContext {};
-struct DashlaneQueryContext {};
-
-enum class ETransactionType
-{
-	Unknown,
-	Authentifiant,
-	SecureNote
-};
-
-extern "C"
-{
-	typedef void(*Dash_QueryWriterFunc)(void* pUserPointer, const char* json, uint32_t size);
-
-	// Used to get the human readable error message of an error code returned by one of the library functions
-	DASHLANE_API const char* Dash_GetErrorMessage(uint32_t errorCode);
-
-	// Initialize the Dashlane context used for all operations
-	DASHLANE_API uint32_t Dash_InitContext(DashlaneContext** ppContext,
-		const char* szApplicationName,
-		const char* szLogin,
-		const char* szAppAccessKey,
-		const char* szAppSecretKey);
-
-	// Initialize the Query context used for querying transactions
-	DASHLANE_API uint32_t Dash_InitQueryContext(DashlaneQueryContext** ppQueryContext);
-
-	// Should be called once you are finished with any specific Dashlane context
-	DASHLANE_API void Dash_FreeContext(DashlaneContext* pContext);
-
-	// Should be called once you are finished with any specific Query context
-	DASHLANE_API void Dash_FreeQueryContext(DashlaneQueryContext* pQueryContext);
-
-	// Assigns the Master Password to the provided context
-	DASHLANE_API uint32_t Dash_AssignMasterPassword(DashlaneContext* pContext, const char* szMasterPassword);
-
-	// Assigns the Email Token to the provided context
-	DASHLANE_API uint32_t Dash_AssignEmailToken(DashlaneContext* pContext, const char* szEmailToken);
-
-	// Assigns the 2FA code to the provided context
-	DASHLANE_API uint32_t Dash_Assign2FACode(DashlaneContext* pContext, const char* sz2FACode);
-
-	// Clears the Master Password from the provided context
-	DASHLANE_API void Dash_ClearMasterPassword(DashlaneContext* pContext);
-
-	// Clears the Email Token from the provided context
-	DASHLANE_API void Dash_ClearEmailToken(DashlaneContext* pContext);
-
-	// Clears the 2FA code from the provided context
-	DASHLANE_API void Dash_Clear2FACode(DashlaneContext* pContext);
-
-	// Used with QueryTransactions, types is a 32bit mask of transaction types
-	DASHLANE_API uint32_t Dash_AddQueryTransactionTypes(DashlaneQueryContext* pQueryContext, uint32_t types);
-
-	// Used with QueryTransactions, szName is a field name, and szWildcard is a wildcard string to match against
-	// This is a white-list approach, so only transactions that have the fields and match will be found
-	DASHLANE_API uint32_t Dash_AddQueryFilter(DashlaneQueryContext* pQueryContext, const char* szName, const char* szWildcard);
-
-	// Set the query writer function, must be set before QueryTransactions is called
-	DASHLANE_API uint32_t Dash_SetQueryWriter(DashlaneQueryContext* pQueryContext, Dash_QueryWriterFunc writer, void* pUserPointer = nullptr);
-
-	// After applying filters, try to find matching transactions (Passwords/Secure Notes etc...)
-	DASHLANE_API uint32_t Dash_QueryTransactions(DashlaneContext* pContext, DashlaneQueryContext* pQueryContext);
-
-	// Synchronizing the vault data must be done before querying transactions
-	DASHLANE_API uint32_t Dash_SynchronizeVaultData(DashlaneContext* pContext);
-
-	// Resets/Removes the vault data and any stored keys, and resets the configuration
-	DASHLANE_API uint32_t Dash_ResetVaultData(DashlaneContext* pContext, bool removeAllUsers = false);
-
-	// Set config option for storing the Master Password in the OS keychain
-	DASHLANE_API uint32_t Dash_SetShouldStoreMasterPassword(DashlaneContext* pContext, bool shouldStoreMasterPassword);
-
-	// Get the current config option value for storing the Master Password in the OS keychain
-	DASHLANE_API uint32_t Dash_GetShouldStoreMasterPassword(DashlaneContext* pContext, bool* pShouldStoreMasterPasswordOut);
-
-	// Set config option for automatically synchronizing if the last sync was over an hour ago
-	DASHLANE_API uint32_t Dash_SetAutoSync(DashlaneContext* pContext, bool autoSync);
-
-	// Get the current config option value for automatically synchronizing if the last sync was over an hour ago
-	DASHLANE_API uint32_t Dash_GetAutoSync(DashlaneContext* pContext, bool* pAutoSync);
+#pragma once
+
+#include "API.h"
+#include "Errors.h"
+
+// Threading model
+//
+// Every function may be called from any thread, and calls on different contexts never wait for each other.
+// On the same context, queries (QueryTransactions, QueryTransactionsBatch, the cursor functions, GetTransactionById) run
+// concurrently, each one borrowing a read-only connection to the vault file, and they do not wait for a synchronization
+// writing to the same file. Calls changing the context (Assign*, Clear*, Set*, ResetVaultData) wait for the running
+// queries and hold new ones until they return, as does the unlock a query may start with. SynchronizeVaultData, and
+// the synchronization a query may start with, only do so while resolving the secrets: the delta is fetched and
+// written with the context unlocked.
+// A query context or a cursor must be used by one thread at a time, and a context must not be freed while it is in use.
+// Query writers are called with the context unlocked, they may call any function on it (GetTransactionById included)
+// except freeing the context, the query context or the cursor being written.
+
+// Contexts, query contexts and cursors are opaque handles rather than pointers, they must not be dereferenced.
+// A handle that was freed (or never returned by an Init function) is detected, functions given one return InvalidContext
+struct DashlaneContext {};
+struct DashlaneQueryContext {};
+struct DashlaneQueryCursor {};
+
+// Where the local key protecting the local vault is kept between processes. Without it, opening the local vault
+// derives the key from the master password again
+enum class ESecretStore : uint32_t
+{
+	OSKeychain,		// Keychain of the OS (libsecret over D-Bus on Linux)
+	KernelKeyring,	// Linux user keyring, kept in kernel memory for 8 hours after being stored (Linux only)
+	Memory,			// Memory of the process, for tests
+	EncryptedFile	// File next to the local vault, encrypted with the key set in DASHLANE_SECRET_STORE_KEY (32 characters or more)
+};
+
+enum class ETransactionType
+{
+	Unknown,
+	Authentifiant,
+	SecureNote
+};
+
+// Typed query results, the views point into memory owned by the running query and are only valid during the writer call.
+// Strings are not null-terminated, a field missing from the item is an empty view
+struct DashlaneStringView
+{
+	const char* pData;
+	uint32_t size;
+};
+
+struct DashlaneAuthentifiantView
+{
+	DashlaneStringView title;
+	DashlaneStringView email;
+	DashlaneStringView login;
+	DashlaneStringView password;
+	DashlaneStringView url;
+	DashlaneStringView secondaryLogin;
+	DashlaneStringView category;
+	DashlaneStringView note;
+	DashlaneStringView lastBackupTime;
+	DashlaneStringView otpSecret;
+	DashlaneStringView appMetaData;
+	DashlaneStringView status;
+	DashlaneStringView numberUse;
+	DashlaneStringView lastUse;
+	DashlaneStringView strength;
+	DashlaneStringView modificationDatetime;
+	DashlaneStringView id;
+	DashlaneStringView anonId;
+	DashlaneStringView localeFormat;
+	bool autoProtected;
+	bool autoLogin;
+	bool subdomainOnly;
+	bool useFixedUrl;
+	bool checked;
+};
+
+struct DashlaneSecureNoteView
+{
+	DashlaneStringView title;
+	DashlaneStringView content;
+	DashlaneStringView category;
+	DashlaneStringView type;
+	DashlaneStringView creationDateTime;
+	DashlaneStringView updateDate;
+	DashlaneStringView userModificationDatetime;
+	DashlaneStringView lastBackupTime;
+	DashlaneStringView spaceId;
+	DashlaneStringView localeFormat;
+	DashlaneStringView id;
+	DashlaneStringView anonId;
+	bool secured;
+};
+
+struct DashlaneTransactionView
+{
+	ETransactionType type;
+	const DashlaneAuthentifiantView* pAuthentifiant;	// Set when type is Authentifiant
+	const DashlaneSecureNoteView* pSecureNote;			// Set when type is SecureNote
+};
+
+extern "C"
+{
+	// json is null-terminated, size is its length in bytes (without the terminator)
+	typedef void(*Dash_QueryWriterFunc)(void* pUserPointer, const char* json, uint32_t size);
+	typedef void(*Dash_QueryTypedWriterFunc)(void* pUserPointer, const DashlaneTransactionView* pTransaction);
+	typedef void(*Dash_SyncCompletedFunc)(void* pUserPointer, uint32_t errorCode);
+
+	// Used to get the human readable error message of an error code returned by one of the library functions
+	DASHLANE_API const char* Dash_GetErrorMessage(uint32_t errorCode);
+
+	// Initialize the Dashlane context used for all operations, the local key is kept in the OS keychain
+	// The local vault is not opened until a call needs it, a file that cannot be created is reported then (FailedDatabaseCreation)
+	DASHLANE_API uint32_t Dash_InitContext(DashlaneContext** ppContext,
+		const char* szApplicationName,
+		const char* szLogin,
+		const char* szAppAccessKey,
+		const char* szAppSecretKey);
+
+	// Same as Dash_InitContext, with the local key kept in the given secret store
+	// Fails with KeychainUnavailable when the secret store is not supported on this platform
+	DASHLANE_API uint32_t Dash_InitContextWithSecretStore(DashlaneContext** ppContext,
+		const char* szApplicationName,
+		const char* szLogin,
+		const char* szAppAccessKey,
+		const char* szAppSecretKey,
+		ESecretStore secretStore);
+
+	// Initialize the Query context used for querying transactions
+	DASHLANE_API uint32_t Dash_InitQueryContext(DashlaneQueryContext** ppQueryContext);
+
+	// Should be called once you are finished with any specific Dashlane context. Waits for its background synchronization,
+	// so a call from the completion callback of the context is ignored
+	DASHLANE_API void Dash_FreeContext(DashlaneContext* pContext);
+
+	// Should be called once you are finished with any specific Query context
+	DASHLANE_API void Dash_FreeQueryContext(DashlaneQueryContext* pQueryContext);
+
+	// Assigns the Master Password to the provided context
+	DASHLANE_API uint32_t Dash_AssignMasterPassword(DashlaneContext* pContext, const char* szMasterPassword);
+
+	// Assigns the Email Token to the provided context
+	DASHLANE_API uint32_t Dash_AssignEmailToken(DashlaneContext* pContext, const char* szEmailToken);
+
+	// Assigns the 2FA code to the provided context
+	DASHLANE_API uint32_t Dash_Assign2FACode(DashlaneContext* pContext, const char* sz2FACode);
+
+	// Clears the Master Password from the provided context
+	DASHLANE_API void Dash_ClearMasterPassword(DashlaneContext* pContext);
+
+	// Clears the Email Token from the provided context
+	DASHLANE_API void Dash_ClearEmailToken(DashlaneContext* pContext);
+
+	// Clears the 2FA code from the provided context
+	DASHLANE_API void Dash_Clear2FACode(DashlaneContext* pContext);
+
+	// Used with QueryTransactions, types is a 32bit mask of transaction types
+	DASHLANE_API uint32_t Dash_AddQueryTransactionTypes(DashlaneQueryContext* pQueryContext, uint32_t types);
+
+	// Used with QueryTransactions, szName is a field name, and szWildcard is a wildcard string to match against
+	// This is a white-list approach, so only transactions that have the fields and match will be found
+	DASHLANE_API uint32_t Dash_AddQueryFilter(DashlaneQueryContext* pQueryContext, const char* szName, const char* szWildcard);
+
+	// Set the query writer function, must be set before QueryTransactions is called
+	DASHLANE_API uint32_t Dash_SetQueryWriter(DashlaneQueryContext* pQueryContext, Dash_QueryWriterFunc writer, void* pUserPointer = nullptr);
+
+	// Set a writer receiving each match as a typed view instead of JSON, no JSON is built for this query.
+	// Replaces the query writer, and setting a query writer replaces this one
+	DASHLANE_API uint32_t Dash_SetQueryTypedWriter(DashlaneQueryContext* pQueryContext, Dash_QueryTypedWriterFunc writer, void* pUserPointer = nullptr);
+
+	// After applying filters, try to find matching transactions (Passwords/Secure Notes etc...)
+	DASHLANE_API uint32_t Dash_QueryTransactions(DashlaneContext* pContext, DashlaneQueryContext* pQueryContext);
+
+	// Evaluates several query contexts in a single pass over the vault, each matching transaction is decrypted once
+	// and written to the writer of every query it matches. Queries are evaluated in the order they are provided
+	DASHLANE_API uint32_t Dash_QueryTransactionsBatch(DashlaneContext* pContext, DashlaneQueryContext** ppQueryContexts, uint32_t count);
+
+	// Writes the item with this identifier to the writer, without scanning or decrypting the rest of the vault.
+	// Returns TransactionNotFound when the local vault has no such item
+	DASHLANE_API uint32_t Dash_GetTransactionById(DashlaneContext* pContext, const char* szIdentifier, Dash_QueryWriterFunc writer, void* pUserPointer = nullptr);
+
+	// Opens a cursor pulling the matches of the query one at a time, as an alternative to QueryTransactions.
+	// The vault is read lazily: items are only decrypted as the cursor advances, and no database lock is held between calls.
+	// The cursor is not shared between threads. Once its context or query context is freed, it only returns InvalidContext
+	// and must still be closed
+	DASHLANE_API uint32_t Dash_QueryOpen(DashlaneContext* pContext, DashlaneQueryContext* pQueryContext, DashlaneQueryCursor** ppCursor);
+
+	// Advances to the next match and writes it to the query writer (JSON or typed), pHasResult is false once the vault is exhausted.
+	// After a failure, every call returns the same error
+	DASHLANE_API uint32_t Dash_QueryNext(DashlaneQueryCursor* pCursor, bool* pHasResult);
+
+	// Frees the cursor, which may be closed before it is exhausted. Returns the error of the cursor, if any
+	DASHLANE_API uint32_t Dash_QueryClose(DashlaneQueryCursor* pCursor);
+
+	// Synchronizing the vault data must be done before querying transactions
+	DASHLANE_API uint32_t Dash_SynchronizeVaultData(DashlaneContext* pContext);
+
+	// Set the staleness limits used when querying with auto sync enabled (defaults to 3600 and 0)
+	// A local vault older than staleAfterSeconds is still served immediately while it is synchronized in the background,
+	// only a missing local vault or one older than maxStaleSeconds (0 = no limit) is synchronized before the query returns
+	DASHLANE_API uint32_t Dash_SetSyncPolicy(DashlaneContext* pContext, uint32_t staleAfterSeconds, uint32_t maxStaleSeconds = 0);
+
+	// Store synchronized items as the server sent them instead of recrypting them with the local key (defaults to false)
+	// Items are recrypted by the first query reading them, or by the background worker once its synchronization completes
+	DASHLANE_API uint32_t Dash_SetLazyRecrypt(DashlaneContext* pContext, bool lazyRecrypt);
+
+	// Set the function called (from the worker thread) when a background synchronization completes. No lock of the context
+	// is held during the call: the callback may call any function on the context except FreeContext (ignored), and the functions
+	// waiting for the background synchronization (SynchronizeVaultData, ResetVaultData, WaitForBackgroundSync) do not
+	// wait for the one it reports
+	DASHLANE_API uint32_t Dash_SetSyncCompletedCallback(DashlaneContext* pContext, Dash_SyncCompletedFunc completedFunc, void* pUserPointer = nullptr);
+
+	// Blocks until the background synchronization of the context (if any) completes, FreeContext also waits for it
+	DASHLANE_API uint32_t Dash_WaitForBackgroundSync(DashlaneContext* pContext);
+
+	// Set how long a database access waits for another process holding the vault file locked, and how many read-only
+	// connections queries may use at once (defaults to 5000 and 4). Applies to every context opened on the same vault file
+	DASHLANE_API uint32_t Dash_SetDatabaseOptions(DashlaneContext* pContext, uint32_t busyTimeoutMs, uint32_t maxReaders);
+
+	// Writes the per-stage timings and counters collected by the context (including background synchronizations) as a JSON object:
+	// { "<stage>": { "count": n, "totalUs": t, "maxUs": m } }, the object is empty when the library is built without DASHLANE_ENABLE_STATS
+	DASHLANE_API uint32_t Dash_GetStats(DashlaneContext* pContext, Dash_QueryWriterFunc writer, void* pUserPointer = nullptr);
+
+	// Clears the timings and counters collected by the context
+	DASHLANE_API uint32_t Dash_ResetStats(DashlaneContext* pContext);
+
+	// Sends the API requests of the context to another server, e.g. "http://127.0.0.1:8080" for the local mock server
+	// (dashlane-mock-server). Plain http is only accepted for loopback hosts, nullptr restores the Dashlane API.
+	// The DASHLANE_API_URL environment variable sets the default for every context
+	DASHLANE_API uint32_t Dash_SetApiBaseUrl(DashlaneContext* pContext, const char* szBaseUrl);
+
+	// Records spans (API requests, item decryption, SQLite statements, key derivation...) to a Chrome trace-event JSON file,
+	// loadable in ui.perfetto.dev or chrome://tracing. Pass nullptr to stop tracing. The file is written when the context is freed
+	// or on FlushTrace. Tracing can also be enabled for every context with the DASHLANE_TRACE_FILE environment variable.
+	// Contexts tracing to the same path share the file, which is written when the last of them is freed
+	DASHLANE_API uint32_t Dash_SetTraceOutput(DashlaneContext* pContext, const char* szPath);
+
+	// Writes the spans recorded so far to the trace file
+	DASHLANE_API uint32_t Dash_FlushTrace(DashlaneContext* pContext);
+
+	// Resets/Removes the vault data and any stored keys, and resets the configuration
+	DASHLANE_API uint32_t Dash_ResetVaultData(DashlaneContext* pContext, bool removeAllUsers = false);
+
+	// Set config option for storing the Master Password in the OS keychain
+	DASHLANE_API uint32_t Dash_SetShouldStoreMasterPassword(DashlaneContext* pContext, bool shouldStoreMasterPassword);
+
+	// Get the current config option value for storing the Master Password in the OS keychain
+	DASHLANE_API uint32_t Dash_GetShouldStoreMasterPassword(DashlaneContext* pContext, bool* pShouldStoreMasterPasswordOut);
+
+	// Set config option for automatically synchronizing if the last sync was over an hour ago
+	DASHLANE_API uint32_t Dash_SetAutoSync(DashlaneContext* pContext, bool autoSync);
+
+	// Get the current config option value for automatically synchronizing if the last sync was over an hour ago
+	DASHLANE_API uint32_t Dash_GetAutoSync(DashlaneContext* pContext, bool* pAutoSync);
 }
\ No newline at end of file
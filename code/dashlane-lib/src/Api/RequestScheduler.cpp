@@ -0,0 +1,124 @@
+#include "StdAfx.h"
+#include "RequestScheduler.h"
+#include "ApiRequest.h"
+
+#include <curl/curl.h>
+
+#include <random>
+#include <thread>
+
+namespace Dashlane
+{
+
+	// Endpoints not listed here use the default policy (single attempt, 30s deadline)
+	static const std::map<std::string, SRequestPolicy> s_requestPolicies =
+	{
+		{ "sync/GetLatestContent",                               { true, 5, std::chrono::milliseconds(250), std::chrono::milliseconds(8000), std::chrono::milliseconds(120000) } },
+		{ "authentication/GetAuthenticationMethodsForDevice",    { true, 4, std::chrono::milliseconds(250), std::chrono::milliseconds(4000), std::chrono::milliseconds(30000) } },
+
+		// These wait on the user to accept the push notification on another device
+		{ "authentication/PerformDuoPushVerification",           { false, 1, std::chrono::milliseconds(0), std::chrono::milliseconds(0), std::chrono::milliseconds(120000) } },
+		{ "authentication/PerformDashlaneAuthenticatorVerification", { false, 1, std::chrono::milliseconds(0), std::chrono::milliseconds(0), std::chrono::milliseconds(120000) } },
+	};
+
+	const SRequestPolicy& GetRequestPolicy(const std::string& path)
+	{
+		static const SRequestPolicy defaultPolicy{};
+
+		if (const auto it = s_requestPolicies.find(path); it != s_requestPolicies.end())
+			return it->second;
+
+		return defaultPolicy;
+	}
+
+	CRequestScheduler::CRequestScheduler(const SRequestPolicy& policy)
+		: m_policy(policy)
+		, m_deadline(std::chrono::steady_clock::now() + policy.deadline)
+	{}
+
+	ERetryReason CRequestScheduler::GetRetryReason(const SAPIResponse& response) const
+	{
+		if (response.clockSkewRejected)
+		{
+			// The server refused the request before processing it, safe to retry even when not idempotent
+			return m_clockSkewRetried ? ERetryReason::None : ERetryReason::ClockSkew;
+		}
+
+		if (!m_policy.idempotent)
+			return ERetryReason::None;
+
+		if (!response.success)
+		{
+			switch (static_cast<CURLcode>(response.responseCode))
+			{
+			case CURLE_COULDNT_RESOLVE_HOST:
+			case CURLE_COULDNT_CONNECT:
+			case CURLE_OPERATION_TIMEDOUT:
+			case CURLE_SSL_CONNECT_ERROR:
+			case CURLE_SEND_ERROR:
+			case CURLE_RECV_ERROR:
+			case CURLE_GOT_NOTHING:
+			case CURLE_PARTIAL_FILE:
+				return ERetryReason::TransientNetworkError;
+			default:
+				return ERetryReason::None;
+			}
+		}
+
+		switch (response.httpStatus)
+		{
+		case 429:
+		case 502:
+		case 503:
+		case 504:
+			return ERetryReason::TransientServerError;
+		}
+
+		return ERetryReason::None;
+	}
+
+	bool CRequestScheduler::ScheduleRetry(ERetryReason reason)
+	{
+		if (reason == ERetryReason::None)
+			return false;
+
+		if (reason == ERetryReason::ClockSkew)
+		{
+			// Clock offset has already been re-measured from the rejected response, retry immediately
+			m_clockSkewRetried = true;
+			++m_attempt;
+			return GetRemainingTime().count() > 0;
+		}
+
+		if (m_attempt >= m_policy.maxAttempts)
+			return false;
+
+		const std::chrono::milliseconds delay = GetBackoffDelay();
+		if (delay >= GetRemainingTime())
+			return false;
+
+		std::this_thread::sleep_for(delay);
+		++m_attempt;
+
+		return true;
+	}
+
+	std::chrono::milliseconds CRequestScheduler::GetRemainingTime() const
+	{
+		const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - std::chrono::steady_clock::now());
+		return std::max(remaining, std::chrono::milliseconds(0));
+	}
+
+	std::chrono::milliseconds CRequestScheduler::GetBackoffDelay() const
+	{
+		// "Full jitter" exponential backoff, spreads retries of many hosts hitting the same outage
+		thread_local std::mt19937 generator{ std::random_device{}() };
+
+		const uint32_t exponent = std::min<uint32_t>(m_attempt - 1, 16);
+		const int64_t ceiling = std::min<int64_t>(m_policy.baseDelay.count() << exponent, m_policy.maxDelay.count());
+
+		std::uniform_int_distribution<int64_t> distribution(0, std::max<int64_t>(ceiling, 0));
+		return std::chrono::milliseconds(distribution(generator));
+	}
+
+}
\ No newline at end of file
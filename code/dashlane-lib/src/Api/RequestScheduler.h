@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+
+namespace Dashlane
+{
+
+	struct SAPIResponse;
+
+	// Retry and deadline behaviour of a single API endpoint.
+	// Only idempotent endpoints are retried on transient network/server errors, any endpoint
+	// may be retried once when the server rejects the request timestamp (the request was not processed).
+	struct SRequestPolicy
+	{
+		bool idempotent{ false };
+		uint32_t maxAttempts{ 1 };
+		std::chrono::milliseconds baseDelay{ 250 };
+		std::chrono::milliseconds maxDelay{ 4000 };
+		std::chrono::milliseconds deadline{ 30000 };
+	};
+
+	const SRequestPolicy& GetRequestPolicy(const std::string& path);
+
+	enum class ERetryReason
+	{
+		None,
+		TransientNetworkError,
+		TransientServerError,
+		ClockSkew
+	};
+
+	class CRequestScheduler
+	{
+
+	public:
+
+		CRequestScheduler(const SRequestPolicy& policy);
+
+		// Classifies a failed attempt, returns ERetryReason::None if the failure is final
+		ERetryReason GetRetryReason(const SAPIResponse& response) const;
+
+		// Sleeps for a jittered exponential backoff and returns true if another attempt may be made
+		bool ScheduleRetry(ERetryReason reason);
+
+		// Time left before the endpoint deadline, used as the per-attempt transfer timeout
+		std::chrono::milliseconds GetRemainingTime() const;
+
+		uint32_t GetAttempt() const { return m_attempt; }
+
+	protected:
+
+		std::chrono::milliseconds GetBackoffDelay() const;
+
+	private:
+
+		const SRequestPolicy& m_policy;
+		const std::chrono::steady_clock::time_point m_deadline;
+		uint32_t m_attempt{ 1 };
+		bool m_clockSkewRetried{ false };
+
+	};
+
+}
\ No newline at end of file
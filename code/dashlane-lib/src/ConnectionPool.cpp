@@ -0,0 +1,164 @@
+#include "StdAfx.h"
+#include "ConnectionPool.h"
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+namespace Dashlane
+{
+
+	CConnectionPool::CReader::CReader(CConnectionPool& pool, std::unique_ptr<SQLite::Database>&& pDatabase)
+		: m_pPool(&pool)
+		, m_pDatabase(std::move(pDatabase))
+	{}
+
+	CConnectionPool::CReader::~CReader()
+	{
+		if (m_pDatabase)
+			m_pPool->ReleaseReader(std::move(m_pDatabase));
+	}
+
+	CConnectionPool::CConnectionPool(const std::filesystem::path& dbPath)
+		: m_dbPath(dbPath)
+	{}
+
+	CConnectionPool::~CConnectionPool() {}
+
+	std::shared_ptr<CConnectionPool> CConnectionPool::Acquire(const std::filesystem::path& dbPath)
+	{
+		static std::mutex s_poolsMutex;
+		static std::map<std::filesystem::path, std::weak_ptr<CConnectionPool>> s_pools;
+
+		const std::filesystem::path key = std::filesystem::absolute(dbPath).lexically_normal();
+
+		const std::lock_guard<std::mutex> lock(s_poolsMutex);
+
+		std::erase_if(s_pools, [](const auto& pool) { return pool.second.expired(); });
+
+		std::shared_ptr<CConnectionPool> pPool = s_pools[key].lock();
+		if (!pPool)
+		{
+			pPool = std::make_shared<CConnectionPool>(dbPath);
+			s_pools[key] = pPool;
+		}
+
+		return pPool;
+	}
+
+	void CConnectionPool::OpenWriter()
+	{
+		if (m_pWriter)
+			return;
+
+		m_pWriter = std::make_unique<SQLite::Database>(m_dbPath, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+
+		// Another process may hold the write lock, wait for its commit instead of failing
+		m_pWriter->setBusyTimeout(m_busyTimeoutMs);
+
+		// Persistent for the file, readers then never block on the writer nor the writer on readers
+		m_pWriter->exec("PRAGMA journal_mode = WAL");
+	}
+
+	CConnectionPool::CWriter CConnectionPool::LockWriter()
+	{
+		std::unique_lock<std::recursive_mutex> lock(m_writerMutex);
+		OpenWriter();
+
+		return CWriter(std::move(lock), *m_pWriter);
+	}
+
+	std::optional<CConnectionPool::CWriter> CConnectionPool::TryLockWriter()
+	{
+		std::unique_lock<std::recursive_mutex> lock(m_writerMutex, std::try_to_lock);
+		if (!lock.owns_lock())
+			return std::nullopt;
+
+		OpenWriter();
+
+		return CWriter(std::move(lock), *m_pWriter);
+	}
+
+	CConnectionPool::CReader CConnectionPool::AcquireReader()
+	{
+		std::unique_ptr<SQLite::Database> pReader;
+		{
+			std::unique_lock<std::mutex> lock(m_readersMutex);
+			m_readerReleased.wait(lock, [this] { return !m_idleReaders.empty() || m_openReaders < m_maxReaders; });
+
+			if (!m_idleReaders.empty())
+			{
+				pReader = std::move(m_idleReaders.back());
+				m_idleReaders.pop_back();
+			}
+			else
+			{
+				++m_openReaders;
+			}
+		}
+
+		if (!pReader)
+		{
+			try
+			{
+				pReader = std::make_unique<SQLite::Database>(m_dbPath, SQLite::OPEN_READONLY);
+			}
+			catch (...)
+			{
+				const std::lock_guard<std::mutex> lock(m_readersMutex);
+				--m_openReaders;
+				m_readerReleased.notify_one();
+				throw;
+			}
+		}
+
+		// Applied on every lease, the timeout may have changed since the connection was opened
+		pReader->setBusyTimeout(m_busyTimeoutMs);
+
+		return CReader(*this, std::move(pReader));
+	}
+
+	void CConnectionPool::ReleaseReader(std::unique_ptr<SQLite::Database>&& pDatabase)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(m_readersMutex);
+
+			// Connections above a lowered maximum are closed instead of being kept idle
+			if (m_openReaders > m_maxReaders)
+			{
+				--m_openReaders;
+				pDatabase.reset();
+			}
+			else
+			{
+				m_idleReaders.emplace_back(std::move(pDatabase));
+			}
+		}
+
+		m_readerReleased.notify_one();
+	}
+
+	void CConnectionPool::SetBusyTimeout(std::chrono::milliseconds timeout)
+	{
+		m_busyTimeoutMs = static_cast<int32_t>(timeout.count());
+
+		const std::lock_guard<std::recursive_mutex> lock(m_writerMutex);
+		if (m_pWriter)
+			m_pWriter->setBusyTimeout(m_busyTimeoutMs);
+	}
+
+	void CConnectionPool::SetMaxReaders(size_t maxReaders)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(m_readersMutex);
+
+			m_maxReaders = std::max<size_t>(maxReaders, 1);
+			while (m_openReaders > m_maxReaders && !m_idleReaders.empty())
+			{
+				m_idleReaders.pop_back();
+				--m_openReaders;
+			}
+		}
+
+		m_readerReleased.notify_all();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+
+// Forward Decls.
+namespace SQLite
+{
+	class Database;
+}
+
+namespace Dashlane
+{
+
+	// Connections to one database file, shared by every CDatabase opened on it in the process: the contexts of a vault
+	// and their background sync workers. The file is switched to WAL, so the read-only connections lent to lookups and
+	// queries read the last committed state without waiting for a synchronization that is writing.
+	// Writes go through a single connection serialized by the writer lock, the busy timeout only covers other processes.
+	class CConnectionPool
+	{
+
+	public:
+
+		static constexpr std::chrono::milliseconds DEFAULT_BUSY_TIMEOUT{ 5000 };
+		static constexpr size_t DEFAULT_MAX_READERS = 4;
+
+		// Exclusive use of the writer connection, recursive so a database transaction can be built from other write methods
+		class CWriter
+		{
+
+		public:
+
+			CWriter(std::unique_lock<std::recursive_mutex>&& lock, SQLite::Database& database)
+				: m_lock(std::move(lock))
+				, m_pDatabase(&database)
+			{}
+
+			SQLite::Database& operator*() const { return *m_pDatabase; }
+			SQLite::Database* operator->() const { return m_pDatabase; }
+
+		private:
+
+			std::unique_lock<std::recursive_mutex> m_lock;
+			SQLite::Database* m_pDatabase;
+
+		};
+
+		// Read-only connection lent for the statements of one call, given back to the pool when the lease is destroyed
+		class CReader
+		{
+
+		public:
+
+			CReader(CConnectionPool& pool, std::unique_ptr<SQLite::Database>&& pDatabase);
+			CReader(CReader&& other) noexcept = default;
+			CReader& operator=(CReader&&) = delete;
+			~CReader();
+
+			SQLite::Database& operator*() const { return *m_pDatabase; }
+			SQLite::Database* operator->() const { return m_pDatabase.get(); }
+
+		private:
+
+			CConnectionPool* m_pPool;
+			std::unique_ptr<SQLite::Database> m_pDatabase;
+
+		};
+
+		explicit CConnectionPool(const std::filesystem::path& dbPath);
+		~CConnectionPool();
+
+		// Pool of the file, created by the first CDatabase connecting to it and closed with the last one
+		static std::shared_ptr<CConnectionPool> Acquire(const std::filesystem::path& dbPath);
+
+		// The writer connection is opened (creating the file) on first use, so only the contexts that write pay for it.
+		// Throws SQLite::Exception when the file cannot be opened
+		CWriter LockWriter();
+
+		// Empty while another thread is writing, for best-effort writes that must not wait for a synchronization
+		std::optional<CWriter> TryLockWriter();
+
+		// Waits for a reader to be given back once maxReaders connections are lent
+		CReader AcquireReader();
+
+		void SetBusyTimeout(std::chrono::milliseconds timeout);
+		void SetMaxReaders(size_t maxReaders);
+
+	private:
+
+		// Called with the writer lock held
+		void OpenWriter();
+
+		void ReleaseReader(std::unique_ptr<SQLite::Database>&& pDatabase);
+
+		const std::filesystem::path m_dbPath;
+		std::atomic<int32_t> m_busyTimeoutMs{ static_cast<int32_t>(DEFAULT_BUSY_TIMEOUT.count()) };
+
+		std::recursive_mutex m_writerMutex;
+		std::unique_ptr<SQLite::Database> m_pWriter;
+
+		std::mutex m_readersMutex;
+		std::condition_variable m_readerReleased;
+		std::vector<std::unique_ptr<SQLite::Database>> m_idleReaders;
+		size_t m_openReaders{ 0 };
+		size_t m_maxReaders{ DEFAULT_MAX_READERS };
+
+	};
+
+}
\ No newline at end of file
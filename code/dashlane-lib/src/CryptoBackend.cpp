@@ -0,0 +1,686 @@
+#include "StdAfx.h"
+#include "CryptoBackend.h"
+#include "Utility/CpuFeatures.h"
+#include "Utility/Cryptography.h"
+#include "Utility/SecureMemory.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		static constexpr size_t AES_BLOCK_SIZE = 16;
+		static constexpr size_t AES_256_KEY_SIZE = 32;
+
+		bool IsValidJob(const SDecryptJob& job)
+		{
+			return job.pOutput != nullptr
+				&& job.cipherKey.size() == AES_256_KEY_SIZE
+				&& job.hmacKey.size() > 0
+				&& job.iv.size() == AES_BLOCK_SIZE
+				&& job.hash.size() == Utility::SHA256_DIGEST_SIZE
+				&& job.payload.size() > 0
+				&& job.payload.size() % AES_BLOCK_SIZE == 0;
+		}
+
+		bool IsSameKey(const Utility::SecureBuffer& current, std::span<const uint8_t> key)
+		{
+			return std::equal(current.begin(), current.end(), key.begin(), key.end());
+		}
+
+		class COpenSSLCryptoBackend : public ICryptoBackend
+		{
+
+		public:
+
+			COpenSSLCryptoBackend()
+				: m_pCipherCtx(EVP_CIPHER_CTX_new())
+				, m_pMacCtx(EVP_MD_CTX_new())
+				, m_pMacKeyCtx(EVP_MD_CTX_new())
+			{}
+
+			~COpenSSLCryptoBackend() override
+			{
+				EVP_CIPHER_CTX_free(m_pCipherCtx);
+				EVP_MD_CTX_free(m_pMacCtx);
+				EVP_MD_CTX_free(m_pMacKeyCtx);
+				EVP_PKEY_free(m_pMacKey);
+			}
+
+			// ICryptoBackend
+			ECryptoBackend GetType() const override
+			{
+				return ECryptoBackend::OpenSSL;
+			}
+
+			void DecryptBatch(std::span<SDecryptJob> jobs) override
+			{
+				for (SDecryptJob& job : jobs)
+					job.success = IsValidJob(job) && VerifyHash(job) && Decrypt(job);
+			}
+			// ~ICryptoBackend
+
+		protected:
+
+			bool VerifyHash(const SDecryptJob& job)
+			{
+				if (!SetMacKey(job.hmacKey))
+					return false;
+
+				// The keyed state (inner and outer pads) is computed once per key and copied for every job
+				uint8_t hash[Utility::SHA256_DIGEST_SIZE];
+				size_t hashSize = sizeof(hash);
+				if (Utility::OPENSSL_RC_SUCCESS != EVP_MD_CTX_copy_ex(m_pMacCtx, m_pMacKeyCtx)
+					|| Utility::OPENSSL_RC_SUCCESS != EVP_DigestSignUpdate(m_pMacCtx, job.iv.data(), job.iv.size())
+					|| Utility::OPENSSL_RC_SUCCESS != EVP_DigestSignUpdate(m_pMacCtx, job.payload.data(), job.payload.size())
+					|| Utility::OPENSSL_RC_SUCCESS != EVP_DigestSignFinal(m_pMacCtx, hash, &hashSize))
+				{
+					return false;
+				}
+
+				return CRYPTO_memcmp(hash, job.hash.data(), sizeof(hash)) == 0;
+			}
+
+			// Same padding handling as EVP_DecryptFinal_ex, the last block is dropped when the padding is invalid
+			static void RemovePadding(std::pmr::vector<uint8_t>& output)
+			{
+				const uint8_t padding = output.back();
+
+				bool isValid = padding >= 1 && padding <= AES_BLOCK_SIZE;
+				for (size_t i = 0; isValid && i < padding; ++i)
+					isValid = output[output.size() - 1 - i] == padding;
+
+				output.resize(output.size() - (isValid ? padding : AES_BLOCK_SIZE));
+			}
+
+		private:
+
+			bool SetMacKey(std::span<const uint8_t> key)
+			{
+				if (m_pMacKey != nullptr && IsSameKey(m_macKey, key))
+					return true;
+
+				// The signing context of the previous key is released with the context state
+				EVP_MD_CTX_reset(m_pMacKeyCtx);
+				EVP_PKEY_free(m_pMacKey);
+				m_pMacKey = EVP_PKEY_new_raw_private_key(EVP_PKEY_HMAC, nullptr, key.data(), key.size());
+				if (m_pMacKey == nullptr
+					|| Utility::OPENSSL_RC_SUCCESS != EVP_DigestSignInit(m_pMacKeyCtx, nullptr, EVP_sha256(), nullptr, m_pMacKey))
+				{
+					EVP_PKEY_free(m_pMacKey);
+					m_pMacKey = nullptr;
+					return false;
+				}
+
+				m_macKey.assign(key.begin(), key.end());
+				return true;
+			}
+
+			bool Decrypt(SDecryptJob& job)
+			{
+				// The key schedule is kept while the key does not change, only the IV is set for every job
+				const bool isSameKey = m_hasCipherKey && IsSameKey(m_cipherKey, job.cipherKey);
+				if (!isSameKey)
+				{
+					m_hasCipherKey = Utility::OPENSSL_RC_SUCCESS == EVP_DecryptInit_ex(m_pCipherCtx, EVP_aes_256_cbc(), nullptr, job.cipherKey.data(), nullptr);
+					if (!m_hasCipherKey)
+						return false;
+
+					m_cipherKey.assign(job.cipherKey.begin(), job.cipherKey.end());
+				}
+
+				if (Utility::OPENSSL_RC_SUCCESS != EVP_DecryptInit_ex(m_pCipherCtx, nullptr, nullptr, nullptr, job.iv.data()))
+					return false;
+
+				std::pmr::vector<uint8_t>& output = *job.pOutput;
+				output.resize(job.payload.size());
+
+				int written = 0;
+				int writtenFinal = 0;
+				if (Utility::OPENSSL_RC_SUCCESS != EVP_DecryptUpdate(m_pCipherCtx, output.data(), &written, job.payload.data(), static_cast<int>(job.payload.size())))
+				{
+					output.resize(0);
+					return false;
+				}
+
+				EVP_DecryptFinal_ex(m_pCipherCtx, output.data() + written, &writtenFinal);
+				output.resize(written + writtenFinal);
+
+				return true;
+			}
+
+			EVP_CIPHER_CTX* m_pCipherCtx;
+			Utility::SecureBuffer m_cipherKey;
+			bool m_hasCipherKey{ false };
+
+			EVP_MD_CTX* m_pMacCtx;
+			EVP_MD_CTX* m_pMacKeyCtx;
+			EVP_PKEY* m_pMacKey{ nullptr };
+			Utility::SecureBuffer m_macKey;
+
+		};
+
+#if defined(DASHLANE_X64)
+
+		// x ^ x << 32 ^ x << 64 ^ x << 96, the running XOR of the previous key words
+		DASHLANE_TARGET_AESNI inline __m128i ShiftXorKeyWords(__m128i value)
+		{
+			value = _mm_xor_si128(value, _mm_slli_si128(value, 4));
+			return _mm_xor_si128(value, _mm_slli_si128(value, 8));
+		}
+
+		template<int Rcon>
+		DASHLANE_TARGET_AESNI inline void ExpandAes256KeyRound(__m128i& first, __m128i& second, __m128i* pRoundKeys)
+		{
+			first = _mm_xor_si128(ShiftXorKeyWords(first), _mm_shuffle_epi32(_mm_aeskeygenassist_si128(second, Rcon), 0xFF));
+			pRoundKeys[0] = first;
+
+			if constexpr (Rcon != 0x40)
+			{
+				second = _mm_xor_si128(ShiftXorKeyWords(second), _mm_shuffle_epi32(_mm_aeskeygenassist_si128(first, 0), 0xAA));
+				pRoundKeys[1] = second;
+			}
+		}
+
+		// Round keys of the equivalent inverse cipher, in the order they are applied
+		DASHLANE_TARGET_AESNI inline void ExpandAes256DecryptKey(const uint8_t* pKey, __m128i* pDecryptKeys)
+		{
+			__m128i roundKeys[15];
+			__m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pKey));
+			__m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pKey + 16));
+			roundKeys[0] = first;
+			roundKeys[1] = second;
+
+			ExpandAes256KeyRound<0x01>(first, second, roundKeys + 2);
+			ExpandAes256KeyRound<0x02>(first, second, roundKeys + 4);
+			ExpandAes256KeyRound<0x04>(first, second, roundKeys + 6);
+			ExpandAes256KeyRound<0x08>(first, second, roundKeys + 8);
+			ExpandAes256KeyRound<0x10>(first, second, roundKeys + 10);
+			ExpandAes256KeyRound<0x20>(first, second, roundKeys + 12);
+			ExpandAes256KeyRound<0x40>(first, second, roundKeys + 14);
+
+			pDecryptKeys[0] = roundKeys[14];
+			for (size_t i = 1; i < 14; ++i)
+				pDecryptKeys[i] = _mm_aesimc_si128(roundKeys[14 - i]);
+			pDecryptKeys[14] = roundKeys[0];
+
+			OPENSSL_cleanse(roundKeys, sizeof(roundKeys));
+		}
+
+		struct SCbcBlock
+		{
+			const uint8_t* pInput;
+			const uint8_t* pPrevious;	// Previous ciphertext block or IV
+			uint8_t* pOutput;
+		};
+
+		// Decrypts independent blocks with their rounds interleaved, keeping the AES unit pipeline full
+		DASHLANE_TARGET_AESNI inline void DecryptAes256Blocks(const __m128i* pDecryptKeys, const SCbcBlock* pBlocks, size_t count)
+		{
+			__m128i states[8];
+
+			for (size_t i = 0; i < count; ++i)
+				states[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pBlocks[i].pInput)), pDecryptKeys[0]);
+
+			for (size_t round = 1; round < 14; ++round)
+			{
+				for (size_t i = 0; i < count; ++i)
+					states[i] = _mm_aesdec_si128(states[i], pDecryptKeys[round]);
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const __m128i plain = _mm_aesdeclast_si128(states[i], pDecryptKeys[14]);
+				const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBlocks[i].pPrevious));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pBlocks[i].pOutput), _mm_xor_si128(plain, previous));
+			}
+		}
+
+		// Multi-buffer CBC decrypt: CBC decryption has no dependency between blocks, the blocks of every item of the
+		// batch are fed 8 at a time, so small items fill the pipeline as well as large ones. HMAC verification goes
+		// through OpenSSL (which uses the SHA extensions when the CPU has them).
+		class CAesNiCryptoBackend : public COpenSSLCryptoBackend
+		{
+
+		public:
+
+			static constexpr size_t LANE_COUNT = 8;
+
+			~CAesNiCryptoBackend() override
+			{
+				OPENSSL_cleanse(m_decryptKeys, sizeof(m_decryptKeys));
+			}
+
+			// ICryptoBackend
+			ECryptoBackend GetType() const override
+			{
+				return ECryptoBackend::AesNi;
+			}
+
+			void DecryptBatch(std::span<SDecryptJob> jobs) override
+			{
+				for (SDecryptJob& job : jobs)
+					job.success = IsValidJob(job);
+
+				VerifyHashes(jobs);
+
+				SCbcBlock blocks[LANE_COUNT]{};
+				size_t blockCount = 0;
+
+				for (SDecryptJob& job : jobs)
+				{
+					if (!job.success)
+						continue;
+
+					if (!m_hasKey || !IsSameKey(m_cipherKey, job.cipherKey))
+					{
+						DecryptAes256Blocks(m_decryptKeys, blocks, blockCount);
+						blockCount = 0;
+
+						ExpandAes256DecryptKey(job.cipherKey.data(), m_decryptKeys);
+						m_cipherKey.assign(job.cipherKey.begin(), job.cipherKey.end());
+						m_hasKey = true;
+					}
+
+					std::pmr::vector<uint8_t>& output = *job.pOutput;
+					output.resize(job.payload.size());
+
+					for (size_t offset = 0; offset < job.payload.size(); offset += AES_BLOCK_SIZE)
+					{
+						const uint8_t* pPrevious = offset == 0 ? job.iv.data() : job.payload.data() + offset - AES_BLOCK_SIZE;
+						blocks[blockCount++] = { job.payload.data() + offset, pPrevious, output.data() + offset };
+
+						if (blockCount == LANE_COUNT)
+						{
+							DecryptAes256Blocks(m_decryptKeys, blocks, blockCount);
+							blockCount = 0;
+						}
+					}
+				}
+
+				DecryptAes256Blocks(m_decryptKeys, blocks, blockCount);
+
+				for (SDecryptJob& job : jobs)
+				{
+					if (job.success)
+						RemovePadding(*job.pOutput);
+				}
+			}
+			// ~ICryptoBackend
+
+		protected:
+
+			// Clears the success flag of the jobs whose HMAC does not match
+			virtual void VerifyHashes(std::span<SDecryptJob> jobs)
+			{
+				for (SDecryptJob& job : jobs)
+					job.success = job.success && VerifyHash(job);
+			}
+
+		private:
+
+			__m128i m_decryptKeys[15]{};
+			Utility::SecureBuffer m_cipherKey;
+			bool m_hasKey{ false };
+
+		};
+
+		static constexpr size_t SHA256_BLOCK_SIZE = 64;
+
+		static constexpr uint32_t SHA256_INITIAL_STATE[8] =
+		{
+			0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+		};
+
+		static constexpr uint32_t SHA256_ROUND_CONSTANTS[64] =
+		{
+			0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+			0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+			0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+			0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+			0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+			0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+			0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+			0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+		};
+
+		inline uint32_t LoadBigEndian32(const uint8_t* p)
+		{
+			return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+		}
+
+		inline void StoreBigEndian32(uint8_t* p, uint32_t value)
+		{
+			p[0] = static_cast<uint8_t>(value >> 24);
+			p[1] = static_cast<uint8_t>(value >> 16);
+			p[2] = static_cast<uint8_t>(value >> 8);
+			p[3] = static_cast<uint8_t>(value);
+		}
+
+		inline void StoreBigEndian64(uint8_t* p, uint64_t value)
+		{
+			StoreBigEndian32(p, static_cast<uint32_t>(value >> 32));
+			StoreBigEndian32(p + 4, static_cast<uint32_t>(value));
+		}
+
+		inline uint32_t RotateRight(uint32_t value, int count)
+		{
+			return (value >> count) | (value << (32 - count));
+		}
+
+		// Scalar SHA-256 compression, used for the keyed pad blocks computed once per HMAC key
+		inline void CompressSha256(uint32_t* pState, const uint8_t* pBlock)
+		{
+			uint32_t w[64];
+			for (size_t t = 0; t < 16; ++t)
+				w[t] = LoadBigEndian32(pBlock + 4 * t);
+			for (size_t t = 16; t < 64; ++t)
+			{
+				const uint32_t s0 = RotateRight(w[t - 15], 7) ^ RotateRight(w[t - 15], 18) ^ (w[t - 15] >> 3);
+				const uint32_t s1 = RotateRight(w[t - 2], 17) ^ RotateRight(w[t - 2], 19) ^ (w[t - 2] >> 10);
+				w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+			}
+
+			uint32_t a = pState[0], b = pState[1], c = pState[2], d = pState[3];
+			uint32_t e = pState[4], f = pState[5], g = pState[6], h = pState[7];
+			for (size_t t = 0; t < 64; ++t)
+			{
+				const uint32_t t1 = h + (RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_ROUND_CONSTANTS[t] + w[t];
+				const uint32_t t2 = (RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+				h = g; g = f; f = e; e = d + t1;
+				d = c; c = b; b = a; a = t1 + t2;
+			}
+
+			pState[0] += a; pState[1] += b; pState[2] += c; pState[3] += d;
+			pState[4] += e; pState[5] += f; pState[6] += g; pState[7] += h;
+
+			OPENSSL_cleanse(w, sizeof(w));
+		}
+
+		template<int Count>
+		DASHLANE_TARGET_AVX2 inline __m256i RotateRightLanes(__m256i value)
+		{
+			return _mm256_or_si256(_mm256_srli_epi32(value, Count), _mm256_slli_epi32(value, 32 - Count));
+		}
+
+		// One SHA-256 compression in each of the 8 lanes. The state is word-major (pState[word * 8 + lane]) and
+		// ppBlocks holds the 64 byte block of every lane
+		DASHLANE_TARGET_AVX2 inline void CompressSha256Lanes(uint32_t* pState, const uint8_t* const* ppBlocks)
+		{
+			alignas(32) uint32_t words[16][8];
+			for (size_t lane = 0; lane < 8; ++lane)
+			{
+				for (size_t t = 0; t < 16; ++t)
+					words[t][lane] = LoadBigEndian32(ppBlocks[lane] + 4 * t);
+			}
+
+			__m256i w[16];
+			for (size_t t = 0; t < 16; ++t)
+				w[t] = _mm256_load_si256(reinterpret_cast<const __m256i*>(words[t]));
+
+			__m256i state[8];
+			for (size_t i = 0; i < 8; ++i)
+				state[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pState + 8 * i));
+
+			__m256i a = state[0], b = state[1], c = state[2], d = state[3];
+			__m256i e = state[4], f = state[5], g = state[6], h = state[7];
+			for (size_t t = 0; t < 64; ++t)
+			{
+				// The message schedule is kept as a ring of its last 16 words
+				if (t >= 16)
+				{
+					const __m256i w15 = w[(t - 15) & 15];
+					const __m256i w2 = w[(t - 2) & 15];
+					const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(RotateRightLanes<7>(w15), RotateRightLanes<18>(w15)), _mm256_srli_epi32(w15, 3));
+					const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(RotateRightLanes<17>(w2), RotateRightLanes<19>(w2)), _mm256_srli_epi32(w2, 10));
+					w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0), _mm256_add_epi32(w[(t - 7) & 15], s1));
+				}
+
+				const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(RotateRightLanes<6>(e), RotateRightLanes<11>(e)), RotateRightLanes<25>(e));
+				const __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+				const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(choose, _mm256_set1_epi32(static_cast<int>(SHA256_ROUND_CONSTANTS[t])))), w[t & 15]);
+				const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(RotateRightLanes<2>(a), RotateRightLanes<13>(a)), RotateRightLanes<22>(a));
+				const __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+				const __m256i t2 = _mm256_add_epi32(s0, majority);
+				h = g; g = f; f = e; e = _mm256_add_epi32(d, t1);
+				d = c; c = b; b = a; a = _mm256_add_epi32(t1, t2);
+			}
+
+			const __m256i result[8] = { a, b, c, d, e, f, g, h };
+			for (size_t i = 0; i < 8; ++i)
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pState + 8 * i), _mm256_add_epi32(state[i], result[i]));
+		}
+
+		// Multi-buffer HMAC-SHA256 on top of the AES-NI decryption: the hashes of 8 items advance together, one message
+		// block per AVX2 lane, and a lane takes the next item as soon as its item is verified. Vault items are a few
+		// blocks long, so this also beats OpenSSL on CPUs with the SHA extensions, where its per-call cost dominates.
+		class CMultiBufferCryptoBackend final : public CAesNiCryptoBackend
+		{
+
+		public:
+
+			static constexpr size_t HASH_LANE_COUNT = 8;
+
+			~CMultiBufferCryptoBackend() override
+			{
+				OPENSSL_cleanse(m_innerState, sizeof(m_innerState));
+				OPENSSL_cleanse(m_outerState, sizeof(m_outerState));
+			}
+
+			// ICryptoBackend
+			ECryptoBackend GetType() const override
+			{
+				return ECryptoBackend::MultiBuffer;
+			}
+			// ~ICryptoBackend
+
+		protected:
+
+			void VerifyHashes(std::span<SDecryptJob> jobs) override
+			{
+				static constexpr uint8_t s_idleBlock[SHA256_BLOCK_SIZE]{};
+
+				SHashLane lanes[HASH_LANE_COUNT]{};
+				alignas(32) uint32_t states[8 * HASH_LANE_COUNT]{};
+				const uint8_t* blocks[HASH_LANE_COUNT]{};
+
+				size_t nextJob = 0;
+				while (true)
+				{
+					size_t activeCount = 0;
+					for (size_t i = 0; i < HASH_LANE_COUNT; ++i)
+					{
+						if (lanes[i].pJob == nullptr)
+							StartLane(jobs, nextJob, lanes[i], i, states);
+
+						// Idle lanes hash a block of zeros, their state is ignored
+						blocks[i] = lanes[i].pJob != nullptr ? GetLaneBlock(lanes[i]) : s_idleBlock;
+						activeCount += lanes[i].pJob != nullptr ? 1 : 0;
+					}
+
+					if (activeCount == 0)
+						break;
+
+					CompressSha256Lanes(states, blocks);
+
+					for (size_t i = 0; i < HASH_LANE_COUNT; ++i)
+					{
+						if (lanes[i].pJob != nullptr)
+							AdvanceLane(lanes[i], i, states);
+					}
+				}
+
+				OPENSSL_cleanse(lanes, sizeof(lanes));
+				OPENSSL_cleanse(states, sizeof(states));
+			}
+
+		private:
+
+			struct SHashLane
+			{
+				SDecryptJob* pJob;
+				uint64_t blockIndex;			// Next block of the inner message, iv || payload || padding
+				uint64_t blockCount;
+				bool isOuter;					// Hashing the single block of the outer hash
+				uint32_t outerState[8];			// Opad state of the job key
+				uint8_t block[SHA256_BLOCK_SIZE];	// Block assembled for the lane when it is not contiguous in the payload
+			};
+
+			// The inner and outer pad states are computed once per key and copied into the lanes of every job
+			bool SetHashKey(std::span<const uint8_t> key)
+			{
+				if (m_hasHashKey && IsSameKey(m_hashKey, key))
+					return true;
+
+				// Longer keys are hashed first (RFC 2104), these are left to OpenSSL
+				if (key.size() > SHA256_BLOCK_SIZE)
+					return false;
+
+				uint8_t innerPad[SHA256_BLOCK_SIZE];
+				uint8_t outerPad[SHA256_BLOCK_SIZE];
+				for (size_t i = 0; i < SHA256_BLOCK_SIZE; ++i)
+				{
+					const uint8_t value = i < key.size() ? key[i] : 0;
+					innerPad[i] = value ^ 0x36;
+					outerPad[i] = value ^ 0x5c;
+				}
+
+				std::copy(std::begin(SHA256_INITIAL_STATE), std::end(SHA256_INITIAL_STATE), m_innerState);
+				std::copy(std::begin(SHA256_INITIAL_STATE), std::end(SHA256_INITIAL_STATE), m_outerState);
+				CompressSha256(m_innerState, innerPad);
+				CompressSha256(m_outerState, outerPad);
+
+				OPENSSL_cleanse(innerPad, sizeof(innerPad));
+				OPENSSL_cleanse(outerPad, sizeof(outerPad));
+
+				m_hashKey.assign(key.begin(), key.end());
+				m_hasHashKey = true;
+				return true;
+			}
+
+			// Moves the next job still to verify into the lane, starting from the inner pad state of its key
+			void StartLane(std::span<SDecryptJob> jobs, size_t& nextJob, SHashLane& lane, size_t laneIndex, uint32_t* pStates)
+			{
+				while (nextJob < jobs.size())
+				{
+					SDecryptJob& job = jobs[nextJob++];
+					if (!job.success)
+						continue;
+
+					if (!SetHashKey(job.hmacKey))
+					{
+						job.success = VerifyHash(job);
+						continue;
+					}
+
+					const uint64_t messageSize = job.iv.size() + job.payload.size();
+					lane.pJob = &job;
+					lane.blockIndex = 0;
+					lane.blockCount = (messageSize + 1 + sizeof(uint64_t) + SHA256_BLOCK_SIZE - 1) / SHA256_BLOCK_SIZE;
+					lane.isOuter = false;
+					std::copy(std::begin(m_outerState), std::end(m_outerState), lane.outerState);
+
+					for (size_t word = 0; word < 8; ++word)
+						pStates[word * HASH_LANE_COUNT + laneIndex] = m_innerState[word];
+					return;
+				}
+			}
+
+			// Current block of the lane, read in place when it lies within the payload
+			static const uint8_t* GetLaneBlock(SHashLane& lane)
+			{
+				if (lane.isOuter)
+					return lane.block;
+
+				const SDecryptJob& job = *lane.pJob;
+				const uint64_t ivSize = job.iv.size();
+				const uint64_t messageSize = ivSize + job.payload.size();
+				const uint64_t offset = lane.blockIndex * SHA256_BLOCK_SIZE;
+				if (offset >= ivSize && offset + SHA256_BLOCK_SIZE <= messageSize)
+					return job.payload.data() + (offset - ivSize);
+
+				size_t written = 0;
+				if (offset < ivSize)
+				{
+					written = static_cast<size_t>(std::min<uint64_t>(ivSize - offset, SHA256_BLOCK_SIZE));
+					std::memcpy(lane.block, job.iv.data() + offset, written);
+				}
+				if (offset + written < messageSize)
+				{
+					const uint64_t payloadOffset = offset + written - ivSize;
+					const size_t count = static_cast<size_t>(std::min<uint64_t>(SHA256_BLOCK_SIZE - written, job.payload.size() - payloadOffset));
+					std::memcpy(lane.block + written, job.payload.data() + payloadOffset, count);
+					written += count;
+				}
+				std::fill(lane.block + written, lane.block + SHA256_BLOCK_SIZE, uint8_t{ 0 });
+
+				if (messageSize >= offset && messageSize < offset + SHA256_BLOCK_SIZE)
+					lane.block[messageSize - offset] = 0x80;
+				if (lane.blockIndex + 1 == lane.blockCount)
+					StoreBigEndian64(lane.block + SHA256_BLOCK_SIZE - sizeof(uint64_t), (SHA256_BLOCK_SIZE + messageSize) * 8);
+
+				return lane.block;
+			}
+
+			// Moves the lane past the block just hashed: to the outer hash once the inner one is complete, and to the
+			// result once the outer one is
+			static void AdvanceLane(SHashLane& lane, size_t laneIndex, uint32_t* pStates)
+			{
+				if (!lane.isOuter)
+				{
+					if (++lane.blockIndex < lane.blockCount)
+						return;
+
+					// Inner digest and its padding, hashed from the outer pad state
+					for (size_t word = 0; word < 8; ++word)
+						StoreBigEndian32(lane.block + 4 * word, pStates[word * HASH_LANE_COUNT + laneIndex]);
+					std::fill(lane.block + Utility::SHA256_DIGEST_SIZE, lane.block + SHA256_BLOCK_SIZE, uint8_t{ 0 });
+					lane.block[Utility::SHA256_DIGEST_SIZE] = 0x80;
+					StoreBigEndian64(lane.block + SHA256_BLOCK_SIZE - sizeof(uint64_t), (SHA256_BLOCK_SIZE + Utility::SHA256_DIGEST_SIZE) * 8);
+
+					for (size_t word = 0; word < 8; ++word)
+						pStates[word * HASH_LANE_COUNT + laneIndex] = lane.outerState[word];
+					lane.isOuter = true;
+					return;
+				}
+
+				uint8_t hash[Utility::SHA256_DIGEST_SIZE];
+				for (size_t word = 0; word < 8; ++word)
+					StoreBigEndian32(hash + 4 * word, pStates[word * HASH_LANE_COUNT + laneIndex]);
+
+				lane.pJob->success = CRYPTO_memcmp(hash, lane.pJob->hash.data(), sizeof(hash)) == 0;
+				lane.pJob = nullptr;
+			}
+
+			uint32_t m_innerState[8]{};
+			uint32_t m_outerState[8]{};
+			Utility::SecureBuffer m_hashKey;
+			bool m_hasHashKey{ false };
+
+		};
+
+#endif
+
+	}
+
+	std::unique_ptr<ICryptoBackend> CreateCryptoBackend(ECryptoBackend type)
+	{
+#if defined(DASHLANE_X64)
+		const Utility::SCpuFeatures& features = Utility::GetCpuFeatures();
+		const bool hasAesNi = features.aesni && features.sse41;
+
+		if (hasAesNi && features.avx2 && (type == ECryptoBackend::Auto || type == ECryptoBackend::MultiBuffer))
+			return std::make_unique<CMultiBufferCryptoBackend>();
+
+		if (hasAesNi && type != ECryptoBackend::OpenSSL)
+			return std::make_unique<CAesNiCryptoBackend>();
+#endif
+
+		return std::make_unique<COpenSSLCryptoBackend>();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace Dashlane
+{
+
+	// One envelope to verify and decrypt, the spans must stay valid until the batch is processed
+	struct SDecryptJob
+	{
+		std::span<const uint8_t> cipherKey;		// AES-256 key, 32 bytes
+		std::span<const uint8_t> hmacKey;		// HMAC-SHA256 key, 32 bytes
+		std::span<const uint8_t> iv;
+		std::span<const uint8_t> payload;
+		std::span<const uint8_t> hash;			// Expected HMAC of iv || payload
+
+		std::pmr::vector<uint8_t>* pOutput{ nullptr };
+		bool success{ false };
+	};
+
+	enum class ECryptoBackend
+	{
+		Auto,		// Best backend for the CPU
+		OpenSSL,	// EVP calls, contexts and key schedules reused across the batch
+		AesNi,		// Blocks of different items interleaved through the AES-NI pipeline
+		MultiBuffer	// AES-NI, and the HMACs of 8 items computed together in AVX2 lanes
+	};
+
+	class ICryptoBackend
+	{
+
+	public:
+
+		virtual ~ICryptoBackend() = default;
+
+		virtual ECryptoBackend GetType() const = 0;
+
+		// Verifies and decrypts every job (AES-256-CBC with PKCS#7 padding, HMAC-SHA256 encrypt-then-MAC).
+		// Jobs sharing their keys with the previous job reuse its key schedule and HMAC state.
+		virtual void DecryptBatch(std::span<SDecryptJob> jobs) = 0;
+
+	};
+
+	// Backend instances keep per-batch state and are not shared between threads
+	std::unique_ptr<ICryptoBackend> CreateCryptoBackend(ECryptoBackend type = ECryptoBackend::Auto);
+
+}
\ No newline at end of file
@@ -1,666 +1,1585 @@
-#include "StdAfx.h"
-#include "Dashlane.h"
-#include "Encryption.h"
-#include "Keychain.h"
-#include "Api/Endpoints/GetLatestContent.h"
-#include "Types/Transactions.h"
-#include "Utility/Strings.h"
-#include "Utility/Time.h"
-#include "Utility/Transaction.h"
-#include "Utility/Vector.h"
-#include "Utility/Zip.h"
-
-#define ENSURE_POINTER(ptr, rc_error) 			   \
-	if (ptr == nullptr) return RC_TO_INT(rc_error) \
-
-#define ENSURE_STRLEN(str, rc_error) 				      \
-	if (std::strlen(str) == 0) return RC_TO_INT(rc_error) \
-
-#define ENSURE_POINTER_VOID(ptr) \
-	if (ptr == nullptr) return   \
-
-#define ENSURE_STRLEN_VOID(str) 	  \
-	if (std::strlen(str) == 0) return \
-
-inline uint32_t RC_TO_INT(EDashlaneError rc)
-{
-	return static_cast<uint32_t>(rc);
-}
-
-namespace Dashlane
-{
-
-	EDashlaneError EncryptAndSerialize(
-		const DashlaneContextInternal& context,
-		const std::vector<uint8_t>& input,
-		std::string& output
-	)
-	{
-		// Encrypt
-		Dashlane::CEncryption encryptor;
-		Dashlane::SEncryptedData encryptedDataOut;
-		if (!encryptor.EncryptData(context.secrets.localKey, input, encryptedDataOut))
-		{
-			return EDashlaneError::InternalEncryptFailure;
-		}
-
-		// Serialize
-		std::vector<uint8_t> serialized;
-		CSerializer::DoSerialize(serialized, encryptedDataOut);
-
-		// Encode
-		output = base64pp::encode(serialized);
-
-		return EDashlaneError::NoError;
-	}
-
-	EDashlaneError DeserializeAndDecrypt(
-		const DashlaneContextInternal& context,
-		const std::string& input,
-		std::vector<uint8_t>& output
-	)
-	{
-		// Decode
-		const auto maybeDecoded = base64pp::decode(input);
-		if (maybeDecoded == std::nullopt)
-		{
-			return EDashlaneError::InternalDecryptFailure;
-		}
-
-		// Deserialize
-		Dashlane::SEncryptedData encryptedData;
-		CSerializer::DoDeserialize(maybeDecoded.value(), encryptedData);
-
-		// Decrypt
-		Dashlane::CEncryption encryption;
-
-		std::vector<uint8_t> symmetricKey;
-		if (encryptedData.pKeyDerivation->GetDerivation() != Dashlane::EDerivationAlgorithm::None)
-		{
-			EDashlaneError rc = encryption.GetSymmetricKeyFromData(context, maybeDecoded.value(), encryptedData, symmetricKey);
-			if (rc != EDashlaneError::NoError)
-				return rc;
-		}
-		else
-		{
-			symmetricKey = context.secrets.localKey;
-		}
-
-		if (!encryption.SetContextFromEncryptedData(symmetricKey, maybeDecoded.value(), encryptedData))
-		{
-			return EDashlaneError::InternalDecryptFailure;
-		}
-
-		if (!encryption.DecryptFromContext())
-		{
-			return EDashlaneError::InternalDecryptFailure;
-		}
-
-		output = encryption.GetOutput();
-
-		return EDashlaneError::NoError;
-	}
-
-	EDashlaneError RecryptTransactionContent(const DashlaneContextInternal& context, const std::string& content, std::string& output)
-	{
-		// Decode, Deserialize, Decrypt
-		std::vector<uint8_t> decrypted;
-
-		if (EDashlaneError rc = DeserializeAndDecrypt(context, content, decrypted); rc != EDashlaneError::NoError)
-		{
-			return rc;
-		}
-
-		if (EDashlaneError rc = EncryptAndSerialize(context, decrypted, output); rc != EDashlaneError::NoError)
-		{
-			return rc;
-		}
-
-		return EDashlaneError::NoError;
-	}
-
-	EDashlaneError ProcessTransaction(const DashlaneContextInternal& context, const Dashlane::SRawTransactionBackupEdit& transaction, nlohmann::ordered_json& jsonOut)
-	{
-		// Decode, Deserialize, Decrypt
-		std::vector<uint8_t> decrypted;
-		if (EDashlaneError rc = DeserializeAndDecrypt(context, transaction.content, decrypted); rc != EDashlaneError::NoError)
-		{
-			return rc;
-		}
-
-		// Decompress
-		const auto compressed = Utility::SliceVectorBySpan(decrypted, 6);
-		const std::vector<uint8_t> decompressed = Utility::InflateRaw(compressed);
-
-		// XML to Json
-		jsonOut = Utility::XmlToJsonTransaction(decompressed);
-
-		return EDashlaneError::NoError;
-	}
-
-	static std::vector<std::shared_ptr<DashlaneContextInternal>> s_contexts = {};
-	static std::vector<std::shared_ptr<DashlaneQueryContextInternal>> s_queryContexts = {};
-
-}
-
-const char* Dash_GetErrorMessage(uint32_t errorCode)
-{
-	switch ((EDashlaneError)errorCode)
-	{
-	case EDashlaneError::NoError: return "Function executed successfully";
-		break;
-
-	case EDashlaneError::RequireMasterPassword: return "The context requires the Master Password to be set to continue";
-		break;
-	case EDashlaneError::Require2FACode: return "The context requires the 2FA code to be set to continue";
-		break;
-	case EDashlaneError::RequireEmailToken: return "The context requires the email token to be set to continue";
-		break;
-
-	case EDashlaneError::InvalidContext: return "The provided context is invalid";
-		break;
-	case EDashlaneError::MissingOrInvalidLogin: return "Cannot create Dashlane context with an empty Login parameter";
-		break;
-	case EDashlaneError::MissingOrInvalidAppKeys: return "Cannot create Dashlane context without valid App Keys";
-		break;
-
-	case EDashlaneError::Invalid2FACode: return "The Two-Factor authentication code provided is invalid";
-		break;
-	case EDashlaneError::InvalidEmailToken: return "The email token provided is invalid";
-		break;
-	case EDashlaneError::InvalidMasterPassword: return "The Master Password provided is invalid";
-		break;
-	case EDashlaneError::DeviceRegistrationFailed: return "Failed to register device (Incorrect authentication?)";
-		break;
-
-	case EDashlaneError::InvalidParameter: return "An invalid parameter was provided to a library function";
-		break;
-	case EDashlaneError::DeviceNotRegistered: return "This device has not been registered, this function is not available";
-		break;
-
-	case EDashlaneError::InvalidAPIRequest: return "An internal error occurred and the API request failed";
-		break;
-	case EDashlaneError::NoSupportedAuth: return "No authentication methods available that are supported by this application";
-		break;
-	case EDashlaneError::FailedDatabaseConnection: return "Failed to create SQLite connection (Invalid path?)";
-		break;
-	case EDashlaneError::FailedDatabaseCreation: return "Failed to create SQLite tables or communicate with SQLite";
-		break;
-	case EDashlaneError::KeychainUnavailable: return "OS Keychain not available on this system, Master Password cannot be stored";
-		break;
-	case EDashlaneError::UpdateConfigFailed: return "Failed to update Dashlane configuration in database";
-		break;
-	case EDashlaneError::APIError_Timeout: return "The API request was not in time for the API and we couldn't recover";
-		break;
-	}
-
-	return "Unknown error code";
-}
-
-uint32_t Dash_InitContext(DashlaneContext** ppContext,
-	const char* szApplicationName,
-	const char* szLogin,
-	const char* szAppAccessKey,
-	const char* szAppSecretKey)
-{
-	if (ppContext == nullptr ||
-		std::strlen(szApplicationName) == 0 ||
-		std::strlen(szLogin) == 0 ||
-		std::strlen(szAppAccessKey) == 0 ||
-		std::strlen(szAppSecretKey) == 0)
-	{
-		return RC_TO_INT(EDashlaneError::InvalidParameter);
-	}
-
-	auto pContext = Dashlane::s_contexts.emplace_back(std::make_shared<Dashlane::DashlaneContextInternal>(szLogin, szApplicationName));
-
-	pContext->secrets.app.accessKey = szAppAccessKey;
-	pContext->secrets.app.secretKey = szAppSecretKey;
-
-	*ppContext = pContext.get();
-
-	pContext->pDatabase = std::make_unique<Dashlane::CDatabase>();
-	if (!pContext->pDatabase->Connect())
-	{
-		return RC_TO_INT(EDashlaneError::FailedDatabaseConnection);
-	}
-
-	if (!pContext->pDatabase->Prepare())
-	{
-		return RC_TO_INT(EDashlaneError::FailedDatabaseCreation);
-	}
-
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_InitQueryContext(DashlaneQueryContext** ppQueryContext)
-{
-	if (ppQueryContext == nullptr)
-		return RC_TO_INT(EDashlaneError::InvalidParameter);
-
-	*ppQueryContext = Dashlane::s_queryContexts.emplace_back(std::make_shared<Dashlane::DashlaneQueryContextInternal>()).get();
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-void Dash_FreeContext(DashlaneContext* pContext)
-{
-	if (pContext != nullptr)
-	{
-		std::erase_if(Dashlane::s_contexts, [pContext](std::shared_ptr<Dashlane::DashlaneContextInternal> pElem)
-		{
-			return pElem.get() == static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-		});
-	}
-}
-
-void Dash_FreeQueryContext(DashlaneQueryContext* pQueryContext)
-{
-	if (pQueryContext != nullptr)
-	{
-		std::erase_if(Dashlane::s_queryContexts, [pQueryContext](std::shared_ptr<Dashlane::DashlaneQueryContextInternal> pElem)
-		{
-			return pElem.get() == static_cast<Dashlane::DashlaneQueryContextInternal*>(pQueryContext);
-		});
-	}
-}
-
-uint32_t Dash_AssignMasterPassword(DashlaneContext* pContext, const char* szMasterPassword)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_STRLEN(szMasterPassword, EDashlaneError::InvalidParameter);
-
-	pInternalContext->secrets.masterPassword = szMasterPassword;
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_AssignEmailToken(DashlaneContext* pContext, const char* szEmailToken)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_STRLEN(szEmailToken, EDashlaneError::InvalidParameter);
-
-	pInternalContext->secrets.emailToken = szEmailToken;
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_Assign2FACode(DashlaneContext* pContext, const char* sz2FACode)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_STRLEN(sz2FACode, EDashlaneError::InvalidParameter);
-
-	pInternalContext->secrets.twoFactorCode = sz2FACode;
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-void Dash_ClearMasterPassword(DashlaneContext* pContext)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER_VOID(pInternalContext);
-
-	pInternalContext->secrets.masterPassword.clear();
-}
-
-void Dash_ClearEmailToken(DashlaneContext* pContext)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER_VOID(pInternalContext);
-
-	pInternalContext->secrets.emailToken.clear();
-}
-
-void Dash_Clear2FACode(DashlaneContext* pContext)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER_VOID(pInternalContext);
-
-	pInternalContext->secrets.twoFactorCode.clear();
-}
-
-uint32_t Dash_AddQueryTransactionTypes(DashlaneQueryContext* pQueryContext, uint32_t types)
-{
-	auto pInternalQueryContext = static_cast<Dashlane::DashlaneQueryContextInternal*>(pQueryContext);
-
-	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
-
-#ifdef _DEBUG
-	if (types > bitmask<Dashlane::ERawTransactionType>::all().value)
-		return RC_TO_INT(EDashlaneError::InvalidParameter);
-#endif
-
-	pInternalQueryContext->typeMask |= (Dashlane::ERawTransactionType)types;
-
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_AddQueryFilter(DashlaneQueryContext* pQueryContext, const char* szName, const char* szWildcard)
-{
-	auto pInternalQueryContext = static_cast<Dashlane::DashlaneQueryContextInternal*>(pQueryContext);
-
-	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
-	ENSURE_STRLEN(szName, EDashlaneError::InvalidParameter);
-
-	pInternalQueryContext->filters[szName] = szWildcard;
-
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_SetQueryWriter(DashlaneQueryContext* pQueryContext, Dash_QueryWriterFunc writer, void* pUserPointer)
-{
-	auto pInternalQueryContext = static_cast<Dashlane::DashlaneQueryContextInternal*>(pQueryContext);
-
-	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
-	ENSURE_POINTER(writer, EDashlaneError::InvalidParameter);
-
-	pInternalQueryContext->writerFunc = writer;
-	pInternalQueryContext->pUserPointer = pUserPointer;
-
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_SynchronizeVaultData(DashlaneContext* pContext)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-
-	EDashlaneError rc = GetOrUpdateSecrets(*pInternalContext);
-
-	if (rc == EDashlaneError::NoError)
-	{
-		Dashlane::SGetLatestContentResponse latestContent;
-		rc = Dashlane::GetLatestContent(*pInternalContext, pInternalContext->pDatabase->GetLastSyncTime(*pInternalContext), latestContent);
-		if (rc == EDashlaneError::NoError)
-		{
-			std::vector<Dashlane::STransactionRow> rows;
-
-			for (const auto& transactionBase : latestContent.transactions)
-			{
-				switch (transactionBase->GetAction())
-				{
-
-				case Dashlane::ETransactionAction::BackupEdit:
-				{
-					const std::vector<uint8_t> encryptedContent = Utility::StringToVectorU8(transactionBase->GetContent());
-					std::string recryptedContent;
-					if (rc = RecryptTransactionContent(*pInternalContext, transactionBase->GetContent(), recryptedContent); rc != EDashlaneError::NoError)
-					{
-						// Most likely, master password is incorrect
-						pInternalContext->secrets.masterPassword.clear();
-						return RC_TO_INT(EDashlaneError::InvalidMasterPassword);
-					}
-
-					rows.emplace_back(
-						pInternalContext->login,
-						transactionBase->GetIdentifier(),
-						transactionBase->GetType(),
-						transactionBase->GetActionName(),
-						recryptedContent);
-				} break;
-
-				case Dashlane::ETransactionAction::BackupRemove:
-				{
-					const auto& transaction = static_cast<const Dashlane::SRawTransactionBackupRemove&>(*transactionBase);
-					rows.emplace_back(
-						pInternalContext->login,
-						transactionBase->GetIdentifier(),
-						transactionBase->GetType(),
-						transactionBase->GetActionName(),
-						""
-					);
-				} break;
-
-				}
-			}
-
-			if (!pInternalContext->pDatabase->AddMultipleTransactionData(rows))
-				return RC_TO_INT(EDashlaneError::DatabaseTransactionFailure);
-
-			if (!pInternalContext->pDatabase->UpdateLastSyncTime(*pInternalContext, latestContent.timestamp))
-				return RC_TO_INT(EDashlaneError::DatabaseTransactionFailure);
-		}
-
-		if (pInternalContext->applicationData.shouldUpdateDeviceConfiguration)
-		{
-			rc = UpdateDeviceConfiguration(*pInternalContext);
-		}
-	}
-	else
-	{
-		if (rc == EDashlaneError::InvalidMasterPassword)
-			pInternalContext->secrets.masterPassword.clear();
-	}
-
-	return RC_TO_INT(rc);
-}
-
-std::string::const_iterator FindCaseInsensitive(const std::string& haystack, const std::string& needle)
-{
-	return std::search(haystack.cbegin(), haystack.cend(), needle.cbegin(), needle.cend(),
-		[](const char lhs, const char rhs) { return std::tolower(lhs) == std::tolower(rhs); });
-}
-
-bool FindAnyValue(const nlohmann::ordered_json& json, const std::string& value)
-{
-	for (const auto& element : json.items())
-	{
-		const std::string elementValue = element.value().get<std::string>();
-		if (FindCaseInsensitive(elementValue, value) != elementValue.cend())
-			return true;
-	}
-
-	return false;
-}
-
-bool FindKeyValue(const nlohmann::ordered_json& json, const std::string& key, const std::string& value)
-{
-	if (json.contains(key))
-	{
-		std::string elementValue = json.find(key).value().get<std::string>();
-		if (FindCaseInsensitive(elementValue, value) != elementValue.cend())
-			return true;
-	}
-
-	return false;
-}
-
-uint32_t Dash_QueryTransactions(DashlaneContext* pContext, DashlaneQueryContext* pQueryContext)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-	auto pInternalQueryContext = static_cast<Dashlane::DashlaneQueryContextInternal*>(pQueryContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
-
-	EDashlaneError rc = GetOrUpdateSecrets(*pInternalContext);
-	if (rc != EDashlaneError::NoError)
-	{
-		if (rc == EDashlaneError::InvalidMasterPassword)
-			pInternalContext->secrets.masterPassword.clear();
-
-		return RC_TO_INT(rc);
-	}
-
-	Dashlane::SDeviceConfiguration config;
-	const bool haveConfig = pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config);
-	if (config.autoSync || !haveConfig)
-	{
-		const uint64_t lastSyncTime = pInternalContext->pDatabase->GetLastSyncTime(*pInternalContext);
-		const uint64_t nextSyncTime = lastSyncTime + 3600;
-		if (nextSyncTime < Utility::GetUnixTimestamp())
-		{
-			rc = (EDashlaneError)Dash_SynchronizeVaultData(pContext);
-			if (rc != EDashlaneError::NoError)
-				return RC_TO_INT(rc);
-		}
-	}
-
-	std::vector<Dashlane::SRawTransactionBackupEdit> transactions;
-	rc = pInternalContext->pDatabase->GetTransactions(*pInternalContext, pInternalQueryContext->typeMask, transactions);
-	if (rc != EDashlaneError::NoError)
-		return RC_TO_INT(rc);
-
-	for (const Dashlane::SRawTransactionBackupEdit& transaction : transactions)
-	{
-		nlohmann::ordered_json json;
-		rc = ProcessTransaction(*pInternalContext, transaction, json);
-		if (rc != EDashlaneError::NoError)
-		{
-			if (rc == EDashlaneError::InvalidMasterPassword)
-				pInternalContext->secrets.masterPassword.clear();
-
-			return RC_TO_INT(rc);
-		}
-
-		bool isMatch = false;
-		if (pInternalQueryContext->filters.size() > 0)
-		{
-			for (const auto& filter : pInternalQueryContext->filters)
-			{
-				const std::string& key = filter.first;
-				const std::string& needle = filter.second;
-
-				if (needle.size() == 0)
-				{
-					if (FindAnyValue(json, key))
-						isMatch = true;
-				}
-				else
-				{
-					if (FindKeyValue(json, key, needle))
-						isMatch = true;
-				}
-
-				if (isMatch)
-					break;
-			}
-		}
-		else
-			isMatch = true;
-
-		if (isMatch)
-			pInternalQueryContext->writerFunc(pInternalQueryContext->pUserPointer, json.dump().c_str(), json.size());
-
-		if (pInternalContext->applicationData.shouldUpdateDeviceConfiguration)
-			rc = UpdateDeviceConfiguration(*pInternalContext);
-	}
-
-	return RC_TO_INT(rc);
-}
-
-uint32_t Dash_ResetVaultData(DashlaneContext* pContext, bool removeAllUsers)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
-
-	if (!removeAllUsers)
-	{
-		if (pInternalContext->login.empty())
-		{
-			return RC_TO_INT(EDashlaneError::InvalidContext);
-		}
-		else
-		{
-			DeleteLocalKey(*pInternalContext);
-			pInternalContext->pDatabase->RemoveUserData(*pInternalContext);
-		}
-	}
-	else
-	{
-		std::vector<std::string> users;
-		pInternalContext->pDatabase->GetRegisteredUsers(users);
-
-		for (const auto& user : users)
-		{
-			Dashlane::DashlaneContextInternal ctx(user.c_str(), pInternalContext->applicationName.c_str());
-			DeleteLocalKey(ctx);
-		}
-
-		// Quicker to just drop all the tables and recreate them if needed
-		pInternalContext->pDatabase->Drop();
-	}
-
-	return (uint32_t)EDashlaneError::NoError;
-}
-
-uint32_t Dash_SetShouldStoreMasterPassword(DashlaneContext* pContext, bool shouldStoreMasterPassword)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
-
-	Dashlane::SDeviceConfiguration config;
-	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
-		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
-
-	config.shouldNotSaveMasterPassword = !shouldStoreMasterPassword;
-
-	if (!shouldStoreMasterPassword && !config.masterPasswordEncrypted.empty())
-		config.masterPasswordEncrypted.clear();
-
-	if (!pInternalContext->pDatabase->SetDeviceConfiguration(config))
-		return RC_TO_INT(EDashlaneError::UpdateConfigFailed);
-
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_GetShouldStoreMasterPassword(DashlaneContext* pContext, bool* pShouldStoreMasterPasswordOut)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
-
-	Dashlane::SDeviceConfiguration config;
-	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
-		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
-
-	*pShouldStoreMasterPasswordOut = !config.shouldNotSaveMasterPassword;
-
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_SetAutoSync(DashlaneContext* pContext, bool autoSync)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
-
-	Dashlane::SDeviceConfiguration config;
-	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
-		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
-
-	config.autoSync = autoSync;
-
-	if (!pInternalContext->pDatabase->SetDeviceConfiguration(config))
-		return RC_TO_INT(EDashlaneError::UpdateConfigFailed);
-
-	return RC_TO_INT(EDashlaneError::NoError);
-}
-
-uint32_t Dash_GetAutoSync(DashlaneContext* pContext, bool* pAutoSync)
-{
-	auto pInternalContext = static_cast<Dashlane::DashlaneContextInternal*>(pContext);
-
-	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
-	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
-
-	Dashlane::SDeviceConfiguration config;
-	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
-		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
-
-	*pAutoSync = config.autoSync;
-
-	return RC_TO_INT(EDashlaneError::NoError);
+#include "StdAfx.h"
+#include "Dashlane.h"
+#include "Encryption.h"
+#include "EnvelopeCodec.h"
+#include "Keychain.h"
+#include "QueryCursor.h"
+#include "SecretStore.h"
+#include "Api/Endpoints/GetLatestContent.h"
+#include "Types/Transactions.h"
+#include "Utility/Arena.h"
+#include "Utility/Base64.h"
+#include "Utility/Strings.h"
+#include "Utility/Environment.h"
+#include "Utility/SlotMap.h"
+#include "Utility/Time.h"
+#include "Utility/Transaction.h"
+#include "Utility/Vector.h"
+#include "Utility/Zip.h"
+
+#define ENSURE_POINTER(ptr, rc_error) 			   \
+	if (ptr == nullptr) return RC_TO_INT(rc_error) \
+
+#define ENSURE_STRLEN(str, rc_error) 				      \
+	if (std::strlen(str) == 0) return RC_TO_INT(rc_error) \
+
+#define ENSURE_POINTER_VOID(ptr) \
+	if (ptr == nullptr) return   \
+
+#define ENSURE_STRLEN_VOID(str) 	  \
+	if (std::strlen(str) == 0) return \
+
+inline uint32_t RC_TO_INT(EDashlaneError rc)
+{
+	return static_cast<uint32_t>(rc);
+}
+
+namespace Dashlane
+{
+
+	EDashlaneError EncryptAndSerialize(
+		const DashlaneContextInternal& context,
+		std::span<const uint8_t> input,
+		std::string& output
+	)
+	{
+		DASH_STAT_TIMER(context.pStats, Encrypt);
+		DASH_TRACE_SPAN(context.pTrace, "Encrypt", "crypto");
+
+		// Encrypt
+		Dashlane::CEncryption encryptor;
+		Dashlane::SEncryptedData encryptedDataOut;
+		if (!encryptor.EncryptData(context.secrets.localKey, input, encryptedDataOut))
+		{
+			return EDashlaneError::InternalEncryptFailure;
+		}
+
+		// Serialize
+		std::vector<uint8_t> serialized;
+		WriteEnvelope(encryptedDataOut, serialized);
+
+		// Encode
+		Utility::EncodeBase64(serialized, output);
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError DecodeEnvelope(
+		const DashlaneContextInternal& context,
+		const std::string& input,
+		std::pmr::vector<uint8_t>& decoded,
+		Dashlane::SEncryptedDataView& envelope,
+		Utility::SecureBuffer& derivedKey,
+		std::span<const uint8_t>& symmetricKey
+	)
+	{
+		// Decode, the deserialized fields are views over the decoded envelope
+		{
+			DASH_STAT_TIMER(context.pStats, Decode);
+			DASH_TRACE_SPAN(context.pTrace, "Decode", "crypto");
+
+			if (!Utility::DecodeBase64(input, decoded))
+			{
+				return EDashlaneError::InternalDecryptFailure;
+			}
+
+			// Deserialize
+			if (!ReadEnvelope(decoded, envelope))
+			{
+				return EDashlaneError::InternalDecryptFailure;
+			}
+		}
+
+		symmetricKey = context.secrets.localKey;
+		if (envelope.GetKeyDerivation().GetDerivation() != Dashlane::EDerivationAlgorithm::None)
+		{
+			Dashlane::CEncryption encryption(decoded.get_allocator().resource());
+			EDashlaneError rc = encryption.GetSymmetricKeyFromData(context, decoded, envelope, derivedKey);
+			if (rc != EDashlaneError::NoError)
+				return rc;
+
+			symmetricKey = derivedKey;
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError DeserializeAndDecrypt(
+		const DashlaneContextInternal& context,
+		const std::string& input,
+		std::pmr::vector<uint8_t>& output
+	)
+	{
+		// Intermediate buffers share the memory resource of the output
+		std::pmr::memory_resource* pResource = output.get_allocator().resource();
+
+		std::pmr::vector<uint8_t> decoded(pResource);
+		Dashlane::SEncryptedDataView encryptedData;
+		Utility::SecureBuffer derivedKey;
+		std::span<const uint8_t> symmetricKey;
+		if (EDashlaneError rc = DecodeEnvelope(context, input, decoded, encryptedData, derivedKey, symmetricKey); rc != EDashlaneError::NoError)
+		{
+			return rc;
+		}
+
+		// Decrypt
+		DASH_STAT_TIMER(context.pStats, Decrypt);
+		DASH_TRACE_SPAN(context.pTrace, "Decrypt", "crypto");
+
+		Dashlane::CEncryption encryption(pResource);
+		if (!encryption.DecryptFromView(symmetricKey, encryptedData))
+		{
+			return EDashlaneError::InternalDecryptFailure;
+		}
+
+		output = encryption.TakeOutput();
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError DeserializeAndDecrypt(
+		const DashlaneContextInternal& context,
+		const std::string& input,
+		Utility::SecureBuffer& output
+	)
+	{
+		// Intermediate copies of the plaintext are wiped with the arena
+		Utility::CTransientArena arena(SMALL_ARENA_CHUNK_SIZE);
+		std::pmr::vector<uint8_t> decrypted(&arena);
+
+		if (EDashlaneError rc = DeserializeAndDecrypt(context, input, decrypted); rc != EDashlaneError::NoError)
+		{
+			return rc;
+		}
+
+		output.assign(decrypted.begin(), decrypted.end());
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError RecryptTransactionContent(const DashlaneContextInternal& context, const std::string& content, std::string& output)
+	{
+		Utility::CTransientArena arena(SMALL_ARENA_CHUNK_SIZE);
+
+		// Decode, Deserialize, Decrypt
+		std::pmr::vector<uint8_t> decrypted(&arena);
+
+		if (EDashlaneError rc = DeserializeAndDecrypt(context, content, decrypted); rc != EDashlaneError::NoError)
+		{
+			return rc;
+		}
+
+		if (EDashlaneError rc = EncryptAndSerialize(context, decrypted, output); rc != EDashlaneError::NoError)
+		{
+			return rc;
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError ProcessTransaction(
+		const DashlaneContextInternal& context,
+		const Dashlane::SRawTransactionBackupEdit& transaction,
+		nlohmann::ordered_json& jsonOut,
+		std::pmr::memory_resource* pResource
+	)
+	{
+		Utility::CScopedTraceSpan span(context.pTrace.get(), "ProcessTransaction", "item");
+		span.AddArg("type", transaction.type);
+
+		// Decode, Deserialize, Decrypt
+		std::pmr::vector<uint8_t> decrypted(pResource);
+		if (EDashlaneError rc = DeserializeAndDecrypt(context, transaction.content, decrypted); rc != EDashlaneError::NoError)
+		{
+			return rc;
+		}
+
+		return DecodeTransactionContent(context, decrypted, jsonOut, pResource);
+	}
+
+	EDashlaneError DecodeTransactionFields(
+		const DashlaneContextInternal& context,
+		const std::pmr::vector<uint8_t>& decrypted,
+		std::pmr::vector<uint8_t>& decompressed,
+		Utility::TransactionFields& fields,
+		ETransactionType& type
+	)
+	{
+		// Decompress
+		{
+			DASH_STAT_TIMER(context.pStats, Inflate);
+			DASH_TRACE_SPAN(context.pTrace, "Inflate", "item");
+			const auto compressed = Utility::SliceVectorBySpan(decrypted, 6);
+			Utility::InflateRaw(compressed, decompressed);
+		}
+
+		// XML fields, parsed in place
+		DASH_STAT_TIMER(context.pStats, Parse);
+		DASH_TRACE_SPAN(context.pTrace, "Parse", "item");
+		type = Utility::XmlToTransactionFields(decompressed, fields);
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError DecodeTransactionContent(
+		const DashlaneContextInternal& context,
+		const std::pmr::vector<uint8_t>& decrypted,
+		nlohmann::ordered_json& jsonOut,
+		std::pmr::memory_resource* pResource
+	)
+	{
+		std::pmr::vector<uint8_t> decompressed(pResource);
+		Utility::TransactionFields fields(pResource);
+		ETransactionType type = ETransactionType::Unknown;
+		if (EDashlaneError rc = DecodeTransactionFields(context, decrypted, decompressed, fields, type); rc != EDashlaneError::NoError)
+		{
+			return rc;
+		}
+
+		// Json of the fields
+		DASH_STAT_TIMER(context.pStats, JsonBuild);
+		jsonOut = Utility::TransactionFieldsToJson(type, fields, pResource);
+
+		return EDashlaneError::NoError;
+	}
+
+	// Collects the rows to store and the identifiers to remove for a GetLatestContent delta.
+	// Items whose server revision (backupDate) matches the stored revision are not recrypted again.
+	EDashlaneError CollectTransactionChanges(
+		const DashlaneContextInternal& context,
+		const SGetLatestContentResponse& latestContent,
+		std::map<std::string, uint32_t>& revisions,
+		std::map<std::string, STransactionRow>& rows,
+		std::set<std::string>& removals,
+		bool& isPasswordVerified)
+	{
+		for (const auto& transactionBase : latestContent.transactions)
+		{
+			const std::string identifier = transactionBase->GetIdentifier();
+
+			switch (transactionBase->GetAction())
+			{
+
+			case ETransactionAction::BackupEdit:
+			{
+				const uint32_t backupDate = transactionBase->GetBackupDate();
+				if (const auto it = revisions.find(identifier); it != revisions.end() && it->second == backupDate)
+					break;
+
+				const bool isLazy = context.syncPolicy.lazyRecrypt;
+
+				std::string recryptedContent;
+				if (isLazy && isPasswordVerified)
+				{
+					recryptedContent = transactionBase->GetContent();
+				}
+				else if (isLazy)
+				{
+					// Envelopes are stored as they are, a single one is decrypted to detect an invalid master password
+					Utility::SecureBuffer decrypted;
+					if (EDashlaneError rc = DeserializeAndDecrypt(context, transactionBase->GetContent(), decrypted); rc != EDashlaneError::NoError)
+						return EDashlaneError::InvalidMasterPassword;
+
+					recryptedContent = transactionBase->GetContent();
+					isPasswordVerified = true;
+				}
+				else if (EDashlaneError rc = RecryptTransactionContent(context, transactionBase->GetContent(), recryptedContent); rc != EDashlaneError::NoError)
+				{
+					// Most likely, master password is incorrect
+					return EDashlaneError::InvalidMasterPassword;
+				}
+				else
+				{
+					isPasswordVerified = true;
+				}
+
+				rows.insert_or_assign(identifier, STransactionRow(
+					context.login,
+					identifier,
+					transactionBase->GetType(),
+					transactionBase->GetActionName(),
+					recryptedContent,
+					backupDate,
+					!isLazy));
+
+				removals.erase(identifier);
+				revisions[identifier] = backupDate;
+			} break;
+
+			case ETransactionAction::BackupRemove:
+			{
+				rows.erase(identifier);
+
+				if (revisions.erase(identifier) > 0)
+					removals.insert(identifier);
+			} break;
+
+			}
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+	// Compares the local revisions against the summary of the server vault.
+	// Items missing locally or with a different revision need to be fetched again, items unknown to the server are removed.
+	void FindSummaryDrift(
+		const SGetLatestContentResponse& latestContent,
+		const std::map<std::string, uint32_t>& revisions,
+		std::vector<std::string>& outdated,
+		std::set<std::string>& removals)
+	{
+		std::map<std::string, uint64_t> expected;
+		for (const auto& [type, items] : latestContent.summary)
+			expected.insert(items.begin(), items.end());
+
+		for (const auto& [identifier, backupDate] : expected)
+		{
+			const auto it = revisions.find(identifier);
+			if (it == revisions.end() || it->second != backupDate)
+				outdated.emplace_back(identifier);
+		}
+
+		for (const auto& [identifier, backupDate] : revisions)
+		{
+			if (!expected.contains(identifier))
+				removals.insert(identifier);
+		}
+	}
+
+	EDashlaneError SynchronizeVaultData(DashlaneContextInternal& context)
+	{
+		DASH_TRACE_SPAN(context.pTrace, "SynchronizeVaultData", "sync");
+
+		SGetLatestContentResponse latestContent;
+		EDashlaneError rc = GetLatestContent(context, context.pDatabase->GetLastServerSyncTime(context), latestContent);
+		if (rc != EDashlaneError::NoError)
+			return rc;
+
+		std::map<std::string, uint32_t> revisions;
+		context.pDatabase->GetTransactionRevisions(context, revisions);
+
+		std::map<std::string, STransactionRow> rows;
+		std::set<std::string> removals;
+		bool isPasswordVerified = false;
+
+		rc = CollectTransactionChanges(context, latestContent, revisions, rows, removals, isPasswordVerified);
+
+		// Repair only the items that drifted from the server summary
+		if (rc == EDashlaneError::NoError && !latestContent.summary.empty())
+		{
+			std::vector<std::string> outdated;
+			FindSummaryDrift(latestContent, revisions, outdated, removals);
+
+			for (const std::string& identifier : removals)
+				revisions.erase(identifier);
+
+			if (!outdated.empty())
+			{
+				SGetLatestContentResponse repairContent;
+				rc = GetLatestContent(context, latestContent.timestamp, repairContent, outdated);
+				if (rc == EDashlaneError::NoError)
+					rc = CollectTransactionChanges(context, repairContent, revisions, rows, removals, isPasswordVerified);
+			}
+		}
+
+		if (rc == EDashlaneError::InvalidMasterPassword)
+			Utility::SecureClear(context.secrets.masterPassword);
+
+		if (rc != EDashlaneError::NoError)
+			return rc;
+
+		if (isPasswordVerified)
+			RemoveStaleDerivedKeys(context);
+
+		std::vector<STransactionRow> changedRows;
+		changedRows.reserve(rows.size());
+		for (auto& [identifier, row] : rows)
+			changedRows.emplace_back(std::move(row));
+
+		const std::vector<std::string> removedIdentifiers(removals.begin(), removals.end());
+
+		// Single database transaction, concurrent readers see either the previous or the updated vault
+		DASH_STAT_TIMER(context.pStats, SqliteWrite);
+		if (!context.pDatabase->ApplyTransactionChanges(context, changedRows, removedIdentifiers, latestContent.timestamp))
+			return EDashlaneError::DatabaseTransactionFailure;
+
+		return EDashlaneError::NoError;
+	}
+
+	std::unique_ptr<DashlaneContextInternal> CreateSyncContext(const DashlaneContextInternal& context)
+	{
+		// Not make_unique, which would bypass the secure pool operator new of the context
+		std::unique_ptr<DashlaneContextInternal> pSyncContext(new DashlaneContextInternal(context.login.c_str(), context.applicationName.c_str()));
+		pSyncContext->secrets = context.secrets;
+		pSyncContext->network = context.network;
+		pSyncContext->syncPolicy = context.syncPolicy;
+		pSyncContext->pStats = context.pStats;
+		pSyncContext->pTrace = context.pTrace;
+		pSyncContext->pSecretStore = context.pSecretStore;
+		pSyncContext->pDatabase = std::make_unique<CDatabase>(context.pDatabase->GetPath());
+		pSyncContext->pDatabase->SetTraceWriter(context.pTrace);
+
+		return pSyncContext;
+	}
+
+	EDashlaneError SynchronizeVaultDataUnlocked(DashlaneContextInternal& context, std::unique_lock<std::shared_mutex>& lock)
+	{
+		const std::unique_ptr<DashlaneContextInternal> pSyncContext = CreateSyncContext(context);
+
+		// The copy shares the connection pool of the vault file, its single writer serializes the storage
+		lock.unlock();
+		EDashlaneError rc = EDashlaneError::FailedDatabaseConnection;
+		{
+			std::lock_guard<std::mutex> syncLock(context.syncMutex);
+			if (pSyncContext->pDatabase->Connect())
+				rc = SynchronizeVaultData(*pSyncContext);
+		}
+		lock.lock();
+
+		context.network.serverClockOffset = pSyncContext->network.serverClockOffset;
+
+		// The master password may have been changed in the meantime, the outcome only applies to the one synchronized
+		const auto& syncKeys = pSyncContext->secrets.derivedKeys;
+		if (GetDerivedKeyIdentifier(context, Utility::AsBytes(context.secrets.masterPassword)) == syncKeys.passwordTag)
+		{
+			if (rc == EDashlaneError::InvalidMasterPassword)
+				Utility::SecureClear(context.secrets.masterPassword);
+
+			context.secrets.derivedKeys.isPasswordVerified |= syncKeys.isPasswordVerified;
+		}
+
+		return rc;
+	}
+
+	void WaitForSyncWorker(DashlaneContextInternal& context, std::unique_lock<std::shared_mutex>& lock)
+	{
+		// The completion callback itself does not wait for the synchronization it reports
+		while (context.syncWorker.IsRunning() && !context.syncWorker.IsWorkerThread())
+		{
+			lock.unlock();
+			context.syncWorker.Wait();
+			lock.lock();
+		}
+	}
+
+	// Applies the sync policy while the local vault can be served, a stale vault is refreshed in the background.
+	// False when the vault is too old to be served before a synchronization completes. Only needs the state lock shared
+	static bool RefreshVaultInBackground(DashlaneContextInternal& context)
+	{
+		SDeviceConfiguration config;
+		const bool haveConfig = context.pDatabase->GetDeviceConfiguration(context, config);
+		if (haveConfig && !config.autoSync)
+			return true;
+
+		const uint64_t now = Utility::GetUnixTimestamp();
+		const uint64_t lastSyncTime = context.pDatabase->GetLastSyncTime(context);
+
+		if (lastSyncTime + context.syncPolicy.staleAfterSeconds >= now)
+			return true;
+
+		// Serve the local copy right away and refresh it in the background, unless it is too old to be trusted
+		const uint32_t maxStaleSeconds = context.syncPolicy.maxStaleSeconds;
+		const bool isUsable = lastSyncTime != 0 && (maxStaleSeconds == 0 || lastSyncTime + maxStaleSeconds >= now);
+		if (isUsable)
+			context.syncWorker.Start(context, context.syncPolicy.completedFunc, context.syncPolicy.pUserPointer);
+
+		return isUsable;
+	}
+
+	// Secrets already resolved by GetOrUpdateSecrets for the current master password, it would change nothing
+	static bool HasVaultSecrets(const DashlaneContextInternal& context)
+	{
+		const auto& secrets = context.secrets;
+		return !secrets.localKey.empty()
+			&& !secrets.device.accessKey.empty()
+			&& !secrets.masterPassword.empty()
+			&& !secrets.derivedKeys.passwordTag.empty()
+			&& !context.applicationData.shouldUpdateDeviceConfiguration;
+	}
+
+	EDashlaneError RefreshVaultData(DashlaneContextInternal& context, std::unique_lock<std::shared_mutex>& lock)
+	{
+		if (RefreshVaultInBackground(context))
+			return EDashlaneError::NoError;
+
+		WaitForSyncWorker(context, lock);
+		return SynchronizeVaultDataUnlocked(context, lock);
+	}
+
+	EDashlaneError PrepareVaultRead(DashlaneContextInternal& context)
+	{
+		// Unlocked context: lookups and queries on several threads do not wait for each other
+		{
+			std::shared_lock lock(context.stateMutex);
+			if (HasVaultSecrets(context) && RefreshVaultInBackground(context))
+				return EDashlaneError::NoError;
+		}
+
+		std::unique_lock lock(context.stateMutex);
+
+		EDashlaneError rc = GetOrUpdateSecrets(context);
+		if (rc != EDashlaneError::NoError)
+		{
+			if (rc == EDashlaneError::InvalidMasterPassword)
+				Utility::SecureClear(context.secrets.masterPassword);
+
+			return rc;
+		}
+
+		return RefreshVaultData(context, lock);
+	}
+
+	EDashlaneError RecryptPendingTransactions(DashlaneContextInternal& context)
+	{
+		DASH_TRACE_SPAN(context.pTrace, "RecryptPendingTransactions", "sync");
+
+		// Walks the pending rows by identifier, rows skipped by UpdateRecryptedTransactions are not fetched again
+		std::string lastIdentifier;
+		std::vector<SRawTransactionBackupEdit> transactions;
+		std::vector<STransactionRow> rows;
+
+		do
+		{
+			transactions.clear();
+			rows.clear();
+
+			context.pDatabase->GetPendingRecryptTransactions(context, lastIdentifier, QUERY_BATCH_SIZE, transactions);
+
+			for (const SRawTransactionBackupEdit& transaction : transactions)
+			{
+				std::string recryptedContent;
+				if (EDashlaneError rc = RecryptTransactionContent(context, transaction.content, recryptedContent); rc != EDashlaneError::NoError)
+					return EDashlaneError::InvalidMasterPassword;
+
+				rows.emplace_back(context.login, transaction.identifier, transaction.type, transaction.GetActionName(), recryptedContent, transaction.backupDate);
+			}
+
+			DASH_STAT_TIMER(context.pStats, SqliteWrite);
+			if (!rows.empty() && !context.pDatabase->UpdateRecryptedTransactions(context, rows))
+				return EDashlaneError::DatabaseTransactionFailure;
+
+			if (!transactions.empty())
+				lastIdentifier = transactions.back().identifier;
+		}
+		while (transactions.size() == QUERY_BATCH_SIZE);
+
+		return EDashlaneError::NoError;
+	}
+
+	bool ContainsCaseInsensitive(std::string_view haystack, std::string_view needle)
+	{
+		return std::search(haystack.cbegin(), haystack.cend(), needle.cbegin(), needle.cend(),
+			[](const char lhs, const char rhs) { return std::tolower(lhs) == std::tolower(rhs); }) != haystack.cend();
+	}
+
+	bool FindAnyValue(const nlohmann::ordered_json& json, const std::string& value)
+	{
+		for (const auto& element : json.items())
+		{
+			if (ContainsCaseInsensitive(element.value().get_ref<const std::string&>(), value))
+				return true;
+		}
+
+		return false;
+	}
+
+	bool FindKeyValue(const nlohmann::ordered_json& json, const std::string& key, const std::string& value)
+	{
+		if (const auto it = json.find(key); it != json.end())
+			return ContainsCaseInsensitive(it->get_ref<const std::string&>(), value);
+
+		return false;
+	}
+
+	bool FindAnyValue(const Utility::TransactionFields& fields, const std::string& value)
+	{
+		return std::ranges::any_of(fields, [&value](const auto& field) { return ContainsCaseInsensitive(field.second, value); });
+	}
+
+	bool FindKeyValue(const Utility::TransactionFields& fields, const std::string& key, const std::string& value)
+	{
+		if (const auto it = std::ranges::find(fields, std::string_view(key), &Utility::TransactionFields::value_type::first); it != fields.end())
+			return ContainsCaseInsensitive(it->second, value);
+
+		return false;
+	}
+
+	// Any filter may match, a filter without value matches its name against every value
+	template<typename TFields>
+	bool MatchesAnyQueryFilter(const DashlaneQueryContextInternal& query, const TFields& fields)
+	{
+		if (query.filters.empty())
+			return true;
+
+		for (const auto& filter : query.filters)
+		{
+			const std::string& key = filter.first;
+			const std::string& needle = filter.second;
+
+			if (needle.size() == 0)
+			{
+				if (FindAnyValue(fields, key))
+					return true;
+			}
+			else
+			{
+				if (FindKeyValue(fields, key, needle))
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool MatchesQueryFilters(const DashlaneQueryContextInternal& query, const nlohmann::ordered_json& json)
+	{
+		return MatchesAnyQueryFilter(query, json);
+	}
+
+	bool MatchesQueryFilters(const DashlaneQueryContextInternal& query, const Utility::TransactionFields& fields)
+	{
+		return MatchesAnyQueryFilter(query, fields);
+	}
+
+	namespace
+	{
+		template<typename TView>
+		struct STransactionViewField
+		{
+			std::string_view key;
+			DashlaneStringView TView::* pString{ nullptr };
+			bool TView::* pFlag{ nullptr };	// Set when the value is not "false", as when parsed from JSON
+		};
+
+		constexpr STransactionViewField<DashlaneAuthentifiantView> AUTHENTIFIANT_VIEW_FIELDS[] =
+		{
+			{ "Title", &DashlaneAuthentifiantView::title },
+			{ "Email", &DashlaneAuthentifiantView::email },
+			{ "Login", &DashlaneAuthentifiantView::login },
+			{ "Password", &DashlaneAuthentifiantView::password },
+			{ "Url", &DashlaneAuthentifiantView::url },
+			{ "SecondaryLogin", &DashlaneAuthentifiantView::secondaryLogin },
+			{ "Category", &DashlaneAuthentifiantView::category },
+			{ "Note", &DashlaneAuthentifiantView::note },
+			{ "LastBackupTime", &DashlaneAuthentifiantView::lastBackupTime },
+			{ "OtpSecret", &DashlaneAuthentifiantView::otpSecret },
+			{ "AppMetaData", &DashlaneAuthentifiantView::appMetaData },
+			{ "Status", &DashlaneAuthentifiantView::status },
+			{ "NumberUse", &DashlaneAuthentifiantView::numberUse },
+			{ "LastUse", &DashlaneAuthentifiantView::lastUse },
+			{ "Strength", &DashlaneAuthentifiantView::strength },
+			{ "ModificationDatetime", &DashlaneAuthentifiantView::modificationDatetime },
+			{ "Id", &DashlaneAuthentifiantView::id },
+			{ "AnonId", &DashlaneAuthentifiantView::anonId },
+			{ "LocaleFormat", &DashlaneAuthentifiantView::localeFormat },
+			{ "AutoProtected", nullptr, &DashlaneAuthentifiantView::autoProtected },
+			{ "AutoLogin", nullptr, &DashlaneAuthentifiantView::autoLogin },
+			{ "SubdomainOnly", nullptr, &DashlaneAuthentifiantView::subdomainOnly },
+			{ "UseFixedUrl", nullptr, &DashlaneAuthentifiantView::useFixedUrl },
+			{ "Checked", nullptr, &DashlaneAuthentifiantView::checked }
+		};
+
+		constexpr STransactionViewField<DashlaneSecureNoteView> SECURE_NOTE_VIEW_FIELDS[] =
+		{
+			{ "Title", &DashlaneSecureNoteView::title },
+			{ "Content", &DashlaneSecureNoteView::content },
+			{ "Category", &DashlaneSecureNoteView::category },
+			{ "Type", &DashlaneSecureNoteView::type },
+			{ "CreationDatetime", &DashlaneSecureNoteView::creationDateTime },
+			{ "UpdateDate", &DashlaneSecureNoteView::updateDate },
+			{ "UserModificationDatetime", &DashlaneSecureNoteView::userModificationDatetime },
+			{ "LastBackupTime", &DashlaneSecureNoteView::lastBackupTime },
+			{ "SpaceId", &DashlaneSecureNoteView::spaceId },
+			{ "LocaleFormat", &DashlaneSecureNoteView::localeFormat },
+			{ "Id", &DashlaneSecureNoteView::id },
+			{ "AnonId", &DashlaneSecureNoteView::anonId },
+			{ "Secured", nullptr, &DashlaneSecureNoteView::secured }
+		};
+
+		template<typename TView, size_t Count>
+		void FillView(const Utility::TransactionFields& fields, const STransactionViewField<TView>(&viewFields)[Count], TView& view)
+		{
+			view = {};
+
+			for (const STransactionViewField<TView>& viewField : viewFields)
+			{
+				const auto it = std::ranges::find(fields, viewField.key, &Utility::TransactionFields::value_type::first);
+				if (it == fields.end())
+					continue;
+
+				if (viewField.pString != nullptr)
+					view.*viewField.pString = { it->second.data(), static_cast<uint32_t>(it->second.size()) };
+				else
+					view.*viewField.pFlag = it->second != "false";
+			}
+		}
+	}
+
+	void FillTransactionView(
+		ETransactionType type,
+		const Utility::TransactionFields& fields,
+		DashlaneAuthentifiantView& authentifiant,
+		DashlaneSecureNoteView& secureNote,
+		DashlaneTransactionView& view
+	)
+	{
+		view = { type, nullptr, nullptr };
+
+		switch (type)
+		{
+		case ETransactionType::Authentifiant:
+			FillView(fields, AUTHENTIFIANT_VIEW_FIELDS, authentifiant);
+			view.pAuthentifiant = &authentifiant;
+			break;
+		case ETransactionType::SecureNote:
+			FillView(fields, SECURE_NOTE_VIEW_FIELDS, secureNote);
+			view.pSecureNote = &secureNote;
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Owners of the contexts handed out by the API. The handles are generational, a freed or unknown context
+	// resolves to null and the API returns InvalidContext instead of touching freed memory
+	static Utility::CSlotMap<DashlaneContextInternal> s_contexts;
+	static Utility::CSlotMap<DashlaneQueryContextInternal> s_queryContexts;
+
+	template <typename THandle>
+	static THandle* ToHandle(uintptr_t handle)
+	{
+		return reinterpret_cast<THandle*>(handle);
+	}
+
+	static DashlaneContextInternal* ResolveContext(DashlaneContext* pContext)
+	{
+		return s_contexts.Get(reinterpret_cast<uintptr_t>(pContext));
+	}
+
+	static DashlaneQueryContextInternal* ResolveQueryContext(DashlaneQueryContext* pQueryContext)
+	{
+		return s_queryContexts.Get(reinterpret_cast<uintptr_t>(pQueryContext));
+	}
+
+	// Cursor opened by Dash_QueryOpen, with the handles of the context and query context it reads. They are resolved
+	// again by every call on the cursor, which then fails with InvalidContext once either of them was freed
+	struct SQueryCursorHandle
+	{
+		DashlaneContext* pContext;
+		DashlaneQueryContext* pQueryContext;
+		std::unique_ptr<CQueryCursor> pCursor;
+
+		bool IsValid() const
+		{
+			return ResolveContext(pContext) != nullptr && ResolveQueryContext(pQueryContext) != nullptr;
+		}
+	};
+
+	static Utility::CSlotMap<SQueryCursorHandle> s_cursors;
+
+	static CQueryCursor* ResolveCursor(DashlaneQueryCursor* pCursor)
+	{
+		const SQueryCursorHandle* pHandle = s_cursors.Get(reinterpret_cast<uintptr_t>(pCursor));
+		return pHandle != nullptr && pHandle->IsValid() ? pHandle->pCursor.get() : nullptr;
+	}
+
+}
+
+const char* Dash_GetErrorMessage(uint32_t errorCode)
+{
+	switch ((EDashlaneError)errorCode)
+	{
+	case EDashlaneError::NoError: return "Function executed successfully";
+		break;
+
+	case EDashlaneError::RequireMasterPassword: return "The context requires the Master Password to be set to continue";
+		break;
+	case EDashlaneError::Require2FACode: return "The context requires the 2FA code to be set to continue";
+		break;
+	case EDashlaneError::RequireEmailToken: return "The context requires the email token to be set to continue";
+		break;
+
+	case EDashlaneError::InvalidContext: return "The provided context is invalid";
+		break;
+	case EDashlaneError::MissingOrInvalidLogin: return "Cannot create Dashlane context with an empty Login parameter";
+		break;
+	case EDashlaneError::MissingOrInvalidAppKeys: return "Cannot create Dashlane context without valid App Keys";
+		break;
+
+	case EDashlaneError::Invalid2FACode: return "The Two-Factor authentication code provided is invalid";
+		break;
+	case EDashlaneError::InvalidEmailToken: return "The email token provided is invalid";
+		break;
+	case EDashlaneError::InvalidMasterPassword: return "The Master Password provided is invalid";
+		break;
+	case EDashlaneError::DeviceRegistrationFailed: return "Failed to register device (Incorrect authentication?)";
+		break;
+
+	case EDashlaneError::InvalidParameter: return "An invalid parameter was provided to a library function";
+		break;
+	case EDashlaneError::DeviceNotRegistered: return "This device has not been registered, this function is not available";
+		break;
+	case EDashlaneError::TransactionNotFound: return "No transaction with this identifier in the local vault";
+		break;
+
+	case EDashlaneError::InvalidAPIRequest: return "An internal error occurred and the API request failed";
+		break;
+	case EDashlaneError::NoSupportedAuth: return "No authentication methods available that are supported by this application";
+		break;
+	case EDashlaneError::FailedDatabaseConnection: return "Failed to create SQLite connection (Invalid path?)";
+		break;
+	case EDashlaneError::FailedDatabaseCreation: return "Failed to create SQLite tables or communicate with SQLite";
+		break;
+	case EDashlaneError::KeychainUnavailable: return "OS Keychain not available on this system, Master Password cannot be stored";
+		break;
+	case EDashlaneError::UpdateConfigFailed: return "Failed to update Dashlane configuration in database";
+		break;
+	case EDashlaneError::APIError_Timeout: return "The API request was not in time for the API and we couldn't recover";
+		break;
+	}
+
+	return "Unknown error code";
+}
+
+uint32_t Dash_InitContext(DashlaneContext** ppContext,
+	const char* szApplicationName,
+	const char* szLogin,
+	const char* szAppAccessKey,
+	const char* szAppSecretKey)
+{
+	return Dash_InitContextWithSecretStore(ppContext, szApplicationName, szLogin, szAppAccessKey, szAppSecretKey, ESecretStore::OSKeychain);
+}
+
+uint32_t Dash_InitContextWithSecretStore(DashlaneContext** ppContext,
+	const char* szApplicationName,
+	const char* szLogin,
+	const char* szAppAccessKey,
+	const char* szAppSecretKey,
+	ESecretStore secretStore)
+{
+	if (ppContext == nullptr ||
+		std::strlen(szApplicationName) == 0 ||
+		std::strlen(szLogin) == 0 ||
+		std::strlen(szAppAccessKey) == 0 ||
+		std::strlen(szAppSecretKey) == 0)
+	{
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+	}
+
+	// Not make_unique, which would bypass the secure pool operator new of the context
+	std::unique_ptr<Dashlane::DashlaneContextInternal> pOwnedContext(new Dashlane::DashlaneContextInternal(szLogin, szApplicationName));
+	Dashlane::DashlaneContextInternal* pContext = pOwnedContext.get();
+
+	const uintptr_t handle = Dashlane::s_contexts.Insert(std::move(pOwnedContext));
+	if (handle == 0)
+		return RC_TO_INT(EDashlaneError::InvalidContext);
+
+	pContext->secrets.app.accessKey = szAppAccessKey;
+	pContext->secrets.app.secretKey = szAppSecretKey;
+
+	*ppContext = Dashlane::ToHandle<DashlaneContext>(handle);
+
+	// Points every context to another API server (e.g. the local mock server) without changing the application
+	if (const auto apiBaseUrl = Utility::ReadEnvironmentVariable("DASHLANE_API_URL"))
+	{
+		Dashlane::SApiBaseUrl parsed;
+		if (!Dashlane::ParseApiBaseUrl(apiBaseUrl.value(), parsed))
+			return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+		pContext->network.apiBaseUrl = apiBaseUrl.value();
+	}
+
+	pContext->pDatabase = std::make_unique<Dashlane::CDatabase>();
+
+	pContext->pSecretStore = Dashlane::CreateSecretStore(secretStore, pContext->pDatabase->GetPath().parent_path());
+	if (!pContext->pSecretStore)
+		return RC_TO_INT(EDashlaneError::KeychainUnavailable);
+
+	// Tracing can be enabled without changing the application, the file is written when the last context tracing to it is freed
+	if (const auto traceFile = Utility::ReadEnvironmentVariable("DASHLANE_TRACE_FILE"))
+	{
+		pContext->pTrace = Utility::CTraceWriter::Acquire(traceFile.value());
+		pContext->pDatabase->SetTraceWriter(pContext->pTrace);
+	}
+
+	// Only takes a handle on the connection pool of the vault file, the file is opened by the first call using it
+	if (!pContext->pDatabase->Connect())
+	{
+		return RC_TO_INT(EDashlaneError::FailedDatabaseConnection);
+	}
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_InitQueryContext(DashlaneQueryContext** ppQueryContext)
+{
+	if (ppQueryContext == nullptr)
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+	const uintptr_t handle = Dashlane::s_queryContexts.Insert(std::make_unique<Dashlane::DashlaneQueryContextInternal>());
+	if (handle == 0)
+		return RC_TO_INT(EDashlaneError::InvalidContext);
+
+	*ppQueryContext = Dashlane::ToHandle<DashlaneQueryContext>(handle);
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+void Dash_FreeContext(DashlaneContext* pContext)
+{
+	// The worker thread cannot wait for itself, a completion callback freeing its context is ignored
+	if (const auto pInternalContext = Dashlane::ResolveContext(pContext); pInternalContext != nullptr && pInternalContext->syncWorker.IsWorkerThread())
+		return;
+
+	// Released once out of the slot map, freeing a context waits for its background synchronization
+	Dashlane::s_contexts.Remove(reinterpret_cast<uintptr_t>(pContext));
+}
+
+void Dash_FreeQueryContext(DashlaneQueryContext* pQueryContext)
+{
+	Dashlane::s_queryContexts.Remove(reinterpret_cast<uintptr_t>(pQueryContext));
+}
+
+uint32_t Dash_AssignMasterPassword(DashlaneContext* pContext, const char* szMasterPassword)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_STRLEN(szMasterPassword, EDashlaneError::InvalidParameter);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	// Another password needs its derived keys restored by the next unlock
+	if (pInternalContext->secrets.masterPassword != szMasterPassword)
+	{
+		pInternalContext->secrets.derivedKeys.keys.clear();
+		pInternalContext->secrets.derivedKeys.passwordTag.clear();
+		pInternalContext->secrets.derivedKeys.isPasswordVerified = false;
+	}
+
+	pInternalContext->secrets.masterPassword = szMasterPassword;
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_AssignEmailToken(DashlaneContext* pContext, const char* szEmailToken)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_STRLEN(szEmailToken, EDashlaneError::InvalidParameter);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	pInternalContext->secrets.emailToken = szEmailToken;
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_Assign2FACode(DashlaneContext* pContext, const char* sz2FACode)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_STRLEN(sz2FACode, EDashlaneError::InvalidParameter);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	pInternalContext->secrets.twoFactorCode = sz2FACode;
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+void Dash_ClearMasterPassword(DashlaneContext* pContext)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER_VOID(pInternalContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	Utility::SecureClear(pInternalContext->secrets.masterPassword);
+
+	// Keys derived from the password are restored again on the next unlock
+	pInternalContext->secrets.derivedKeys.keys.clear();
+	pInternalContext->secrets.derivedKeys.passwordTag.clear();
+	pInternalContext->secrets.derivedKeys.isPasswordVerified = false;
+}
+
+void Dash_ClearEmailToken(DashlaneContext* pContext)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER_VOID(pInternalContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	Utility::SecureClear(pInternalContext->secrets.emailToken);
+}
+
+void Dash_Clear2FACode(DashlaneContext* pContext)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER_VOID(pInternalContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	Utility::SecureClear(pInternalContext->secrets.twoFactorCode);
+}
+
+uint32_t Dash_AddQueryTransactionTypes(DashlaneQueryContext* pQueryContext, uint32_t types)
+{
+	auto pInternalQueryContext = Dashlane::ResolveQueryContext(pQueryContext);
+
+	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
+
+#ifdef _DEBUG
+	if (types > bitmask<Dashlane::ERawTransactionType>::all().value)
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+#endif
+
+	pInternalQueryContext->typeMask |= (Dashlane::ERawTransactionType)types;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_AddQueryFilter(DashlaneQueryContext* pQueryContext, const char* szName, const char* szWildcard)
+{
+	auto pInternalQueryContext = Dashlane::ResolveQueryContext(pQueryContext);
+
+	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
+	ENSURE_STRLEN(szName, EDashlaneError::InvalidParameter);
+
+	pInternalQueryContext->filters[szName] = szWildcard;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetQueryWriter(DashlaneQueryContext* pQueryContext, Dash_QueryWriterFunc writer, void* pUserPointer)
+{
+	auto pInternalQueryContext = Dashlane::ResolveQueryContext(pQueryContext);
+
+	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(writer, EDashlaneError::InvalidParameter);
+
+	pInternalQueryContext->writerFunc = writer;
+	pInternalQueryContext->typedWriterFunc = nullptr;
+	pInternalQueryContext->pUserPointer = pUserPointer;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetQueryTypedWriter(DashlaneQueryContext* pQueryContext, Dash_QueryTypedWriterFunc writer, void* pUserPointer)
+{
+	auto pInternalQueryContext = Dashlane::ResolveQueryContext(pQueryContext);
+
+	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(writer, EDashlaneError::InvalidParameter);
+
+	pInternalQueryContext->typedWriterFunc = writer;
+	pInternalQueryContext->writerFunc = nullptr;
+	pInternalQueryContext->pUserPointer = pUserPointer;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SynchronizeVaultData(DashlaneContext* pContext)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	// A background synchronization may already be fetching the same delta
+	Dashlane::WaitForSyncWorker(*pInternalContext, lock);
+
+	EDashlaneError rc = GetOrUpdateSecrets(*pInternalContext);
+
+	if (rc == EDashlaneError::NoError)
+	{
+		// Queries and lookups on the context keep being served from the local vault meanwhile
+		rc = Dashlane::SynchronizeVaultDataUnlocked(*pInternalContext, lock);
+		if (rc == EDashlaneError::NoError && pInternalContext->applicationData.shouldUpdateDeviceConfiguration)
+		{
+			rc = UpdateDeviceConfiguration(*pInternalContext);
+		}
+	}
+	else
+	{
+		if (rc == EDashlaneError::InvalidMasterPassword)
+			Utility::SecureClear(pInternalContext->secrets.masterPassword);
+	}
+
+	return RC_TO_INT(rc);
+}
+
+uint32_t Dash_SetSyncPolicy(DashlaneContext* pContext, uint32_t staleAfterSeconds, uint32_t maxStaleSeconds)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	if (maxStaleSeconds != 0 && maxStaleSeconds < staleAfterSeconds)
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+	pInternalContext->syncPolicy.staleAfterSeconds = staleAfterSeconds;
+	pInternalContext->syncPolicy.maxStaleSeconds = maxStaleSeconds;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetLazyRecrypt(DashlaneContext* pContext, bool lazyRecrypt)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	pInternalContext->syncPolicy.lazyRecrypt = lazyRecrypt;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetSyncCompletedCallback(DashlaneContext* pContext, Dash_SyncCompletedFunc completedFunc, void* pUserPointer)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	pInternalContext->syncPolicy.completedFunc = completedFunc;
+	pInternalContext->syncPolicy.pUserPointer = pUserPointer;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_WaitForBackgroundSync(DashlaneContext* pContext)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	pInternalContext->syncWorker.Wait();
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetDatabaseOptions(DashlaneContext* pContext, uint32_t busyTimeoutMs, uint32_t maxReaders)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
+
+	if (maxReaders == 0)
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+	pInternalContext->pDatabase->SetConnectionOptions(std::chrono::milliseconds(busyTimeoutMs), maxReaders);
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_QueryTransactions(DashlaneContext* pContext, DashlaneQueryContext* pQueryContext)
+{
+	return Dash_QueryTransactionsBatch(pContext, &pQueryContext, 1);
+}
+
+uint32_t Dash_QueryTransactionsBatch(DashlaneContext* pContext, DashlaneQueryContext** ppQueryContexts, uint32_t count)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(ppQueryContexts, EDashlaneError::InvalidParameter);
+
+	DASH_TRACE_SPAN(pInternalContext->pTrace, "QueryTransactions", "query");
+
+	std::vector<Dashlane::DashlaneQueryContextInternal*> queries(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		auto pInternalQueryContext = Dashlane::ResolveQueryContext(ppQueryContexts[i]);
+
+		ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
+		if (pInternalQueryContext->writerFunc == nullptr && pInternalQueryContext->typedWriterFunc == nullptr)
+			return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+		queries[i] = pInternalQueryContext;
+	}
+
+	// Items are pulled and written in order, the first failure stops the query
+	Dashlane::CQueryCursor cursor(*pInternalContext, queries);
+
+	EDashlaneError rc = cursor.Open();
+	if (rc != EDashlaneError::NoError)
+		return RC_TO_INT(rc);
+
+	bool hasResult = true;
+	while (hasResult)
+	{
+		rc = cursor.Next(hasResult);
+		if (rc != EDashlaneError::NoError)
+			return RC_TO_INT(rc);
+	}
+
+	return RC_TO_INT(cursor.Close());
+}
+
+uint32_t Dash_GetTransactionById(DashlaneContext* pContext, const char* szIdentifier, Dash_QueryWriterFunc writer, void* pUserPointer)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_STRLEN(szIdentifier, EDashlaneError::InvalidParameter);
+	ENSURE_POINTER(writer, EDashlaneError::InvalidParameter);
+
+	DASH_TRACE_SPAN(pInternalContext->pTrace, "GetTransactionById", "query");
+
+	EDashlaneError rc = Dashlane::PrepareVaultRead(*pInternalContext);
+	if (rc != EDashlaneError::NoError)
+		return RC_TO_INT(rc);
+
+	std::shared_lock lock(pInternalContext->stateMutex);
+
+	Dashlane::SRawTransactionBackupEdit transaction;
+	{
+		DASH_STAT_TIMER(pInternalContext->pStats, SqliteFetch);
+		rc = pInternalContext->pDatabase->GetTransaction(*pInternalContext, szIdentifier, transaction);
+		if (rc != EDashlaneError::NoError)
+			return RC_TO_INT(rc);
+	}
+
+	Utility::CTransientArena arena(Dashlane::SMALL_ARENA_CHUNK_SIZE);
+	std::pmr::vector<uint8_t> decrypted(&arena);
+	rc = Dashlane::DeserializeAndDecrypt(*pInternalContext, transaction.content, decrypted);
+
+	// A server envelope that does not decrypt means the master password is incorrect, as during a query
+	if (rc == EDashlaneError::InternalDecryptFailure && !transaction.recrypted)
+	{
+		lock.unlock();
+
+		std::unique_lock exclusiveLock(pInternalContext->stateMutex);
+		Utility::SecureClear(pInternalContext->secrets.masterPassword);
+
+		return RC_TO_INT(EDashlaneError::InvalidMasterPassword);
+	}
+
+	nlohmann::ordered_json json;
+	if (rc == EDashlaneError::NoError)
+		rc = Dashlane::DecodeTransactionContent(*pInternalContext, decrypted, json, &arena);
+
+	if (rc != EDashlaneError::NoError)
+		return RC_TO_INT(rc);
+
+	// Best effort, as for the items read by a query, and skipped rather than waiting for a running synchronization
+	std::string recryptedContent;
+	if (!transaction.recrypted && Dashlane::EncryptAndSerialize(*pInternalContext, decrypted, recryptedContent) == EDashlaneError::NoError)
+	{
+		DASH_STAT_TIMER(pInternalContext->pStats, SqliteWrite);
+		pInternalContext->pDatabase->UpdateRecryptedTransactions(*pInternalContext, { Dashlane::STransactionRow(pInternalContext->login,
+			transaction.identifier, transaction.type, transaction.GetActionName(), recryptedContent, transaction.backupDate) }, false);
+	}
+
+	std::pmr::string dump(&arena);
+	Utility::DumpJsonTransaction(json, dump);
+
+	// As for query writers, the writer runs with the context unlocked and may call the API on it
+	lock.unlock();
+	{
+		DASH_STAT_TIMER(pInternalContext->pStats, WriterCallback);
+		writer(pUserPointer, dump.c_str(), static_cast<uint32_t>(dump.size()));
+	}
+
+	std::unique_lock exclusiveLock(pInternalContext->stateMutex);
+	if (pInternalContext->applicationData.shouldUpdateDeviceConfiguration)
+		rc = UpdateDeviceConfiguration(*pInternalContext);
+
+	return RC_TO_INT(rc);
+}
+
+uint32_t Dash_QueryOpen(DashlaneContext* pContext, DashlaneQueryContext* pQueryContext, DashlaneQueryCursor** ppCursor)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+	auto pInternalQueryContext = Dashlane::ResolveQueryContext(pQueryContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalQueryContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(ppCursor, EDashlaneError::InvalidParameter);
+
+	if (pInternalQueryContext->writerFunc == nullptr && pInternalQueryContext->typedWriterFunc == nullptr)
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+	*ppCursor = nullptr;
+
+	DASH_TRACE_SPAN(pInternalContext->pTrace, "QueryOpen", "query");
+
+	auto pCursor = std::make_unique<Dashlane::CQueryCursor>(*pInternalContext, std::span(&pInternalQueryContext, 1));
+	const EDashlaneError rc = pCursor->Open();
+	if (rc != EDashlaneError::NoError)
+		return RC_TO_INT(rc);
+
+	const uintptr_t handle = Dashlane::s_cursors.Insert(std::unique_ptr<Dashlane::SQueryCursorHandle>(
+		new Dashlane::SQueryCursorHandle{ pContext, pQueryContext, std::move(pCursor) }));
+	if (handle == 0)
+		return RC_TO_INT(EDashlaneError::InvalidContext);
+
+	*ppCursor = Dashlane::ToHandle<DashlaneQueryCursor>(handle);
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_QueryNext(DashlaneQueryCursor* pCursor, bool* pHasResult)
+{
+	auto pInternalCursor = Dashlane::ResolveCursor(pCursor);
+
+	ENSURE_POINTER(pInternalCursor, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pHasResult, EDashlaneError::InvalidParameter);
+
+	DASH_TRACE_SPAN(pInternalCursor->GetContext().pTrace, "QueryNext", "query");
+
+	return RC_TO_INT(pInternalCursor->Next(*pHasResult));
+}
+
+uint32_t Dash_QueryClose(DashlaneQueryCursor* pCursor)
+{
+	// A cursor closed twice is no longer in the slot map
+	const auto pHandle = Dashlane::s_cursors.Remove(reinterpret_cast<uintptr_t>(pCursor));
+
+	ENSURE_POINTER(pHandle, EDashlaneError::InvalidContext);
+
+	// Its context or query context was freed first, the cursor is released without writing anything back
+	if (!pHandle->IsValid())
+		return RC_TO_INT(EDashlaneError::InvalidContext);
+
+	return RC_TO_INT(pHandle->pCursor->Close());
+}
+
+uint32_t Dash_GetStats(DashlaneContext* pContext, Dash_QueryWriterFunc writer, void* pUserPointer)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(writer, EDashlaneError::InvalidParameter);
+
+	// Empty object when the library is built without DASHLANE_ENABLE_STATS
+	const nlohmann::ordered_json json = pInternalContext->pStats->ToJson();
+	const std::string dump = json.dump();
+	writer(pUserPointer, dump.c_str(), static_cast<uint32_t>(dump.size()));
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_ResetStats(DashlaneContext* pContext)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	pInternalContext->pStats->Reset();
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetApiBaseUrl(DashlaneContext* pContext, const char* szBaseUrl)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	if (szBaseUrl == nullptr || std::strlen(szBaseUrl) == 0)
+	{
+		pInternalContext->network.apiBaseUrl = Dashlane::DEFAULT_API_BASE_URL;
+		return RC_TO_INT(EDashlaneError::NoError);
+	}
+
+	Dashlane::SApiBaseUrl parsed;
+	if (!Dashlane::ParseApiBaseUrl(szBaseUrl, parsed))
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+	pInternalContext->network.apiBaseUrl = szBaseUrl;
+	pInternalContext->network.serverClockOffset = 0;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetTraceOutput(DashlaneContext* pContext, const char* szPath)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	// The previous writer is flushed once a running background synchronization releases it
+	if (szPath == nullptr || std::strlen(szPath) == 0)
+		pInternalContext->pTrace.reset();
+	else
+		pInternalContext->pTrace = Utility::CTraceWriter::Acquire(std::filesystem::path(szPath));
+
+	if (pInternalContext->pDatabase)
+		pInternalContext->pDatabase->SetTraceWriter(pInternalContext->pTrace);
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_FlushTrace(DashlaneContext* pContext)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalContext->pTrace, EDashlaneError::InvalidParameter);
+
+	std::shared_lock lock(pInternalContext->stateMutex);
+
+	if (!pInternalContext->pTrace->Flush())
+		return RC_TO_INT(EDashlaneError::InvalidParameter);
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_ResetVaultData(DashlaneContext* pContext, bool removeAllUsers)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
+
+	// A synchronization running without the state lock would write the removed items back
+	std::lock_guard<std::mutex> syncLock(pInternalContext->syncMutex);
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	Dashlane::WaitForSyncWorker(*pInternalContext, lock);
+
+	// First use of the database for this call, reports a file that cannot be opened instead of throwing later
+	if (!pInternalContext->pDatabase->Prepare())
+		return RC_TO_INT(EDashlaneError::FailedDatabaseCreation);
+
+	if (!removeAllUsers)
+	{
+		if (pInternalContext->login.empty())
+		{
+			return RC_TO_INT(EDashlaneError::InvalidContext);
+		}
+		else
+		{
+			DeleteLocalKey(*pInternalContext);
+			pInternalContext->pDatabase->RemoveUserData(*pInternalContext);
+		}
+	}
+	else
+	{
+		std::vector<std::string> users;
+		pInternalContext->pDatabase->GetRegisteredUsers(users);
+
+		for (const auto& user : users)
+		{
+			Dashlane::DashlaneContextInternal ctx(user.c_str(), pInternalContext->applicationName.c_str());
+			ctx.pSecretStore = pInternalContext->pSecretStore;
+			DeleteLocalKey(ctx);
+		}
+
+		// Quicker to just drop all the tables and recreate them if needed
+		pInternalContext->pDatabase->Drop();
+	}
+
+	return (uint32_t)EDashlaneError::NoError;
+}
+
+uint32_t Dash_SetShouldStoreMasterPassword(DashlaneContext* pContext, bool shouldStoreMasterPassword)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	// First use of the database for this call, reports a file that cannot be opened instead of throwing later
+	if (!pInternalContext->pDatabase->Prepare())
+		return RC_TO_INT(EDashlaneError::FailedDatabaseCreation);
+
+	Dashlane::SDeviceConfiguration config;
+	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
+		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
+
+	config.shouldNotSaveMasterPassword = !shouldStoreMasterPassword;
+
+	if (!shouldStoreMasterPassword && !config.masterPasswordEncrypted.empty())
+		config.masterPasswordEncrypted.clear();
+
+	if (!pInternalContext->pDatabase->SetDeviceConfiguration(config))
+		return RC_TO_INT(EDashlaneError::UpdateConfigFailed);
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_GetShouldStoreMasterPassword(DashlaneContext* pContext, bool* pShouldStoreMasterPasswordOut)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
+
+	std::shared_lock lock(pInternalContext->stateMutex);
+
+	// First use of the database for this call, reports a file that cannot be opened instead of throwing later
+	if (!pInternalContext->pDatabase->Prepare())
+		return RC_TO_INT(EDashlaneError::FailedDatabaseCreation);
+
+	Dashlane::SDeviceConfiguration config;
+	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
+		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
+
+	*pShouldStoreMasterPasswordOut = !config.shouldNotSaveMasterPassword;
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_SetAutoSync(DashlaneContext* pContext, bool autoSync)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
+
+	std::unique_lock lock(pInternalContext->stateMutex);
+
+	// First use of the database for this call, reports a file that cannot be opened instead of throwing later
+	if (!pInternalContext->pDatabase->Prepare())
+		return RC_TO_INT(EDashlaneError::FailedDatabaseCreation);
+
+	Dashlane::SDeviceConfiguration config;
+	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
+		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
+
+	config.autoSync = autoSync;
+
+	if (!pInternalContext->pDatabase->SetDeviceConfiguration(config))
+		return RC_TO_INT(EDashlaneError::UpdateConfigFailed);
+
+	return RC_TO_INT(EDashlaneError::NoError);
+}
+
+uint32_t Dash_GetAutoSync(DashlaneContext* pContext, bool* pAutoSync)
+{
+	auto pInternalContext = Dashlane::ResolveContext(pContext);
+
+	ENSURE_POINTER(pInternalContext, EDashlaneError::InvalidContext);
+	ENSURE_POINTER(pInternalContext->pDatabase, EDashlaneError::InvalidContext);
+
+	std::shared_lock lock(pInternalContext->stateMutex);
+
+	// First use of the database for this call, reports a file that cannot be opened instead of throwing later
+	if (!pInternalContext->pDatabase->Prepare())
+		return RC_TO_INT(EDashlaneError::FailedDatabaseCreation);
+
+	Dashlane::SDeviceConfiguration config;
+	if (!pInternalContext->pDatabase->GetDeviceConfiguration(*pInternalContext, config))
+		return RC_TO_INT(EDashlaneError::DeviceNotRegistered);
+
+	*pAutoSync = config.autoSync;
+
+	return RC_TO_INT(EDashlaneError::NoError);
 }
\ No newline at end of file
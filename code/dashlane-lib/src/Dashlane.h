@@ -1,69 +1,214 @@
-#pragma once
-
-#include <dashlane/Dashlane.h>
-#include "Database.h"
-
-namespace Dashlane
-{
-
-
-	struct DashlaneQueryContextInternal : public DashlaneQueryContext
-	{
-		DashlaneQueryContextInternal()
-			: typeMask(bitmask<Dashlane::ERawTransactionType>::none())
-			, filters()
-			, writerFunc(nullptr)
-		{}
-
-		bitmask<Dashlane::ERawTransactionType> typeMask{bitmask<Dashlane::ERawTransactionType>::none()};
-		std::map<std::string, std::string> filters{};
-		Dash_QueryWriterFunc writerFunc{ nullptr };
-		void* pUserPointer{ nullptr };
-	};
-
-	struct DashlaneContextInternal : public DashlaneContext
-	{
-		DashlaneContextInternal(const char* szLogin, const char* szApplicationName)
-			: applicationName(szApplicationName)
-			, login(szLogin)
-			, pDatabase(nullptr)
-		{}
-
-		const std::string applicationName;
-		const std::string login;
-		std::unique_ptr<Dashlane::CDatabase> pDatabase;
-
-		struct
-		{
-			std::string masterPassword;
-			struct {
-				std::string accessKey;
-				std::string secretKey;
-			} app;
-			struct {
-				std::string accessKey;
-				std::string secretKey;
-			} device;
-			std::vector<uint8_t> localKey;
-			std::string serverKey;
-			std::string twoFactorCode;
-			std::string emailToken;
-		} secrets;
-
-		struct {
-			bool shouldUpdateDeviceConfiguration{ false };
-		} applicationData;
-	};
-
-	EDashlaneError EncryptAndSerialize(
-		const DashlaneContextInternal& context,
-		const std::vector<uint8_t>& input,
-		std::string& output
-	);
-	EDashlaneError DeserializeAndDecrypt(
-		const DashlaneContextInternal& context,
-		const std::string& input,
-		std::vector<uint8_t>& output
-	);
-
+#pragma once
+
+#include <dashlane/Dashlane.h>
+#include "Database.h"
+#include "Api/ApiRequest.h"
+#include "SyncWorker.h"
+#include "Utility/SecureMemory.h"
+#include "Utility/Stats.h"
+#include "Utility/Trace.h"
+#include "Utility/Transaction.h"
+
+#include <memory_resource>
+#include <shared_mutex>
+
+namespace Dashlane
+{
+
+	class ISecretStore;
+
+	struct DashlaneQueryContextInternal : public DashlaneQueryContext
+	{
+		DashlaneQueryContextInternal()
+			: typeMask(bitmask<Dashlane::ERawTransactionType>::none())
+			, filters()
+			, writerFunc(nullptr)
+		{}
+
+		bitmask<Dashlane::ERawTransactionType> typeMask{bitmask<Dashlane::ERawTransactionType>::none()};
+		std::map<std::string, std::string> filters{};
+		Dash_QueryWriterFunc writerFunc{ nullptr };
+		Dash_QueryTypedWriterFunc typedWriterFunc{ nullptr };	// Replaces writerFunc, matches are not converted to JSON
+		void* pUserPointer{ nullptr };
+	};
+
+	struct DashlaneContextInternal : public DashlaneContext
+	{
+		DashlaneContextInternal(const char* szLogin, const char* szApplicationName)
+			: applicationName(szApplicationName)
+			, login(szLogin)
+			, pDatabase(nullptr)
+		{}
+
+		// Contexts live in the secure pool, so do the short secrets stored inline by std::string
+		static void* operator new(size_t size) { return Utility::CSecureMemoryPool::Get().Allocate(size); }
+		static void operator delete(void* p, size_t size) { Utility::CSecureMemoryPool::Get().Deallocate(p, size); }
+
+		const std::string applicationName;
+		const std::string login;
+		std::unique_ptr<Dashlane::CDatabase> pDatabase;
+
+		// Keeps the local key between processes, null when it is not stored
+		std::shared_ptr<ISecretStore> pSecretStore;
+
+		// Guards the secrets and settings below. Calls changing them lock it exclusively, calls reading the vault
+		// lock it shared so several threads can query the same context
+		mutable std::shared_mutex stateMutex;
+
+		// Held by a synchronization running on a copy of the context (without stateMutex) and by ResetVaultData,
+		// never together with stateMutex
+		std::mutex syncMutex;
+
+		struct
+		{
+			Utility::SecureString masterPassword;
+			struct {
+				std::string accessKey;
+				Utility::SecureString secretKey;
+			} app;
+			struct {
+				std::string accessKey;
+				Utility::SecureString secretKey;
+			} device;
+			Utility::SecureBuffer localKey;
+			Utility::SecureString serverKey;
+			std::string twoFactorCode;
+			std::string emailToken;
+
+			// Keys derived from the master password by previous processes, restored from the local vault on unlock
+			struct {
+				std::string passwordTag;	// Master password the keys were loaded for, keyed by the local key
+				bool isPasswordVerified{ false };	// An envelope derived from this password decrypted, keys of other passwords were removed
+				std::map<std::string, Utility::SecureBuffer> keys;
+			} derivedKeys;
+		} secrets;
+
+		struct {
+			bool shouldUpdateDeviceConfiguration{ false };
+		} applicationData;
+
+		struct {
+			int64_t serverClockOffset{ 0 }; // Seconds to add to the local clock to match the API server clock
+			std::string apiBaseUrl{ DEFAULT_API_BASE_URL };
+		} network;
+
+		struct {
+			uint32_t staleAfterSeconds{ 3600 };	// Local vault older than this is refreshed
+			uint32_t maxStaleSeconds{ 0 };		// Local vault older than this is not served before refreshing (0 = no limit)
+			bool lazyRecrypt{ false };			// Server envelopes are stored as they are and recrypted on first read
+			Dash_SyncCompletedFunc completedFunc{ nullptr };
+			void* pUserPointer{ nullptr };
+		} syncPolicy;
+
+		// Shared with the background sync worker so its stages are reported with the queries
+		std::shared_ptr<Utility::CStats> pStats{ std::make_shared<Utility::CStats>() };
+
+		// Trace-event output, null when tracing is disabled
+		std::shared_ptr<Utility::CTraceWriter> pTrace;
+
+		CSyncWorker syncWorker;
+	};
+
+	// Initial chunk of the arenas used to decrypt a single secret or item outside of a query
+	static constexpr size_t SMALL_ARENA_CHUNK_SIZE = 16 * 1024;
+
+	// Items of a query decrypted together by the crypto backend
+	static constexpr size_t QUERY_BATCH_SIZE = 64;
+
+	struct SEncryptedDataView;
+
+	EDashlaneError EncryptAndSerialize(
+		const DashlaneContextInternal& context,
+		std::span<const uint8_t> input,
+		std::string& output
+	);
+	EDashlaneError DeserializeAndDecrypt(
+		const DashlaneContextInternal& context,
+		const std::string& input,
+		Utility::SecureBuffer& output
+	);
+
+	// Intermediate buffers are allocated from the memory resource of output
+	EDashlaneError DeserializeAndDecrypt(
+		const DashlaneContextInternal& context,
+		const std::string& input,
+		std::pmr::vector<uint8_t>& output
+	);
+
+	// Decodes and parses an envelope into views over decoded, and resolves the key to decrypt it with.
+	// symmetricKey refers to the local key or to derivedKey when the envelope has its own derivation.
+	EDashlaneError DecodeEnvelope(
+		const DashlaneContextInternal& context,
+		const std::string& input,
+		std::pmr::vector<uint8_t>& decoded,
+		SEncryptedDataView& envelope,
+		Utility::SecureBuffer& derivedKey,
+		std::span<const uint8_t>& symmetricKey
+	);
+
+	// Inflates the decrypted content of a transaction into decompressed and parses its fields in place
+	EDashlaneError DecodeTransactionFields(
+		const DashlaneContextInternal& context,
+		const std::pmr::vector<uint8_t>& decrypted,
+		std::pmr::vector<uint8_t>& decompressed,
+		Utility::TransactionFields& fields,
+		ETransactionType& type
+	);
+
+	// Inflates and converts the decrypted content of a transaction to its JSON representation
+	EDashlaneError DecodeTransactionContent(
+		const DashlaneContextInternal& context,
+		const std::pmr::vector<uint8_t>& decrypted,
+		nlohmann::ordered_json& jsonOut,
+		std::pmr::memory_resource* pResource
+	);
+
+	// Decrypts, inflates and converts a stored transaction to its JSON representation.
+	// Transient buffers are allocated from pResource, the arena of the running query.
+	EDashlaneError ProcessTransaction(
+		const DashlaneContextInternal& context,
+		const SRawTransactionBackupEdit& transaction,
+		nlohmann::ordered_json& jsonOut,
+		std::pmr::memory_resource* pResource = std::pmr::get_default_resource()
+	);
+
+	// Case-insensitive match of the query filters against a decoded transaction (any filter may match)
+	bool MatchesQueryFilters(const DashlaneQueryContextInternal& query, const nlohmann::ordered_json& json);
+	bool MatchesQueryFilters(const DashlaneQueryContextInternal& query, const Utility::TransactionFields& fields);
+
+	// Views of the typed result over the fields, fills the view matching type
+	void FillTransactionView(
+		ETransactionType type,
+		const Utility::TransactionFields& fields,
+		DashlaneAuthentifiantView& authentifiant,
+		DashlaneSecureNoteView& secureNote,
+		DashlaneTransactionView& view
+	);
+
+	// Fetches and applies the latest vault delta, secrets of the context must already be available
+	EDashlaneError SynchronizeVaultData(DashlaneContextInternal& context);
+
+	// Copy of an unlocked context to synchronize it without holding its state, with its own database connection
+	// (not connected yet)
+	std::unique_ptr<DashlaneContextInternal> CreateSyncContext(const DashlaneContextInternal& context);
+
+	// Synchronizes a copy of the context with lock released, so queries and lookups keep reading the local vault.
+	// What the synchronization changed (clock offset, verified or rejected master password) is merged back once
+	// lock is held again
+	EDashlaneError SynchronizeVaultDataUnlocked(DashlaneContextInternal& context, std::unique_lock<std::shared_mutex>& lock);
+
+	// Waits for the background synchronization of the context with lock released, as its completion callback may call
+	// the API on the context. Returns with lock held again, once no other thread runs a synchronization
+	void WaitForSyncWorker(DashlaneContextInternal& context, std::unique_lock<std::shared_mutex>& lock);
+
+	// Applies the context sync policy before serving a query from the local vault, lock holds the context state
+	EDashlaneError RefreshVaultData(DashlaneContextInternal& context, std::unique_lock<std::shared_mutex>& lock);
+
+	// Resolves the secrets and applies the sync policy, before reading items from the local vault. An unlocked context
+	// with a usable local vault only takes the state lock shared, the exclusive lock is only taken to unlock it
+	EDashlaneError PrepareVaultRead(DashlaneContextInternal& context);
+
+	// Recrypts the server envelopes stored by a lazy synchronization with the local key
+	EDashlaneError RecryptPendingTransactions(DashlaneContextInternal& context);
+
 }
\ No newline at end of file
@@ -1,276 +1,714 @@
-#include "StdAfx.h"
-#include "Database.h"
-#include "Dashlane.h"
-#include "Utility/Filesystem.h"
-#include "Utility/Strings.h"
-#include "Utility/Time.h"
-
-#include <SQLiteCpp/SQLiteCpp.h>
-
-#include <array>
-
-namespace Dashlane
-{
-
-	static constexpr char APP_FOLDER[] = "dashlane-c-cli";
-
-	CDatabase::CDatabase(const std::filesystem::path& dbPath)
-		: m_dbPath(dbPath)
-		, m_pDatabase(nullptr)
-	{
-		if (m_dbPath.empty())
-		{
-			const std::filesystem::path folder = Utility::GetApplicationDataFolder() / APP_FOLDER;
-			if (!std::filesystem::exists(folder))
-				std::filesystem::create_directories(folder);
-
-			m_dbPath = folder / "userdata.db";
-		}
-	}
-
-	CDatabase::~CDatabase() {}
-
-	bool CDatabase::Connect()
-	{
-		m_pDatabase = std::make_unique<SQLite::Database>(m_dbPath, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
-		return m_pDatabase != nullptr;
-	}
-
-	bool CDatabase::Prepare()
-	{
-		if (m_pDatabase)
-		{
-			SQLite::Statement(*m_pDatabase,
-				"CREATE TABLE IF NOT EXISTS syncUpdates( " \
-				"login VARCHAR(255) PRIMARY KEY, " \
-				"lastServerSyncTimestamp INT, " \
-				"lastClientSyncTimestamp INT " \
-				");"
-			).exec();
-
-			SQLite::Statement(*m_pDatabase,
-				"CREATE TABLE IF NOT EXISTS transactions ( " \
-				"login VARCHAR(255), " \
-				"identifier VARCHAR(255), " \
-				"type VARCHAR(255) NOT NULL, " \
-				"action VARCHAR(255) NOT NULL, " \
-				"content BLOB, " \
-				"PRIMARY KEY (login, identifier) " \
-				");"
-			).exec();
-
-			SQLite::Statement(*m_pDatabase,
-				"CREATE TABLE IF NOT EXISTS device ( " \
-				"login VARCHAR(255) PRIMARY KEY, " \
-				"version VARCHAR(255) NOT NULL, " \
-				"accessKey VARCHAR(255) NOT NULL, " \
-				"secretKeyEncrypted VARCHAR(255) NOT NULL, " \
-				"masterPasswordEncrypted VARCHAR(255), " \
-				"shouldNotSaveMasterPassword BIT NOT NULL, " \
-				"localKeyEncrypted VARCHAR(255) NOT NULL, " \
-				"autoSync BIT NOT NULL, " \
-				"authenticationMode VARCHAR(255), " \
-				"serverKeyEncrypted VARCHAR(255) " \
-				");"
-			).exec();
-
-			return true;
-		}
-
-		return false;
-	}
-
-	void CDatabase::GetRegisteredUsers(std::vector<std::string>& users) const
-	{
-		SQLite::Statement stmt(*m_pDatabase, "SELECT login FROM device");
-
-		while (stmt.executeStep())
-			users.emplace_back(stmt.getColumn(0).getString());
-	}
-
-	void CDatabase::RemoveUserData(const DashlaneContextInternal& context)
-	{
-		std::array<const char*, 3> tables
-		{
-			"device",
-			"transactions",
-			"syncUpdates"
-		};
-
-		for (const auto table : tables)
-		{
-			SQLite::Statement stmt(*m_pDatabase, std::format("DELETE FROM {} WHERE login = ?", table));
-			stmt.bindNoCopy(1, context.login);
-			stmt.exec();
-		}
-	}
-
-	void CDatabase::Drop()
-	{
-		if (m_pDatabase)
-		{
-			m_pDatabase->exec(
-				"DROP TABLE IF EXISTS syncUpdates;" \
-				"DROP TABLE IF EXISTS transactions;" \
-				"DROP TABLE IF EXISTS device"
-			);
-		}
-	}
-
-	void CDatabase::Disconnect()
-	{
-		m_pDatabase.reset();
-	}
-
-	bool CDatabase::GetDeviceConfiguration(const DashlaneContextInternal& context, SDeviceConfiguration& config) const
-	{
-		bool success = false;
-
-		if (m_pDatabase)
-		{
-			SQLite::Statement stmt(*m_pDatabase, "SELECT * FROM device WHERE login = ? LIMIT 1");
-			stmt.bindNoCopy(1, context.login);
-
-			if (stmt.executeStep())
-			{
-				if (stmt.hasRow())
-				{
-					config =
-					{
-						stmt.getColumn("accessKey").getString(),
-						stmt.getColumn("secretKeyEncrypted").getString(),
-						stmt.getColumn("masterPasswordEncrypted").getString(),
-						static_cast<bool>(stmt.getColumn("shouldNotSaveMasterPassword").getInt()),
-						stmt.getColumn("localKeyEncrypted").getString(),
-						stmt.getColumn("login").getString(),
-						stmt.getColumn("version").getString(),
-						static_cast<bool>(stmt.getColumn("autoSync").getInt()),
-						static_cast<E2FAType>(stmt.getColumn("authenticationMode").getInt()),
-						stmt.getColumn("serverKeyEncrypted").getString()
-					};
-
-					success = true;
-				}
-			}
-
-			// Default device configuration
-			if (!success)
-				config = SDeviceConfiguration();
-		}
-
-		return success;
-	}
-
-	bool CDatabase::SetDeviceConfiguration(const SDeviceConfiguration& config)
-	{
-		SQLite::Statement stmt(*m_pDatabase, "REPLACE INTO device VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
-		stmt.bindNoCopy(1, config.login);
-		stmt.bindNoCopy(2, config.version);
-		stmt.bindNoCopy(3, config.accessKey);
-		stmt.bindNoCopy(4, config.secretKeyEncrypted);
-
-		if (config.shouldNotSaveMasterPassword)
-			stmt.bindNoCopy(5, "");
-		else
-			stmt.bindNoCopy(5, config.masterPasswordEncrypted);
-
-		stmt.bind(6, config.shouldNotSaveMasterPassword);
-		stmt.bindNoCopy(7, config.localKeyEncrypted);
-		stmt.bind(8, config.autoSync);
-		stmt.bind(9, std::underlying_type_t<E2FAType>(config.authenticationMode));
-		stmt.bindNoCopy(10, config.serverKeyEncrypted);
-
-		stmt.exec();
-
-		return true;
-	}
-
-	uint64_t CDatabase::GetLastSyncTime(DashlaneContextInternal& context) const
-	{
-		uint64_t time = 0;
-
-		SQLite::Statement stmt(*m_pDatabase, "SELECT lastClientSyncTimestamp FROM syncUpdates WHERE login = ?");
-		stmt.bindNoCopy(1, context.login);
-
-		if (stmt.executeStep())
-			time = stmt.getColumn(0).getUInt();
-
-		return time;
-	}
-
-	bool CDatabase::UpdateLastSyncTime(DashlaneContextInternal& context, uint32_t lastServerSyncTime)
-	{
-		SQLite::Statement stmt(*m_pDatabase, "REPLACE INTO syncUpdates (login, lastServerSyncTimestamp, lastClientSyncTimestamp) VALUES(?, ?, ?)");
-		stmt.bindNoCopy(1, context.login);
-		stmt.bind(2, lastServerSyncTime);
-		stmt.bind(3, static_cast<uint32_t>(Utility::GetUnixTimestamp()));
-		return stmt.exec() > 0;
-	}
-
-	EDashlaneError CDatabase::GetTransactions(const DashlaneContextInternal& context, const bitmask<ERawTransactionType> types, std::vector<SRawTransactionBackupEdit>& transactions) const
-	{
-		// Build filter query
-		std::string typeQuery;
-		for (const auto& type : types)
-		{
-			if (typeQuery.empty())
-				typeQuery = " AND (`type` = ?";
-			else
-				typeQuery += " OR `type` = ?";
-		}
-		if (!typeQuery.empty()) typeQuery += ")";
-
-		SQLite::Statement stmt(*m_pDatabase, std::format("SELECT * FROM transactions WHERE login = ? AND action = 'BACKUP_EDIT'{}", typeQuery));
-		int bindPos = 1;
-		stmt.bindNoCopy(bindPos++, context.login);
-
-		for (const auto& type : types)
-			stmt.bind(bindPos++, std::string(nlohmann::ordered_json(type.value)));
-
-		while (stmt.executeStep())
-		{
-			SRawTransactionBackupEdit transaction;
-			transaction.identifier = stmt.getColumn("identifier").getString();
-			transaction.content = stmt.getColumn("content").getString();
-			transaction.type = stmt.getColumn("type").getString();
-			transactions.emplace_back(std::move(transaction));
-		}
-
-		return EDashlaneError::NoError;
-	}
-
-	bool CDatabase::AddTransactionData(const STransactionRow& row)
-	{
-		SQLite::Statement stmt(*m_pDatabase, "REPLACE INTO transactions (login, identifier, type, action, content) VALUES (?, ?, ?, ?, ?)");
-		stmt.bindNoCopy(1, row.login);
-		stmt.bindNoCopy(2, row.identifier);
-		stmt.bindNoCopy(3, row.type);
-		stmt.bindNoCopy(4, row.action);
-		stmt.bindNoCopy(5, row.content);
-		
-		return stmt.exec() > 0;
-	}
-
-	bool CDatabase::AddMultipleTransactionData(const std::vector<STransactionRow>& rows)
-	{
-		std::string query = "REPLACE INTO transactions(login, identifier, type, action, content) VALUES (?, ?, ?, ?, ?)";
-		for (int i = 1; i < rows.size(); i++)
-			query += ", (?, ?, ?, ?, ?)";
-
-		SQLite::Statement stmt(*m_pDatabase, query);
-
-		for (int i = 0; i < rows.size(); i++)
-		{
-			const size_t offset = 5 * i;
-			stmt.bindNoCopy(offset + 1, rows[i].login);
-			stmt.bindNoCopy(offset + 2, rows[i].identifier);
-			stmt.bindNoCopy(offset + 3, rows[i].type);
-			stmt.bindNoCopy(offset + 4, rows[i].action);
-			stmt.bindNoCopy(offset + 5, rows[i].content);
-		}
-
-		return stmt.exec() > 0;
-	}
-
+#include "StdAfx.h"
+#include "Database.h"
+#include "Dashlane.h"
+#include "Utility/Environment.h"
+#include "Utility/Filesystem.h"
+#include "Utility/Strings.h"
+#include "Utility/Time.h"
+#include "Utility/Trace.h"
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <sqlite3.h>
+
+#include <array>
+
+namespace Dashlane
+{
+
+	static constexpr char APP_FOLDER[] = "dashlane-c-cli";
+
+	// Bump when adding a migration step to CDatabase::Migrate
+	static constexpr int32_t SCHEMA_VERSION = 2;
+
+	CDatabase::CDatabase(const std::filesystem::path& dbPath)
+		: m_dbPath(dbPath)
+		, m_pConnections(nullptr)
+	{
+		if (m_dbPath.empty())
+		{
+			// Keeps test and benchmark runs away from the user's vault
+			const auto dataDirectory = Utility::ReadEnvironmentVariable("DASHLANE_DATA_DIR");
+			const std::filesystem::path folder = dataDirectory ? std::filesystem::path(dataDirectory.value()) : Utility::GetApplicationDataFolder() / APP_FOLDER;
+			m_dbPath = folder / "userdata.db";
+		}
+	}
+
+	CDatabase::~CDatabase() {}
+
+	bool CDatabase::Connect()
+	{
+		// No file is touched here, connections are opened by the first statement
+		m_pConnections = CConnectionPool::Acquire(m_dbPath);
+		m_schemaReady = false;
+
+		return m_pConnections != nullptr;
+	}
+
+	void CDatabase::SetTraceWriter(const std::shared_ptr<Utility::CTraceWriter>& pTrace)
+	{
+		// Registered on the connections as they are borrowed
+		m_pTrace = pTrace;
+	}
+
+	void CDatabase::SetConnectionOptions(std::chrono::milliseconds busyTimeout, size_t maxReaders)
+	{
+		if (m_pConnections)
+		{
+			m_pConnections->SetBusyTimeout(busyTimeout);
+			m_pConnections->SetMaxReaders(maxReaders);
+		}
+	}
+
+	CConnectionPool::CWriter CDatabase::GetWriter() const
+	{
+		EnsureSchema();
+
+		CConnectionPool::CWriter writer = m_pConnections->LockWriter();
+		RegisterTraceCallback(*writer);
+		return writer;
+	}
+
+	std::optional<CConnectionPool::CWriter> CDatabase::TryGetWriter() const
+	{
+		EnsureSchema();
+
+		std::optional<CConnectionPool::CWriter> writer = m_pConnections->TryLockWriter();
+		if (writer)
+			RegisterTraceCallback(**writer);
+
+		return writer;
+	}
+
+	CConnectionPool::CReader CDatabase::GetReader() const
+	{
+		EnsureSchema();
+
+		CConnectionPool::CReader reader = m_pConnections->AcquireReader();
+		RegisterTraceCallback(*reader);
+		return reader;
+	}
+
+	void CDatabase::RegisterTraceCallback(SQLite::Database& database) const
+	{
+		if (!m_pTrace)
+		{
+			sqlite3_trace_v2(database.getHandle(), 0, nullptr, nullptr);
+			return;
+		}
+
+		// Reported once a statement is reset or finalized, with the time spent stepping it
+		sqlite3_trace_v2(database.getHandle(), SQLITE_TRACE_PROFILE, [](unsigned type, void* pUserData, void* pStatement, void* pElapsed) -> int
+		{
+			const auto end = Utility::CTraceWriter::Clock::now();
+			const auto elapsed = std::chrono::nanoseconds(*static_cast<sqlite3_int64*>(pElapsed));
+
+			// Unexpanded SQL, bound values (vault content, keys) are never recorded
+			const char* szSql = sqlite3_sql(static_cast<sqlite3_stmt*>(pStatement));
+
+			auto pTrace = static_cast<Utility::CTraceWriter*>(pUserData);
+			pTrace->AddSpan("SQLite", "sqlite", end - std::chrono::duration_cast<Utility::CTraceWriter::Clock::duration>(elapsed), end,
+				{ { "sql", szSql != nullptr ? szSql : "" } });
+
+			return 0;
+		}, m_pTrace.get());
+	}
+
+	bool CDatabase::Prepare()
+	{
+		if (!m_pConnections)
+			return false;
+
+		try
+		{
+			EnsureSchema();
+		}
+		catch (const SQLite::Exception&)
+		{
+			return false;
+		}
+		catch (const std::filesystem::filesystem_error&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	void CDatabase::EnsureSchema() const
+	{
+		if (m_schemaReady)
+			return;
+
+		// A vault opened before only needs its version read, through a read-only connection: the writer connection (and
+		// the file locks it takes) is left to the contexts that write
+		if (std::filesystem::exists(m_dbPath))
+		{
+			const auto reader = m_pConnections->AcquireReader();
+			RegisterTraceCallback(*reader);
+
+			if (reader->execAndGet("PRAGMA user_version").getInt() >= SCHEMA_VERSION)
+			{
+				m_schemaReady = true;
+				return;
+			}
+		}
+
+		if (m_dbPath.has_parent_path())
+			std::filesystem::create_directories(m_dbPath.parent_path());
+
+		const auto writer = m_pConnections->LockWriter();
+		RegisterTraceCallback(*writer);
+
+		SQLite::Statement(*writer,
+			"CREATE TABLE IF NOT EXISTS syncUpdates( " \
+			"login VARCHAR(255) PRIMARY KEY, " \
+			"lastServerSyncTimestamp INT, " \
+			"lastClientSyncTimestamp INT " \
+			");"
+		).exec();
+
+		SQLite::Statement(*writer,
+			"CREATE TABLE IF NOT EXISTS transactions ( " \
+			"login VARCHAR(255), " \
+			"identifier VARCHAR(255), " \
+			"type VARCHAR(255) NOT NULL, " \
+			"action VARCHAR(255) NOT NULL, " \
+			"content BLOB, " \
+			"PRIMARY KEY (login, identifier) " \
+			");"
+		).exec();
+
+		SQLite::Statement(*writer,
+			"CREATE TABLE IF NOT EXISTS device ( " \
+			"login VARCHAR(255) PRIMARY KEY, " \
+			"version VARCHAR(255) NOT NULL, " \
+			"accessKey VARCHAR(255) NOT NULL, " \
+			"secretKeyEncrypted VARCHAR(255) NOT NULL, " \
+			"masterPasswordEncrypted VARCHAR(255), " \
+			"shouldNotSaveMasterPassword BIT NOT NULL, " \
+			"localKeyEncrypted VARCHAR(255) NOT NULL, " \
+			"autoSync BIT NOT NULL, " \
+			"authenticationMode VARCHAR(255), " \
+			"serverKeyEncrypted VARCHAR(255) " \
+			");"
+		).exec();
+
+		SQLite::Statement(*writer,
+			"CREATE TABLE IF NOT EXISTS derivedKeys ( " \
+			"login VARCHAR(255), " \
+			"keyIdentifier VARCHAR(255), " \
+			"passwordTag VARCHAR(255) NOT NULL, " \
+			"keyEncrypted VARCHAR(255) NOT NULL, " \
+			"PRIMARY KEY (login, keyIdentifier) " \
+			");"
+		).exec();
+
+		Migrate(*writer);
+
+		m_schemaReady = true;
+	}
+
+	void CDatabase::Migrate(SQLite::Database& database)
+	{
+		const int32_t version = database.execAndGet("PRAGMA user_version").getInt();
+		if (version >= SCHEMA_VERSION)
+			return;
+
+		SQLite::Transaction transaction(database);
+
+		if (version < 1)
+		{
+			// Track the server revision of each item so unchanged items are not recrypted on every sync
+			database.exec("ALTER TABLE transactions ADD COLUMN backupDate INT NOT NULL DEFAULT 0");
+
+			// Removed transactions used to be stored as empty rows
+			database.exec("DELETE FROM transactions WHERE action = 'BACKUP_REMOVE'");
+		}
+
+		if (version < 2)
+		{
+			// Lazy recrypt stores server envelopes as they are, they are recrypted with the local key on first read
+			database.exec("ALTER TABLE transactions ADD COLUMN recrypted BIT NOT NULL DEFAULT 1");
+		}
+
+		database.exec(std::format("PRAGMA user_version = {}", SCHEMA_VERSION));
+		transaction.commit();
+	}
+
+	void CDatabase::GetRegisteredUsers(std::vector<std::string>& users) const
+	{
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, "SELECT login FROM device");
+
+		while (stmt.executeStep())
+			users.emplace_back(stmt.getColumn(0).getString());
+	}
+
+	void CDatabase::RemoveUserData(const DashlaneContextInternal& context)
+	{
+		const auto writer = GetWriter();
+
+		std::array<const char*, 4> tables
+		{
+			"device",
+			"transactions",
+			"syncUpdates",
+			"derivedKeys"
+		};
+
+		for (const auto table : tables)
+		{
+			SQLite::Statement stmt(*writer, std::format("DELETE FROM {} WHERE login = ?", table));
+			stmt.bindNoCopy(1, context.login);
+			stmt.exec();
+		}
+	}
+
+	void CDatabase::Drop()
+	{
+		if (m_pConnections)
+		{
+			GetWriter()->exec(
+				"DROP TABLE IF EXISTS syncUpdates;" \
+				"DROP TABLE IF EXISTS transactions;" \
+				"DROP TABLE IF EXISTS device;" \
+				"DROP TABLE IF EXISTS derivedKeys;" \
+				"PRAGMA user_version = 0"
+			);
+
+			m_schemaReady = false;
+		}
+	}
+
+	void CDatabase::Disconnect()
+	{
+		// The connections are closed with the last database of the file
+		m_pConnections.reset();
+	}
+
+	bool CDatabase::GetDeviceConfiguration(const DashlaneContextInternal& context, SDeviceConfiguration& config) const
+	{
+		bool success = false;
+
+		if (m_pConnections)
+		{
+			const auto reader = GetReader();
+			SQLite::Statement stmt(*reader, "SELECT * FROM device WHERE login = ? LIMIT 1");
+			stmt.bindNoCopy(1, context.login);
+
+			if (stmt.executeStep())
+			{
+				if (stmt.hasRow())
+				{
+					config =
+					{
+						stmt.getColumn("accessKey").getString(),
+						stmt.getColumn("secretKeyEncrypted").getString(),
+						stmt.getColumn("masterPasswordEncrypted").getString(),
+						static_cast<bool>(stmt.getColumn("shouldNotSaveMasterPassword").getInt()),
+						stmt.getColumn("localKeyEncrypted").getString(),
+						stmt.getColumn("login").getString(),
+						stmt.getColumn("version").getString(),
+						static_cast<bool>(stmt.getColumn("autoSync").getInt()),
+						static_cast<E2FAType>(stmt.getColumn("authenticationMode").getInt()),
+						stmt.getColumn("serverKeyEncrypted").getString()
+					};
+
+					success = true;
+				}
+			}
+
+			// Default device configuration
+			if (!success)
+				config = SDeviceConfiguration();
+		}
+
+		return success;
+	}
+
+	bool CDatabase::SetDeviceConfiguration(const SDeviceConfiguration& config)
+	{
+		const auto writer = GetWriter();
+
+		SQLite::Statement stmt(*writer, "REPLACE INTO device VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+		stmt.bindNoCopy(1, config.login);
+		stmt.bindNoCopy(2, config.version);
+		stmt.bindNoCopy(3, config.accessKey);
+		stmt.bindNoCopy(4, config.secretKeyEncrypted);
+
+		if (config.shouldNotSaveMasterPassword)
+			stmt.bindNoCopy(5, "");
+		else
+			stmt.bindNoCopy(5, config.masterPasswordEncrypted);
+
+		stmt.bind(6, config.shouldNotSaveMasterPassword);
+		stmt.bindNoCopy(7, config.localKeyEncrypted);
+		stmt.bind(8, config.autoSync);
+		stmt.bind(9, std::underlying_type_t<E2FAType>(config.authenticationMode));
+		stmt.bindNoCopy(10, config.serverKeyEncrypted);
+
+		stmt.exec();
+
+		return true;
+	}
+
+	uint64_t CDatabase::GetLastSyncTime(DashlaneContextInternal& context) const
+	{
+		uint64_t time = 0;
+
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, "SELECT lastClientSyncTimestamp FROM syncUpdates WHERE login = ?");
+		stmt.bindNoCopy(1, context.login);
+
+		if (stmt.executeStep())
+			time = stmt.getColumn(0).getUInt();
+
+		return time;
+	}
+
+	uint64_t CDatabase::GetLastServerSyncTime(DashlaneContextInternal& context) const
+	{
+		uint64_t time = 0;
+
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, "SELECT lastServerSyncTimestamp FROM syncUpdates WHERE login = ?");
+		stmt.bindNoCopy(1, context.login);
+
+		if (stmt.executeStep())
+			time = stmt.getColumn(0).getUInt();
+
+		return time;
+	}
+
+	bool CDatabase::UpdateLastSyncTime(DashlaneContextInternal& context, uint32_t lastServerSyncTime)
+	{
+		const auto writer = GetWriter();
+
+		SQLite::Statement stmt(*writer, "REPLACE INTO syncUpdates (login, lastServerSyncTimestamp, lastClientSyncTimestamp) VALUES(?, ?, ?)");
+		stmt.bindNoCopy(1, context.login);
+		stmt.bind(2, lastServerSyncTime);
+		stmt.bind(3, static_cast<uint32_t>(Utility::GetUnixTimestamp()));
+		return stmt.exec() > 0;
+	}
+
+	EDashlaneError CDatabase::GetTransactions(const DashlaneContextInternal& context, const bitmask<ERawTransactionType> types, std::vector<SRawTransactionBackupEdit>& transactions) const
+	{
+		// Build filter query
+		std::string typeQuery;
+		for (const auto& type : types)
+		{
+			if (typeQuery.empty())
+				typeQuery = " AND (`type` = ?";
+			else
+				typeQuery += " OR `type` = ?";
+		}
+		if (!typeQuery.empty()) typeQuery += ")";
+
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, std::format("SELECT * FROM transactions WHERE login = ? AND action = 'BACKUP_EDIT'{}", typeQuery));
+		int bindPos = 1;
+		stmt.bindNoCopy(bindPos++, context.login);
+
+		for (const auto& type : types)
+			stmt.bind(bindPos++, std::string(nlohmann::ordered_json(type.value)));
+
+		while (stmt.executeStep())
+		{
+			SRawTransactionBackupEdit transaction;
+			transaction.identifier = stmt.getColumn("identifier").getString();
+			transaction.content = stmt.getColumn("content").getString();
+			transaction.type = stmt.getColumn("type").getString();
+			transaction.backupDate = stmt.getColumn("backupDate").getUInt();
+			transaction.recrypted = static_cast<bool>(stmt.getColumn("recrypted").getInt());
+			transactions.emplace_back(std::move(transaction));
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError CDatabase::GetTransaction(const DashlaneContextInternal& context, const std::string& identifier, SRawTransactionBackupEdit& transaction) const
+	{
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, "SELECT identifier, type, content, backupDate, recrypted FROM transactions " \
+			"WHERE login = ? AND identifier = ? AND action = 'BACKUP_EDIT'");
+		stmt.bindNoCopy(1, context.login);
+		stmt.bindNoCopy(2, identifier);
+
+		if (!stmt.executeStep())
+			return EDashlaneError::TransactionNotFound;
+
+		transaction.identifier = stmt.getColumn(0).getString();
+		transaction.type = stmt.getColumn(1).getString();
+		transaction.content = stmt.getColumn(2).getString();
+		transaction.backupDate = stmt.getColumn(3).getUInt();
+		transaction.recrypted = static_cast<bool>(stmt.getColumn(4).getInt());
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError CDatabase::GetTransactionsPage(const DashlaneContextInternal& context, const bitmask<ERawTransactionType> types,
+		const std::string& afterIdentifier, uint32_t limit, std::vector<SRawTransactionBackupEdit>& transactions) const
+	{
+		std::string typeQuery;
+		for (const auto& type : types)
+		{
+			if (typeQuery.empty())
+				typeQuery = " AND (`type` = ?";
+			else
+				typeQuery += " OR `type` = ?";
+		}
+		if (!typeQuery.empty()) typeQuery += ")";
+
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, std::format("SELECT identifier, type, content, backupDate, recrypted FROM transactions " \
+			"WHERE login = ? AND action = 'BACKUP_EDIT' AND identifier > ?{} ORDER BY identifier LIMIT ?", typeQuery));
+		int bindPos = 1;
+		stmt.bindNoCopy(bindPos++, context.login);
+		stmt.bindNoCopy(bindPos++, afterIdentifier);
+
+		for (const auto& type : types)
+			stmt.bind(bindPos++, std::string(nlohmann::ordered_json(type.value)));
+
+		stmt.bind(bindPos++, limit);
+
+		while (stmt.executeStep())
+		{
+			SRawTransactionBackupEdit transaction;
+			transaction.identifier = stmt.getColumn(0).getString();
+			transaction.type = stmt.getColumn(1).getString();
+			transaction.content = stmt.getColumn(2).getString();
+			transaction.backupDate = stmt.getColumn(3).getUInt();
+			transaction.recrypted = static_cast<bool>(stmt.getColumn(4).getInt());
+			transactions.emplace_back(std::move(transaction));
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+	void CDatabase::GetPendingRecryptTransactions(const DashlaneContextInternal& context, const std::string& afterIdentifier, uint32_t limit,
+		std::vector<SRawTransactionBackupEdit>& transactions) const
+	{
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, "SELECT identifier, type, content, backupDate FROM transactions " \
+			"WHERE login = ? AND recrypted = 0 AND identifier > ? ORDER BY identifier LIMIT ?");
+		stmt.bindNoCopy(1, context.login);
+		stmt.bindNoCopy(2, afterIdentifier);
+		stmt.bind(3, limit);
+
+		while (stmt.executeStep())
+		{
+			SRawTransactionBackupEdit transaction;
+			transaction.identifier = stmt.getColumn(0).getString();
+			transaction.type = stmt.getColumn(1).getString();
+			transaction.content = stmt.getColumn(2).getString();
+			transaction.backupDate = stmt.getColumn(3).getUInt();
+			transaction.recrypted = false;
+			transactions.emplace_back(std::move(transaction));
+		}
+	}
+
+	bool CDatabase::UpdateRecryptedTransactions(const DashlaneContextInternal& context, const std::vector<STransactionRow>& rows,
+		bool waitForWriter)
+	{
+		const auto writer = waitForWriter ? std::optional(GetWriter()) : TryGetWriter();
+		if (!writer)
+			return false;
+
+		try
+		{
+			SQLite::Transaction transaction(**writer);
+
+			SQLite::Statement stmt(**writer, "UPDATE transactions SET content = ?, recrypted = 1 " \
+				"WHERE login = ? AND identifier = ? AND backupDate = ? AND recrypted = 0");
+
+			for (const STransactionRow& row : rows)
+			{
+				stmt.bindNoCopy(1, row.content);
+				stmt.bindNoCopy(2, context.login);
+				stmt.bindNoCopy(3, row.identifier);
+				stmt.bind(4, row.backupDate);
+				stmt.exec();
+				stmt.reset();
+			}
+
+			transaction.commit();
+		}
+		catch (const SQLite::Exception&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CDatabase::AddTransactionData(const STransactionRow& row)
+	{
+		const auto writer = GetWriter();
+
+		SQLite::Statement stmt(*writer, "REPLACE INTO transactions (login, identifier, type, action, content, backupDate, recrypted) VALUES (?, ?, ?, ?, ?, ?, ?)");
+		stmt.bindNoCopy(1, row.login);
+		stmt.bindNoCopy(2, row.identifier);
+		stmt.bindNoCopy(3, row.type);
+		stmt.bindNoCopy(4, row.action);
+		stmt.bindNoCopy(5, row.content);
+		stmt.bind(6, row.backupDate);
+		stmt.bind(7, row.recrypted);
+
+		return stmt.exec() > 0;
+	}
+
+	bool CDatabase::AddMultipleTransactionData(const std::vector<STransactionRow>& rows)
+	{
+		const auto writer = GetWriter();
+
+		// A single prepared statement re-used per row, a multi-row VALUES list would hit the bound parameter limit on large vaults
+		SQLite::Statement stmt(*writer, "REPLACE INTO transactions (login, identifier, type, action, content, backupDate, recrypted) VALUES (?, ?, ?, ?, ?, ?, ?)");
+
+		for (const STransactionRow& row : rows)
+		{
+			stmt.bindNoCopy(1, row.login);
+			stmt.bindNoCopy(2, row.identifier);
+			stmt.bindNoCopy(3, row.type);
+			stmt.bindNoCopy(4, row.action);
+			stmt.bindNoCopy(5, row.content);
+			stmt.bind(6, row.backupDate);
+			stmt.bind(7, row.recrypted);
+
+			if (stmt.exec() == 0)
+				return false;
+
+			stmt.reset();
+		}
+
+		return true;
+	}
+
+	bool CDatabase::RemoveMultipleTransactionData(const DashlaneContextInternal& context, const std::vector<std::string>& identifiers)
+	{
+		const auto writer = GetWriter();
+
+		SQLite::Statement stmt(*writer, "DELETE FROM transactions WHERE login = ? AND identifier = ?");
+
+		for (const std::string& identifier : identifiers)
+		{
+			stmt.bindNoCopy(1, context.login);
+			stmt.bindNoCopy(2, identifier);
+			stmt.exec();
+			stmt.reset();
+		}
+
+		return true;
+	}
+
+	bool CDatabase::ApplyTransactionChanges(DashlaneContextInternal& context, const std::vector<STransactionRow>& rows,
+		const std::vector<std::string>& removedIdentifiers, uint32_t lastServerSyncTime)
+	{
+		const auto writer = GetWriter();
+
+		try
+		{
+			SQLite::Transaction transaction(*writer);
+
+			if (!AddMultipleTransactionData(rows))
+				return false;
+
+			if (!RemoveMultipleTransactionData(context, removedIdentifiers))
+				return false;
+
+			if (!UpdateLastSyncTime(context, lastServerSyncTime))
+				return false;
+
+			transaction.commit();
+		}
+		catch (const SQLite::Exception&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	void CDatabase::GetTransactionRevisions(const DashlaneContextInternal& context, std::map<std::string, uint32_t>& revisions) const
+	{
+		const auto reader = GetReader();
+		SQLite::Statement stmt(*reader, "SELECT identifier, backupDate FROM transactions WHERE login = ?");
+		stmt.bindNoCopy(1, context.login);
+
+		while (stmt.executeStep())
+			revisions.emplace(stmt.getColumn(0).getString(), stmt.getColumn(1).getUInt());
+	}
+
+	bool CDatabase::GetDerivedKeys(const DashlaneContextInternal& context, const std::string& passwordTag, std::map<std::string, std::string>& keys)
+	{
+		try
+		{
+			const auto reader = GetReader();
+			SQLite::Statement stmt(*reader, "SELECT keyIdentifier, keyEncrypted FROM derivedKeys WHERE login = ? AND passwordTag = ?");
+			stmt.bindNoCopy(1, context.login);
+			stmt.bindNoCopy(2, passwordTag);
+
+			while (stmt.executeStep())
+				keys.emplace(stmt.getColumn(0).getString(), stmt.getColumn(1).getString());
+		}
+		catch (const SQLite::Exception&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CDatabase::RemoveStaleDerivedKeys(const DashlaneContextInternal& context, const std::string& passwordTag)
+	{
+		try
+		{
+			// The writer is only needed when the master password changed, an unchanged vault stays read-only
+			bool hasStaleKeys = false;
+			{
+				const auto reader = GetReader();
+				SQLite::Statement stmt(*reader, "SELECT EXISTS(SELECT 1 FROM derivedKeys WHERE login = ? AND passwordTag <> ?)");
+				stmt.bindNoCopy(1, context.login);
+				stmt.bindNoCopy(2, passwordTag);
+
+				hasStaleKeys = stmt.executeStep() && stmt.getColumn(0).getInt() != 0;
+			}
+
+			if (hasStaleKeys)
+			{
+				const auto writer = GetWriter();
+				SQLite::Statement remove(*writer, "DELETE FROM derivedKeys WHERE login = ? AND passwordTag <> ?");
+				remove.bindNoCopy(1, context.login);
+				remove.bindNoCopy(2, passwordTag);
+				remove.exec();
+			}
+		}
+		catch (const SQLite::Exception&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CDatabase::AddDerivedKey(const DashlaneContextInternal& context, const std::string& keyIdentifier, const std::string& passwordTag, const std::string& keyEncrypted)
+	{
+		const auto writer = GetWriter();
+
+		try
+		{
+			SQLite::Statement stmt(*writer, "REPLACE INTO derivedKeys (login, keyIdentifier, passwordTag, keyEncrypted) VALUES (?, ?, ?, ?)");
+			stmt.bindNoCopy(1, context.login);
+			stmt.bindNoCopy(2, keyIdentifier);
+			stmt.bindNoCopy(3, passwordTag);
+			stmt.bindNoCopy(4, keyEncrypted);
+
+			return stmt.exec() > 0;
+		}
+		catch (const SQLite::Exception&)
+		{
+			return false;
+		}
+	}
+
 }
\ No newline at end of file
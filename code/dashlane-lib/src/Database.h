@@ -1,69 +1,130 @@
-#pragma once
-
-#include "Types/Auth.h"
-#include "Types/Transactions.h"
-
-// Forward Decls.
-namespace SQLite
-{
-	class Database;
-}
-
-namespace Dashlane
-{
-
-	struct DashlaneContextInternal;
-
-	struct STransactionRow
-	{
-		STransactionRow(const std::string& login, const std::string& identifier, 
-			const std::string& type, const std::string& action, const std::string& content)
-			: login(login)
-			, identifier(identifier)
-			, type(type)
-			, action(action)
-			, content(content)
-		{}
-
-		std::string login;
-		std::string identifier;
-		std::string type;
-		std::string action;
-		std::string content;
-	};
-
-	class CDatabase
-	{
-
-	public:
-
-		CDatabase(const std::filesystem::path& dbPath = "");
-		~CDatabase();
-
-		bool Connect();
-		bool Prepare();
-		void Disconnect();
-		void Drop();
-
-		void GetRegisteredUsers(std::vector<std::string>& users) const;
-		void RemoveUserData(const DashlaneContextInternal& context);
-
-		bool GetDeviceConfiguration(const DashlaneContextInternal& context, SDeviceConfiguration& config) const;
-		bool SetDeviceConfiguration(const SDeviceConfiguration& config);
-
-		uint64_t GetLastSyncTime(DashlaneContextInternal& pContext) const;
-		bool UpdateLastSyncTime(DashlaneContextInternal& pContext, uint32_t lastServerSyncTime);
-
-		bool AddTransactionData(const STransactionRow& row);
-		bool AddMultipleTransactionData(const std::vector<STransactionRow>& rows);
-		EDashlaneError GetTransactions(const DashlaneContextInternal& context, bitmask<ERawTransactionType> types, 
-			std::vector<SRawTransactionBackupEdit>& transactions) const;
-
-	private:
-
-		std::filesystem::path m_dbPath;
-		std::unique_ptr<SQLite::Database> m_pDatabase;
-
-	};
-
+#pragma once
+
+#include "ConnectionPool.h"
+#include "Types/Auth.h"
+#include "Types/Transactions.h"
+
+namespace Utility
+{
+	class CTraceWriter;
+}
+
+namespace Dashlane
+{
+
+	struct DashlaneContextInternal;
+
+	struct STransactionRow
+	{
+		STransactionRow(const std::string& login, const std::string& identifier, 
+			const std::string& type, const std::string& action, const std::string& content, uint32_t backupDate = 0, bool recrypted = true)
+			: login(login)
+			, identifier(identifier)
+			, type(type)
+			, action(action)
+			, content(content)
+			, backupDate(backupDate)
+			, recrypted(recrypted)
+		{}
+
+		std::string login;
+		std::string identifier;
+		std::string type;
+		std::string action;
+		std::string content;
+		uint32_t backupDate{ 0 }; // Server revision of the transaction
+		bool recrypted{ true };	// False when content is the server envelope, encrypted with the master password
+	};
+
+	// Reads borrow a read-only connection from the pool of the file for the duration of the call, so queries running on
+	// several threads do not share a connection nor wait for a synchronization. Writes go through the single writer
+	// connection of the pool, shared with every other CDatabase opened on the same file in the process.
+	class CDatabase
+	{
+
+	public:
+
+		CDatabase(const std::filesystem::path& dbPath = "");
+		~CDatabase();
+
+		// Only binds the database to the connection pool of its file, the file is opened (and created) on first use
+		bool Connect();
+
+		// Creates or migrates the tables now instead of on first use, false when the file cannot be opened or created
+		bool Prepare();
+		void Disconnect();
+		void Drop();
+
+		const std::filesystem::path& GetPath() const { return m_dbPath; }
+
+		// Records a span for every executed statement, null to stop tracing
+		void SetTraceWriter(const std::shared_ptr<Utility::CTraceWriter>& pTrace);
+
+		// Applies to every connection to the file, only once connected
+		void SetConnectionOptions(std::chrono::milliseconds busyTimeout, size_t maxReaders);
+
+		void GetRegisteredUsers(std::vector<std::string>& users) const;
+		void RemoveUserData(const DashlaneContextInternal& context);
+
+		bool GetDeviceConfiguration(const DashlaneContextInternal& context, SDeviceConfiguration& config) const;
+		bool SetDeviceConfiguration(const SDeviceConfiguration& config);
+
+		uint64_t GetLastSyncTime(DashlaneContextInternal& pContext) const;
+		uint64_t GetLastServerSyncTime(DashlaneContextInternal& pContext) const;
+		bool UpdateLastSyncTime(DashlaneContextInternal& pContext, uint32_t lastServerSyncTime);
+
+		bool AddTransactionData(const STransactionRow& row);
+		bool AddMultipleTransactionData(const std::vector<STransactionRow>& rows);
+		bool RemoveMultipleTransactionData(const DashlaneContextInternal& context, const std::vector<std::string>& identifiers);
+
+		// Applies a synchronization delta and the new server sync time in a single database transaction
+		bool ApplyTransactionChanges(DashlaneContextInternal& context, const std::vector<STransactionRow>& rows,
+			const std::vector<std::string>& removedIdentifiers, uint32_t lastServerSyncTime);
+
+		// Maps transaction identifiers to their stored server revision (backupDate)
+		void GetTransactionRevisions(const DashlaneContextInternal& context, std::map<std::string, uint32_t>& revisions) const;
+		EDashlaneError GetTransactions(const DashlaneContextInternal& context, bitmask<ERawTransactionType> types, 
+			std::vector<SRawTransactionBackupEdit>& transactions) const;
+
+		// Single transaction by its identifier, through the (login, identifier) primary key
+		EDashlaneError GetTransaction(const DashlaneContextInternal& context, const std::string& identifier, SRawTransactionBackupEdit& transaction) const;
+
+		// Next page of transactions by identifier from afterIdentifier (exclusive), no statement stays open between pages
+		EDashlaneError GetTransactionsPage(const DashlaneContextInternal& context, bitmask<ERawTransactionType> types,
+			const std::string& afterIdentifier, uint32_t limit, std::vector<SRawTransactionBackupEdit>& transactions) const;
+
+		// Server envelopes not recrypted yet, by identifier from afterIdentifier (exclusive)
+		void GetPendingRecryptTransactions(const DashlaneContextInternal& context, const std::string& afterIdentifier, uint32_t limit,
+			std::vector<SRawTransactionBackupEdit>& transactions) const;
+
+		// Replaces server envelopes by their recrypted content, rows changed by a synchronization in between are kept.
+		// Without waitForWriter, nothing is written (and false returned) while another write is running
+		bool UpdateRecryptedTransactions(const DashlaneContextInternal& context, const std::vector<STransactionRow>& rows,
+			bool waitForWriter = true);
+
+		// Maps the identifiers of the keys derived for passwordTag to their encrypted value
+		bool GetDerivedKeys(const DashlaneContextInternal& context, const std::string& passwordTag, std::map<std::string, std::string>& keys);
+		// Removes the keys derived for any other tag, only once passwordTag is known to be the right master password
+		bool RemoveStaleDerivedKeys(const DashlaneContextInternal& context, const std::string& passwordTag);
+		bool AddDerivedKey(const DashlaneContextInternal& context, const std::string& keyIdentifier, const std::string& passwordTag, const std::string& keyEncrypted);
+
+	private:
+
+		// Tables are created and migrated by the first connection borrowed, skipped when user_version is current
+		void EnsureSchema() const;
+		static void Migrate(SQLite::Database& database);
+		void RegisterTraceCallback(SQLite::Database& database) const;
+
+		// Connections of the pool with the trace callback of this database registered
+		CConnectionPool::CWriter GetWriter() const;
+		std::optional<CConnectionPool::CWriter> TryGetWriter() const;
+		CConnectionPool::CReader GetReader() const;
+
+		std::filesystem::path m_dbPath;
+		std::shared_ptr<CConnectionPool> m_pConnections;
+		std::shared_ptr<Utility::CTraceWriter> m_pTrace;
+		mutable std::atomic<bool> m_schemaReady{ false };
+
+	};
+
 }
\ No newline at end of file
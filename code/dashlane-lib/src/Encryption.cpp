@@ -1,306 +1,434 @@
-#include "StdAfx.h"
-#include "Dashlane.h"
-#include "Encryption.h"
-#include "Utility/Cryptography.h"
-#include "Utility/Transaction.h"
-#include "Utility/Vector.h"
-#include "Utility/Zip.h"
-
-#include <argon2.h>
-
-namespace Dashlane
-{
-
-	class CSymmetricKeyRegistry
-	{
-
-	public:
-
-		static void AddKey(const std::vector<uint8_t>& signature, const std::vector<uint8_t>& key)
-		{
-			m_registry[signature] = key;
-		}
-
-		static const std::vector<uint8_t>& GetKey(const std::vector<uint8_t>& signature)
-		{
-			static const std::vector<uint8_t> empty;
-
-			if (IsRegistered(signature))
-			{
-				return m_registry[signature];
-			}
-
-			return empty;
-		}
-
-		static bool IsRegistered(const std::vector<uint8_t>& signature)
-		{
-			return m_registry.contains(signature);
-		}
-
-	private:
-
-		static std::map<std::vector<std::uint8_t>, std::vector<uint8_t>> m_registry;
-
-	};
-
-	std::map<std::vector<uint8_t>, std::vector<uint8_t>> CSymmetricKeyRegistry::m_registry = {};
-
-	void CEncryption::ResetContext()
-	{
-		m_context = std::move(SEncryptionContext());
-	}
-
-	bool CEncryption::EncryptData(const std::vector<uint8_t>& symmetricKey, const std::vector<uint8_t>& input, SEncryptedData& encryptedDataOut)
-	{
-		bool success = false;
-
-		if (symmetricKey.size() > 0 && input.size() > 0)
-		{
-			m_context.input = input;
-			if (GenerateRandomIV())
-			{
-				auto [cipherKey, hmacKey] = SplitSymmetricKey(symmetricKey);
-				m_context.symmetricKey = symmetricKey;
-				m_context.cipherKey = cipherKey;
-				m_context.hmacKey = hmacKey;
-
-				if (EncryptWithAES256())
-				{
-					m_context.input = m_context.output; // Signature generation uses input, which requires encrypted payload
-
-					encryptedDataOut.pKeyDerivation = std::make_unique<SDerivationConfigNone>();
-					encryptedDataOut.cipherConfig.ivLength = m_context.iv.size();
-					encryptedDataOut.cipherConfig.cipherMode = ECipherMode::CBCHMAC;
-					encryptedDataOut.cipherData.salt = {};
-					encryptedDataOut.cipherData.iv = m_context.iv;
-					encryptedDataOut.cipherData.hash = CreateSignatureHash();
-					encryptedDataOut.cipherData.encryptedPayload = m_context.input;
-
-					success = true;
-				}
-			}
-		}
-
-		return success;
-	}
-
-	bool CEncryption::DecryptFromContext()
-	{
-		if (CreateSignatureHash() != m_context.hash)
-		{
-			return false;
-		}
-
-		if (!DecryptWithAES256())
-		{
-			return false;
-		}
-
-		return true;
-	}
-
-	EDashlaneError CEncryption::GetSymmetricKeyFromData(
-		const DashlaneContextInternal& context, 
-		const std::vector<uint8_t>& rawPayload, 
-		const SEncryptedData& encryptedData,
-		std::vector<uint8_t>& symmetricKey
-	) const
-	{
-		std::vector<uint8_t> keyIdentifierBytes;
-		const uint32_t ivLength = encryptedData.cipherConfig.ivLength;
-		const uint32_t payloadSize = encryptedData.cipherData.encryptedPayload.size();
-		const uint32_t keyIdentifierBytesEnd = rawPayload.size() - ivLength - 32 - payloadSize;
-		keyIdentifierBytes.assign(rawPayload.begin(), rawPayload.begin() + keyIdentifierBytesEnd);
-
-		// Essentially we salt the key bytes in case the master password turns out to be invalid
-		// TODO: We can remove this if we clear the registry if the master password is invalid?
-		Utility::AppendToVector(keyIdentifierBytes, context.secrets.masterPassword);
-
-		if (!CSymmetricKeyRegistry::IsRegistered(keyIdentifierBytes))
-		{
-			if (!GetSymmetricKeyViaDerivate(*encryptedData.pKeyDerivation, encryptedData.cipherData.salt, context.secrets.masterPassword, symmetricKey))
-			{
-				return EDashlaneError::InvalidMasterPassword;
-			}
-
-			CSymmetricKeyRegistry::AddKey(keyIdentifierBytes, symmetricKey);
-		}
-		else
-		{
-			symmetricKey = CSymmetricKeyRegistry::GetKey(keyIdentifierBytes);
-		}
-
-		return EDashlaneError::NoError;
-	}
-
-	bool CEncryption::GetSymmetricKeyViaDerivate(
-		const IDerivationConfig& config, 
-		const std::vector<uint8_t>& salt,
-		const std::string masterPassword,
-		std::vector<uint8_t>& symmetricKey
-	) const
-	{
-		symmetricKey.resize(32);
-
-		switch (config.GetDerivation())
-		{
-		case EDerivationAlgorithm::Argon2D:
-		{
-			const auto& argon2 = static_cast<const SDerivationConfigArgon2&>(config);
-			return ARGON2_OK == argon2d_hash_raw(
-				argon2.tCost,
-				argon2.mCost,
-				argon2.parallelism,
-				masterPassword.c_str(),
-				masterPassword.size(),
-				salt.data(),
-				argon2.saltLength,
-				symmetricKey.data(), 32);
-
-		} break;
-
-		case EDerivationAlgorithm::PBKDF2:
-		{
-			const auto& pbkdf2 = static_cast<const SDerivationConfigPbkdf2&>(config);
-			return Utility::OPENSSL_RC_SUCCESS == PKCS5_PBKDF2_HMAC(
-				masterPassword.c_str(),
-				masterPassword.size(),
-				salt.data(),
-				pbkdf2.saltLength,
-				pbkdf2.iterations,
-				EVP_sha512(),
-				32, symmetricKey.data());
-
-		} break;
-		}
-
-		return true;
-	}
-
-	bool CEncryption::SetContextFromEncryptedData(const std::vector<uint8_t>& symmetricKey, const std::vector<uint8_t>& input, SEncryptedData& data)
-	{
-		if (symmetricKey.size() == 0)
-		{
-			return false;
-		}
-
-		if (input.size() == 0)
-		{
-			return false;
-		}
-
-		auto [cipherKey, hmacKey] = SplitSymmetricKey(symmetricKey);
-
-		// Update context
-		m_context.symmetricKey = symmetricKey;
-		m_context.cipherKey = cipherKey;
-		m_context.hmacKey = hmacKey;
-		m_context.cipherMode = data.cipherConfig.cipherMode;
-		m_context.pKeyDerivationConfig.swap(data.pKeyDerivation);
-		m_context.salt = data.cipherData.salt;
-		m_context.iv = data.cipherData.iv;
-		m_context.hash = data.cipherData.hash;
-		m_context.input = data.cipherData.encryptedPayload;
-
-		return true;
-	}
-
-	bool CEncryption::GenerateRandomIV()
-	{
-		bool success = true;
-
-		m_context.iv.resize(16);
-		if (Utility::OPENSSL_RC_SUCCESS != RAND_bytes(m_context.iv.data(), m_context.iv.size()))
-		{
-			m_context.iv.resize(0);
-			success = false;
-		}
-
-		return success;
-	}
-
-	std::vector<uint8_t> CEncryption::CreateSignatureHash() const
-	{
-		const std::vector<uint8_t> data = Utility::CreateChainedVector(m_context.iv, m_context.input);
-		return Utility::HmacSHA256(m_context.hmacKey, data);
-	}
-
-	std::tuple<std::vector<uint8_t>, std::vector<uint8_t>> CEncryption::SplitSymmetricKey(const std::vector<uint8_t>& symmetricKey) const
-	{
-		std::vector<uint8_t> combinedKey = Utility::SHA512(symmetricKey);
-		return { Utility::SliceVectorByCopy(combinedKey, 0, 32) ,Utility::SliceVectorByCopy(combinedKey, 32) };
-	}
-
-	bool CEncryption::EncryptWithAES256()
-	{
-		bool success = false;
-
-		if (m_context.input.size() > 0)
-		{
-			if (EVP_CIPHER_CTX* pCtx = EVP_CIPHER_CTX_new())
-			{
-				const EVP_CIPHER* pCipher = EVP_aes_256_cbc();
-				const size_t blockSize = EVP_CIPHER_block_size(pCipher);
-
-				if (Utility::OPENSSL_RC_SUCCESS == EVP_EncryptInit_ex(pCtx, pCipher, NULL, m_context.cipherKey.data(), m_context.iv.data()))
-				{
-					m_context.output.resize(m_context.input.size() + blockSize - ((m_context.input.size() + blockSize) % blockSize));
-
-					int written = 0;
-					auto pInputData = reinterpret_cast<const unsigned char*>(m_context.input.data());
-					auto pOutputData = reinterpret_cast<unsigned char*>(m_context.output.data());
-					const auto inputSize = m_context.input.size();
-					if (Utility::OPENSSL_RC_SUCCESS == EVP_EncryptUpdate(pCtx, pOutputData, &written, pInputData, inputSize))
-					{
-						if (Utility::OPENSSL_RC_SUCCESS == EVP_EncryptFinal_ex(pCtx, pOutputData + written, &written))
-						{
-							success = true;
-						}
-					}
-				}
-
-				EVP_CIPHER_CTX_free(pCtx);
-			}
-		}
-
-		if (!success)
-		{
-			m_context.output.resize(0);
-		}
-
-		return success;
-	}
-
-	bool CEncryption::DecryptWithAES256()
-	{
-		bool success = false;
-
-		if (EVP_CIPHER_CTX* pCtx = EVP_CIPHER_CTX_new())
-		{
-			int written = 0;
-			int written_final = 0;
-
-			if (Utility::OPENSSL_RC_SUCCESS == EVP_DecryptInit_ex(pCtx, EVP_aes_256_cbc(), NULL, m_context.cipherKey.data(), m_context.iv.data()))
-			{
-				m_context.output.resize(m_context.input.size());
-				if (Utility::OPENSSL_RC_SUCCESS == EVP_DecryptUpdate(pCtx, m_context.output.data(), &written, m_context.input.data(), m_context.input.size()))
-				{
-					EVP_DecryptFinal_ex(pCtx, m_context.output.data() + written, &written_final);
-					m_context.output.resize(written + written_final); // Shrink to fit
-					success = true;
-				}
-			}
-
-			EVP_CIPHER_CTX_free(pCtx);
-		}
-
-		if (!success)
-		{
-			m_context.output.resize(0);
-		}
-
-		return success;
-	}
-
+#include "StdAfx.h"
+#include "Dashlane.h"
+#include "Encryption.h"
+#include "Keychain.h"
+#include "Utility/Cryptography.h"
+#include "Utility/Transaction.h"
+#include "Utility/Vector.h"
+#include "Utility/Zip.h"
+
+#include <argon2.h>
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace Dashlane
+{
+
+	// Shared by every context, the background sync worker and the threads running queries.
+	// Lookups take the lock shared, only a newly derived key takes it exclusively.
+	// Signatures contain the master password, both signatures and keys live in the secure pool.
+	class CSymmetricKeyRegistry
+	{
+
+	public:
+
+		static void AddKey(const Utility::SecureBuffer& signature, const Utility::SecureBuffer& key)
+		{
+			std::unique_lock<std::shared_mutex> lock(m_mutex);
+			m_registry[signature] = key;
+		}
+
+		static bool GetKey(const Utility::SecureBuffer& signature, Utility::SecureBuffer& key)
+		{
+			std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+			if (const auto it = m_registry.find(signature); it != m_registry.end())
+			{
+				key = it->second;
+				return true;
+			}
+
+			return false;
+		}
+
+		static void Clear()
+		{
+			std::unique_lock<std::shared_mutex> lock(m_mutex);
+			m_registry.clear();
+		}
+
+	private:
+
+		static std::shared_mutex m_mutex;
+		static std::map<Utility::SecureBuffer, Utility::SecureBuffer> m_registry;
+
+	};
+
+	std::shared_mutex CSymmetricKeyRegistry::m_mutex;
+	std::map<Utility::SecureBuffer, Utility::SecureBuffer> CSymmetricKeyRegistry::m_registry = {};
+
+	void CEncryption::ClearKeyRegistry()
+	{
+		CSymmetricKeyRegistry::Clear();
+	}
+
+	void CEncryption::ResetContext()
+	{
+		m_context = SEncryptionContext(m_pResource);
+	}
+
+	bool CEncryption::EncryptData(std::span<const uint8_t> symmetricKey, std::span<const uint8_t> input, SEncryptedData& encryptedDataOut)
+	{
+		bool success = false;
+
+		if (symmetricKey.size() > 0 && input.size() > 0)
+		{
+			m_context.input.assign(input.begin(), input.end());
+			if (GenerateRandomIV())
+			{
+				SplitSymmetricKey(symmetricKey);
+				m_context.symmetricKey.assign(symmetricKey.begin(), symmetricKey.end());
+
+				if (EncryptWithAES256())
+				{
+					m_context.input = m_context.output; // Signature generation uses input, which requires encrypted payload
+
+					encryptedDataOut.keyDerivation.emplace<SDerivationConfigNone>();
+					encryptedDataOut.cipherConfig.ivLength = m_context.iv.size();
+					encryptedDataOut.cipherConfig.cipherMode = ECipherMode::CBCHMAC;
+					encryptedDataOut.cipherData.salt.clear();
+					encryptedDataOut.cipherData.iv = m_context.iv;
+					encryptedDataOut.cipherData.hash = CreateSignatureHash();
+					encryptedDataOut.cipherData.encryptedPayload = m_context.input;
+
+					success = true;
+				}
+			}
+		}
+
+		return success;
+	}
+
+	bool CEncryption::DecryptFromContext()
+	{
+		if (!VerifySignatureHash(m_context.iv, m_context.input, m_context.hash))
+		{
+			return false;
+		}
+
+		if (!DecryptWithAES256())
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CEncryption::DecryptFromView(std::span<const uint8_t> symmetricKey, const SEncryptedDataView& data)
+	{
+		if (symmetricKey.size() == 0)
+		{
+			return false;
+		}
+
+		SplitSymmetricKey(symmetricKey);
+		m_context.cipherMode = data.cipherConfig.cipherMode;
+
+		if (!VerifySignatureHash(data.cipherData.iv, data.cipherData.encryptedPayload, data.cipherData.hash))
+		{
+			return false;
+		}
+
+		return DecryptWithAES256(data.cipherData.iv, data.cipherData.encryptedPayload);
+	}
+
+	EDashlaneError CEncryption::GetSymmetricKeyFromData(
+		const DashlaneContextInternal& context, 
+		std::span<const uint8_t> rawPayload, 
+		const SEncryptedDataView& encryptedData,
+		Utility::SecureBuffer& symmetricKey
+	) const
+	{
+		// Every envelope field up to the IV (derivation parameters and salt) identifies the key
+		Utility::SecureBuffer keyIdentifierBytes;
+		const size_t keyIdentifierBytesEnd = encryptedData.cipherData.iv.data() - rawPayload.data();
+		keyIdentifierBytes.reserve(keyIdentifierBytesEnd + context.secrets.masterPassword.size());
+		keyIdentifierBytes.assign(rawPayload.begin(), rawPayload.begin() + keyIdentifierBytesEnd);
+
+		// Essentially we salt the key bytes in case the master password turns out to be invalid
+		// TODO: We can remove this if we clear the registry if the master password is invalid?
+		Utility::AppendToVector(keyIdentifierBytes, context.secrets.masterPassword);
+
+		if (!CSymmetricKeyRegistry::GetKey(keyIdentifierBytes, symmetricKey))
+		{
+			// Keys derived by a previous process are restored on unlock, wrapped by the local key
+			const std::string storedKeyIdentifier = GetDerivedKeyIdentifier(context, keyIdentifierBytes);
+			const auto& storedKeys = context.secrets.derivedKeys.keys;
+
+			if (const auto it = storedKeys.find(storedKeyIdentifier); it != storedKeys.end())
+			{
+				DASH_STAT_INCREMENT(context.pStats, KeyStoreHit);
+				symmetricKey = it->second;
+			}
+			else
+			{
+				DASH_STAT_INCREMENT(context.pStats, KeyCacheMiss);
+				DASH_STAT_TIMER(context.pStats, KeyDerivation);
+				DASH_TRACE_SPAN(context.pTrace, "KeyDerivation", "crypto");
+
+				if (!GetSymmetricKeyViaDerivate(encryptedData.GetKeyDerivation(), encryptedData.cipherData.salt, context.secrets.masterPassword, symmetricKey))
+				{
+					return EDashlaneError::InvalidMasterPassword;
+				}
+
+				StoreDerivedKey(context, storedKeyIdentifier, symmetricKey);
+			}
+
+			CSymmetricKeyRegistry::AddKey(keyIdentifierBytes, symmetricKey);
+		}
+		else
+		{
+			DASH_STAT_INCREMENT(context.pStats, KeyCacheHit);
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+	bool CEncryption::GetSymmetricKeyViaDerivate(
+		const IDerivationConfig& config, 
+		std::span<const uint8_t> salt,
+		std::string_view masterPassword,
+		Utility::SecureBuffer& symmetricKey
+	) const
+	{
+		symmetricKey.resize(32);
+
+		switch (config.GetDerivation())
+		{
+		case EDerivationAlgorithm::Argon2D:
+		{
+			const auto& argon2 = static_cast<const SDerivationConfigArgon2&>(config);
+			return ARGON2_OK == argon2d_hash_raw(
+				argon2.tCost,
+				argon2.mCost,
+				argon2.parallelism,
+				masterPassword.data(),
+				masterPassword.size(),
+				salt.data(),
+				argon2.saltLength,
+				symmetricKey.data(), 32);
+
+		} break;
+
+		case EDerivationAlgorithm::PBKDF2:
+		{
+			const auto& pbkdf2 = static_cast<const SDerivationConfigPbkdf2&>(config);
+			return Utility::OPENSSL_RC_SUCCESS == PKCS5_PBKDF2_HMAC(
+				masterPassword.data(),
+				masterPassword.size(),
+				salt.data(),
+				pbkdf2.saltLength,
+				pbkdf2.iterations,
+				EVP_sha512(),
+				32, symmetricKey.data());
+
+		} break;
+		}
+
+		return true;
+	}
+
+	bool CEncryption::SetContextFromEncryptedData(std::span<const uint8_t> symmetricKey, std::span<const uint8_t> input, SEncryptedData& data)
+	{
+		if (symmetricKey.size() == 0)
+		{
+			return false;
+		}
+
+		if (input.size() == 0)
+		{
+			return false;
+		}
+
+		SplitSymmetricKey(symmetricKey);
+
+		// Update context, buffers are moved when the envelope was decoded in the same arena
+		m_context.symmetricKey.assign(symmetricKey.begin(), symmetricKey.end());
+		m_context.cipherMode = data.cipherConfig.cipherMode;
+		m_context.keyDerivation = std::move(data.keyDerivation);
+		m_context.salt = std::move(data.cipherData.salt);
+		m_context.iv = std::move(data.cipherData.iv);
+		m_context.hash = std::move(data.cipherData.hash);
+		m_context.input = std::move(data.cipherData.encryptedPayload);
+
+		return true;
+	}
+
+	bool CEncryption::GenerateRandomIV()
+	{
+		bool success = true;
+
+		m_context.iv.resize(16);
+		if (Utility::OPENSSL_RC_SUCCESS != RAND_bytes(m_context.iv.data(), m_context.iv.size()))
+		{
+			m_context.iv.resize(0);
+			success = false;
+		}
+
+		return success;
+	}
+
+	bool CEncryption::VerifySignatureHash(std::span<const uint8_t> iv, std::span<const uint8_t> payload, std::span<const uint8_t> expectedHash) const
+	{
+		if (expectedHash.size() != Utility::SHA256_DIGEST_SIZE)
+		{
+			return false;
+		}
+
+		uint8_t hash[Utility::SHA256_DIGEST_SIZE];
+		if (!Utility::HmacSHA256(m_context.hmacKey, { iv, payload }, hash))
+		{
+			return false;
+		}
+
+		return CRYPTO_memcmp(hash, expectedHash.data(), sizeof(hash)) == 0;
+	}
+
+	std::pmr::vector<uint8_t> CEncryption::CreateSignatureHash() const
+	{
+		std::pmr::vector<uint8_t> data(m_pResource);
+		data.reserve(m_context.iv.size() + m_context.input.size());
+		Utility::AppendToVector(data, m_context.iv, m_context.input);
+
+		std::pmr::vector<uint8_t> hash(Utility::SHA256_DIGEST_SIZE, m_pResource);
+		HMAC(EVP_sha256(), m_context.hmacKey.data(), m_context.hmacKey.size(), data.data(), data.size(), hash.data(), nullptr);
+
+		return hash;
+	}
+
+	void CEncryption::SplitSymmetricKey(std::span<const uint8_t> symmetricKey)
+	{
+		uint8_t combinedKey[Utility::SHA512_DIGEST_SIZE];
+		EVP_Digest(symmetricKey.data(), symmetricKey.size(), combinedKey, nullptr, EVP_sha512(), nullptr);
+
+		m_context.cipherKey.assign(combinedKey, combinedKey + 32);
+		m_context.hmacKey.assign(combinedKey + 32, combinedKey + Utility::SHA512_DIGEST_SIZE);
+
+		OPENSSL_cleanse(combinedKey, sizeof(combinedKey));
+	}
+
+	size_t CBatchDecryption::Add(std::span<const uint8_t> symmetricKey, const SEncryptedDataView& data, std::pmr::vector<uint8_t>& output)
+	{
+		SDecryptJob& job = m_jobs.emplace_back();
+		job.iv = data.cipherData.iv;
+		job.payload = data.cipherData.encryptedPayload;
+		job.hash = data.cipherData.hash;
+		job.pOutput = &output;
+
+		// An empty key leaves the job invalid, it fails like CEncryption::DecryptFromView
+		if (!symmetricKey.empty())
+		{
+			const SSplitKey& key = GetSplitKey(symmetricKey);
+			job.cipherKey = key.cipherKey;
+			job.hmacKey = key.hmacKey;
+		}
+
+		return m_jobs.size() - 1;
+	}
+
+	void CBatchDecryption::Run()
+	{
+		m_pBackend->DecryptBatch(m_jobs);
+	}
+
+	const CBatchDecryption::SSplitKey& CBatchDecryption::GetSplitKey(std::span<const uint8_t> symmetricKey)
+	{
+		// A vault has a handful of keys, most batches use a single one
+		for (const SSplitKey& key : m_keys)
+		{
+			if (std::ranges::equal(key.symmetricKey, symmetricKey))
+				return key;
+		}
+
+		SSplitKey& key = m_keys.emplace_back();
+		key.symmetricKey.assign(symmetricKey.begin(), symmetricKey.end());
+
+		uint8_t combinedKey[Utility::SHA512_DIGEST_SIZE];
+		EVP_Digest(symmetricKey.data(), symmetricKey.size(), combinedKey, nullptr, EVP_sha512(), nullptr);
+
+		std::copy_n(combinedKey, key.cipherKey.size(), key.cipherKey.begin());
+		std::copy_n(combinedKey + key.cipherKey.size(), key.hmacKey.size(), key.hmacKey.begin());
+
+		OPENSSL_cleanse(combinedKey, sizeof(combinedKey));
+
+		return key;
+	}
+
+	bool CEncryption::EncryptWithAES256()
+	{
+		bool success = false;
+
+		if (m_context.input.size() > 0)
+		{
+			if (EVP_CIPHER_CTX* pCtx = EVP_CIPHER_CTX_new())
+			{
+				const EVP_CIPHER* pCipher = EVP_aes_256_cbc();
+				const size_t blockSize = EVP_CIPHER_block_size(pCipher);
+
+				if (Utility::OPENSSL_RC_SUCCESS == EVP_EncryptInit_ex(pCtx, pCipher, NULL, m_context.cipherKey.data(), m_context.iv.data()))
+				{
+					m_context.output.resize(m_context.input.size() + blockSize - ((m_context.input.size() + blockSize) % blockSize));
+
+					int written = 0;
+					auto pInputData = reinterpret_cast<const unsigned char*>(m_context.input.data());
+					auto pOutputData = reinterpret_cast<unsigned char*>(m_context.output.data());
+					const auto inputSize = m_context.input.size();
+					if (Utility::OPENSSL_RC_SUCCESS == EVP_EncryptUpdate(pCtx, pOutputData, &written, pInputData, inputSize))
+					{
+						if (Utility::OPENSSL_RC_SUCCESS == EVP_EncryptFinal_ex(pCtx, pOutputData + written, &written))
+						{
+							success = true;
+						}
+					}
+				}
+
+				EVP_CIPHER_CTX_free(pCtx);
+			}
+		}
+
+		if (!success)
+		{
+			m_context.output.resize(0);
+		}
+
+		return success;
+	}
+
+	bool CEncryption::DecryptWithAES256()
+	{
+		return DecryptWithAES256(m_context.iv, m_context.input);
+	}
+
+	bool CEncryption::DecryptWithAES256(std::span<const uint8_t> iv, std::span<const uint8_t> payload)
+	{
+		bool success = false;
+
+		if (EVP_CIPHER_CTX* pCtx = EVP_CIPHER_CTX_new())
+		{
+			int written = 0;
+			int written_final = 0;
+
+			if (Utility::OPENSSL_RC_SUCCESS == EVP_DecryptInit_ex(pCtx, EVP_aes_256_cbc(), NULL, m_context.cipherKey.data(), iv.data()))
+			{
+				m_context.output.resize(payload.size());
+				if (Utility::OPENSSL_RC_SUCCESS == EVP_DecryptUpdate(pCtx, m_context.output.data(), &written, payload.data(), payload.size()))
+				{
+					EVP_DecryptFinal_ex(pCtx, m_context.output.data() + written, &written_final);
+					m_context.output.resize(written + written_final); // Shrink to fit
+					success = true;
+				}
+			}
+
+			EVP_CIPHER_CTX_free(pCtx);
+		}
+
+		if (!success)
+		{
+			m_context.output.resize(0);
+		}
+
+		return success;
+	}
+
 }
\ No newline at end of file
@@ -1,77 +1,151 @@
-#pragma once
-
-#include "Dashlane.h"
-#include "Types/Crypto.h"
-
-namespace Dashlane
-{
-
-	struct SEncryptionContext
-	{
-		bool useKeyRegistry{ false };
-
-		std::vector<uint8_t> symmetricKey{};
-		std::vector<uint8_t> cipherKey{};
-		std::vector<uint8_t> hmacKey{};
-
-		ECipherMode cipherMode{ ECipherMode::CBCHMAC };
-		std::unique_ptr<IDerivationConfig> pKeyDerivationConfig{};
-		std::vector<uint8_t> salt{};
-		std::vector<uint8_t> iv{};
-		std::vector<uint8_t> hash{};
-
-		std::vector<uint8_t> input{};
-		std::vector<uint8_t> output{};
-	};
-
-	class CEncryption
-	{
-
-	public:
-
-		const std::vector<uint8_t>& GetOutput() const { return m_context.output; }
-
-		bool EncryptData(
-			const std::vector<uint8_t>& symmetricKey, 
-			const std::vector<uint8_t>& input, 
-			SEncryptedData& encryptedDataOut);
-
-		bool DecryptFromContext();
-
-		bool SetContextFromEncryptedData(
-			const std::vector<uint8_t>& symmetricKey, 
-			const std::vector<uint8_t>& input, 
-			SEncryptedData& data);
-
-		void ResetContext();
-
-		EDashlaneError GetSymmetricKeyFromData(
-			const DashlaneContextInternal& context, 
-			const std::vector<uint8_t>& rawPayload, 
-			const SEncryptedData& encryptedData, 
-			std::vector<uint8_t>& symmetricKey) const;
-
-		bool GetSymmetricKeyViaDerivate(
-			const IDerivationConfig& config, 
-			const std::vector<uint8_t>& salt, 
-			const std::string masterPassword, 
-			std::vector<uint8_t>& symmetricKey) const;
-
-	protected:
-
-		bool GenerateRandomIV();
-		std::vector<uint8_t> CreateSignatureHash() const;
-
-		// Use output parameters instead of return tuple
-		std::tuple<std::vector<uint8_t>, std::vector<uint8_t>> SplitSymmetricKey(const std::vector<uint8_t>& symmetricKey) const;
-
-		bool EncryptWithAES256();
-		bool DecryptWithAES256();
-
-	private:
-
-		SEncryptionContext m_context;
-
-	};
-
+#pragma once
+
+#include "CryptoBackend.h"
+#include "Dashlane.h"
+#include "Types/Crypto.h"
+
+#include <deque>
+
+namespace Dashlane
+{
+
+	struct SEncryptionContext
+	{
+		explicit SEncryptionContext(std::pmr::memory_resource* pResource)
+			: symmetricKey(pResource)
+			, cipherKey(pResource)
+			, hmacKey(pResource)
+			, salt(pResource)
+			, iv(pResource)
+			, hash(pResource)
+			, input(pResource)
+			, output(pResource)
+		{}
+
+		bool useKeyRegistry{ false };
+
+		std::pmr::vector<uint8_t> symmetricKey;
+		std::pmr::vector<uint8_t> cipherKey;
+		std::pmr::vector<uint8_t> hmacKey;
+
+		ECipherMode cipherMode{ ECipherMode::CBCHMAC };
+		DerivationConfig keyDerivation;
+		std::pmr::vector<uint8_t> salt;
+		std::pmr::vector<uint8_t> iv;
+		std::pmr::vector<uint8_t> hash;
+
+		std::pmr::vector<uint8_t> input;
+		std::pmr::vector<uint8_t> output;
+	};
+
+	class CEncryption
+	{
+
+	public:
+
+		// Keys and intermediate buffers are allocated from pResource, a query passes its transient arena
+		explicit CEncryption(std::pmr::memory_resource* pResource = Utility::GetSecureMemoryResource())
+			: m_pResource(pResource)
+			, m_context(pResource)
+		{}
+
+		const std::pmr::vector<uint8_t>& GetOutput() const { return m_context.output; }
+		std::pmr::vector<uint8_t> TakeOutput() { return std::move(m_context.output); }
+
+		bool EncryptData(
+			std::span<const uint8_t> symmetricKey, 
+			std::span<const uint8_t> input, 
+			SEncryptedData& encryptedDataOut);
+
+		bool DecryptFromContext();
+
+		// Verifies and decrypts the fields viewed in the source envelope, only the plaintext output is allocated
+		bool DecryptFromView(std::span<const uint8_t> symmetricKey, const SEncryptedDataView& data);
+
+		bool SetContextFromEncryptedData(
+			std::span<const uint8_t> symmetricKey, 
+			std::span<const uint8_t> input, 
+			SEncryptedData& data);
+
+		void ResetContext();
+
+		// Drops the keys shared by the contexts of the process, the next envelopes get theirs from the stored derived
+		// keys or a derivation, as in a new process
+		static void ClearKeyRegistry();
+
+		EDashlaneError GetSymmetricKeyFromData(
+			const DashlaneContextInternal& context, 
+			std::span<const uint8_t> rawPayload, 
+			const SEncryptedDataView& encryptedData, 
+			Utility::SecureBuffer& symmetricKey) const;
+
+		bool GetSymmetricKeyViaDerivate(
+			const IDerivationConfig& config, 
+			std::span<const uint8_t> salt, 
+			std::string_view masterPassword, 
+			Utility::SecureBuffer& symmetricKey) const;
+
+	protected:
+
+		bool GenerateRandomIV();
+		std::pmr::vector<uint8_t> CreateSignatureHash() const;
+
+		// Constant time comparison of the HMAC of iv || payload against the expected hash
+		bool VerifySignatureHash(std::span<const uint8_t> iv, std::span<const uint8_t> payload, std::span<const uint8_t> expectedHash) const;
+
+		// Fills the cipher and HMAC keys of the context
+		void SplitSymmetricKey(std::span<const uint8_t> symmetricKey);
+
+		bool EncryptWithAES256();
+		bool DecryptWithAES256();
+		bool DecryptWithAES256(std::span<const uint8_t> iv, std::span<const uint8_t> payload);
+
+	private:
+
+		std::pmr::memory_resource* m_pResource;
+		SEncryptionContext m_context;
+
+	};
+
+	// Queues envelopes and verifies and decrypts them together through the crypto backend.
+	// Keys are split once per distinct symmetric key, the envelope views and outputs must outlive Run.
+	class CBatchDecryption
+	{
+
+	public:
+
+		explicit CBatchDecryption(ECryptoBackend backendType = ECryptoBackend::Auto)
+			: m_pBackend(CreateCryptoBackend(backendType))
+		{}
+
+		ECryptoBackend GetBackendType() const { return m_pBackend->GetType(); }
+		size_t GetSize() const { return m_jobs.size(); }
+
+		// Returns the index of the queued job
+		size_t Add(std::span<const uint8_t> symmetricKey, const SEncryptedDataView& data, std::pmr::vector<uint8_t>& output);
+
+		void Run();
+
+		bool Succeeded(size_t index) const { return m_jobs[index].success; }
+
+		// Drops the queued jobs, split keys are kept for the next batch
+		void Clear() { m_jobs.clear(); }
+
+	private:
+
+		struct SSplitKey
+		{
+			Utility::SecureBuffer symmetricKey;
+			std::array<uint8_t, 32> cipherKey{};
+			std::array<uint8_t, 32> hmacKey{};
+		};
+
+		const SSplitKey& GetSplitKey(std::span<const uint8_t> symmetricKey);
+
+		std::unique_ptr<ICryptoBackend> m_pBackend;
+		std::deque<SSplitKey, Utility::CSecureAllocator<SSplitKey>> m_keys;
+		std::vector<SDecryptJob> m_jobs;
+
+	};
+
 }
\ No newline at end of file
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "Types/Crypto.h"
+
+#include <algorithm>
+#include <charconv>
+#include <tuple>
+
+// Envelope Codec
+//
+// Reader and writer of the encrypted envelope format, generated at compile time from the field lists below instead of
+// walking the objects through CSerializer. The output is byte for byte the one of CSerializer:
+//
+//		$<version>$<algorithm>$<derivation fields...>$<encryption>$<cipher mode>$<iv length>$<salt><iv><hash><payload>
+//
+// Tokens are read in place (numbers are parsed straight from the input), there is no context stack and no virtual
+// call: the derivation is held by value and both directions dispatch once on its variant.
+
+namespace Dashlane
+{
+
+	// Delimited fields of each part of the envelope, in wire order
+	template<typename T>
+	struct SEnvelopeFields;
+
+	template<>
+	struct SEnvelopeFields<SDerivationConfigNone>
+	{
+		static constexpr auto fields = std::make_tuple();
+	};
+
+	template<>
+	struct SEnvelopeFields<SDerivationConfigArgon2>
+	{
+		static constexpr auto fields = std::make_tuple(
+			&SDerivationConfigArgon2::saltLength,
+			&SDerivationConfigArgon2::tCost,
+			&SDerivationConfigArgon2::mCost,
+			&SDerivationConfigArgon2::parallelism);
+	};
+
+	template<>
+	struct SEnvelopeFields<SDerivationConfigPbkdf2>
+	{
+		static constexpr auto fields = std::make_tuple(
+			&SDerivationConfigPbkdf2::saltLength,
+			&SDerivationConfigPbkdf2::iterations,
+			&SDerivationConfigPbkdf2::hashMethod);
+	};
+
+	template<>
+	struct SEnvelopeFields<SSymmetricCipherConfig>
+	{
+		static constexpr auto fields = std::make_tuple(
+			&SSymmetricCipherConfig::encryption,
+			&SSymmetricCipherConfig::cipherMode,
+			&SSymmetricCipherConfig::ivLength);
+	};
+
+	static constexpr size_t ENVELOPE_HASH_SIZE = 32;
+	static constexpr uint8_t ENVELOPE_SEPARATOR = '$';
+
+	class CEnvelopeWriter
+	{
+
+	public:
+
+		explicit CEnvelopeWriter(std::vector<uint8_t>& output)
+			: m_output(output)
+		{}
+
+		void Write(std::string_view token)
+		{
+			m_output.insert(m_output.end(), token.begin(), token.end());
+			m_output.push_back(ENVELOPE_SEPARATOR);
+		}
+
+		void Write(uint32_t number)
+		{
+			char buffer[10];
+			const std::to_chars_result result = std::to_chars(std::begin(buffer), std::end(buffer), number);
+			Write(std::string_view(buffer, result.ptr));
+		}
+
+		void Write(ECipherMode cipherMode)
+		{
+			Write(GetEnumName(cipherMode));
+		}
+
+		// Packed without separator
+		void WriteRaw(std::span<const uint8_t> data)
+		{
+			m_output.insert(m_output.end(), data.begin(), data.end());
+		}
+
+		template<typename T>
+		void WriteFields(const T& obj)
+		{
+			std::apply([&](auto... members) { (Write(obj.*members), ...); }, SEnvelopeFields<T>::fields);
+		}
+
+		template<typename TConfig>
+		void WriteDerivation(const TConfig& config)
+		{
+			Write(GetEnumName(TConfig::algorithm));
+			WriteFields(config);
+		}
+
+	private:
+
+		std::vector<uint8_t>& m_output;
+
+	};
+
+	class CEnvelopeReader
+	{
+
+	public:
+
+		explicit CEnvelopeReader(std::span<const uint8_t> input)
+			: m_input(input)
+		{}
+
+		// Token up to the next separator, which is consumed
+		bool Read(std::span<const uint8_t>& token)
+		{
+			const auto separator = std::find(m_input.begin() + m_position, m_input.end(), ENVELOPE_SEPARATOR);
+			if (separator == m_input.end())
+				return false;
+
+			const size_t end = separator - m_input.begin();
+			token = m_input.subspan(m_position, end - m_position);
+			m_position = end + 1;
+
+			return true;
+		}
+
+		bool Read(std::string_view& token)
+		{
+			std::span<const uint8_t> bytes;
+			if (!Read(bytes))
+				return false;
+
+			token = std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+			return true;
+		}
+
+		bool Read(std::string& value)
+		{
+			std::string_view token;
+			if (!Read(token))
+				return false;
+
+			value.assign(token);
+			return true;
+		}
+
+		bool Read(uint32_t& number)
+		{
+			std::string_view token;
+			if (!Read(token))
+				return false;
+
+			const std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), number);
+			return result.ec == std::errc() && result.ptr == token.data() + token.size();
+		}
+
+		bool Read(ECipherMode& cipherMode)
+		{
+			std::string_view token;
+			if (!Read(token))
+				return false;
+
+			cipherMode = ParseEnumName<ECipherMode>(token);
+			return true;
+		}
+
+		// Exactly length bytes, packed without separator
+		bool ReadRaw(std::span<const uint8_t>& view, size_t length)
+		{
+			if (m_input.size() - m_position < length)
+				return false;
+
+			view = m_input.subspan(m_position, length);
+			m_position += length;
+
+			return true;
+		}
+
+		std::span<const uint8_t> ReadRemaining()
+		{
+			const std::span<const uint8_t> view = m_input.subspan(m_position);
+			m_position = m_input.size();
+
+			return view;
+		}
+
+		template<typename T>
+		bool ReadFields(T& obj)
+		{
+			return std::apply([&](auto... members) { return (Read(obj.*members) && ...); }, SEnvelopeFields<T>::fields);
+		}
+
+	private:
+
+		std::span<const uint8_t> m_input;
+		size_t m_position{ 0 };
+
+	};
+
+	// Parses the envelope into views over input, nothing is copied
+	inline bool ReadEnvelope(std::span<const uint8_t> input, SEncryptedDataView& envelope)
+	{
+		CEnvelopeReader reader(input);
+
+		std::span<const uint8_t> empty;
+		if (!reader.Read(empty) || !empty.empty() || !reader.Read(envelope.version))
+			return false;
+
+		std::string_view algorithm;
+		if (!reader.Read(algorithm))
+			return false;
+
+		EmplaceDerivationConfig(envelope.keyDerivation, ParseEnumName<EDerivationAlgorithm>(algorithm));
+
+		size_t saltLength = 0;
+		const bool success = std::visit([&](auto& config)
+		{
+			if (!reader.ReadFields(config))
+				return false;
+
+			if constexpr (requires { config.saltLength; })
+				saltLength = config.saltLength;
+
+			return true;
+		}, envelope.keyDerivation);
+
+		if (!success || !reader.ReadFields(envelope.cipherConfig))
+			return false;
+
+		SCipherDataView& cipherData = envelope.cipherData;
+		if (!reader.ReadRaw(cipherData.salt, saltLength)
+			|| !reader.ReadRaw(cipherData.iv, envelope.cipherConfig.ivLength)
+			|| !reader.ReadRaw(cipherData.hash, ENVELOPE_HASH_SIZE))
+		{
+			return false;
+		}
+
+		cipherData.encryptedPayload = reader.ReadRemaining();
+
+		return true;
+	}
+
+	inline bool ReadEnvelope(std::span<const uint8_t> input, SEncryptedData& envelope)
+	{
+		SEncryptedDataView view;
+		if (!ReadEnvelope(input, view))
+			return false;
+
+		envelope.version = view.version;
+		envelope.keyDerivation = view.keyDerivation;
+		envelope.cipherConfig = view.cipherConfig;
+		envelope.cipherData.salt.assign(view.cipherData.salt.begin(), view.cipherData.salt.end());
+		envelope.cipherData.iv.assign(view.cipherData.iv.begin(), view.cipherData.iv.end());
+		envelope.cipherData.hash.assign(view.cipherData.hash.begin(), view.cipherData.hash.end());
+		envelope.cipherData.encryptedPayload.assign(view.cipherData.encryptedPayload.begin(), view.cipherData.encryptedPayload.end());
+
+		return true;
+	}
+
+	inline bool WriteEnvelope(const SEncryptedData& envelope, std::vector<uint8_t>& output)
+	{
+		const SCipherData& cipherData = envelope.cipherData;
+		output.reserve(output.size() + 64 + cipherData.salt.size() + cipherData.iv.size() + cipherData.hash.size() + cipherData.encryptedPayload.size());
+
+		CEnvelopeWriter writer(output);
+		writer.Write(std::string_view());
+		writer.Write(envelope.version);
+
+		std::visit([&](const auto& config) { writer.WriteDerivation(config); }, envelope.keyDerivation);
+
+		writer.WriteFields(envelope.cipherConfig);
+
+		writer.WriteRaw(cipherData.salt);
+		writer.WriteRaw(cipherData.iv);
+		writer.WriteRaw(cipherData.hash);
+		writer.WriteRaw(cipherData.encryptedPayload);
+
+		return true;
+	}
+
+}
\ No newline at end of file
@@ -1,14 +1,22 @@
-#pragma once
-
-namespace Dashlane
-{
-
-	struct DashlaneContextInternal;
-
-	bool SetLocalKey(DashlaneContextInternal& context);
-	bool GetLocalKey(DashlaneContextInternal& context);
-	bool DeleteLocalKey(DashlaneContextInternal& context);
-	EDashlaneError GetOrUpdateSecrets(DashlaneContextInternal& context);
-	EDashlaneError UpdateDeviceConfiguration(DashlaneContextInternal& context);
-
+#pragma once
+
+#include "Utility/SecureMemory.h"
+
+namespace Dashlane
+{
+
+	struct DashlaneContextInternal;
+
+	bool SetLocalKey(DashlaneContextInternal& context);
+	bool GetLocalKey(DashlaneContextInternal& context);
+	bool DeleteLocalKey(DashlaneContextInternal& context);
+	EDashlaneError GetOrUpdateSecrets(DashlaneContextInternal& context);
+	EDashlaneError UpdateDeviceConfiguration(DashlaneContextInternal& context);
+
+	// Stored identifier of a derived key, empty when the local key is not available yet
+	std::string GetDerivedKeyIdentifier(const DashlaneContextInternal& context, std::span<const uint8_t> keyIdentifierBytes);
+	void StoreDerivedKey(const DashlaneContextInternal& context, const std::string& keyIdentifier, const Utility::SecureBuffer& key);
+	// Called once an envelope derived from the master password decrypted, a mistyped password never removes stored keys
+	void RemoveStaleDerivedKeys(DashlaneContextInternal& context);
+
 }
\ No newline at end of file
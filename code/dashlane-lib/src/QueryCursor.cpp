@@ -0,0 +1,244 @@
+#include "StdAfx.h"
+#include "QueryCursor.h"
+#include "Keychain.h"
+
+namespace Dashlane
+{
+
+	CQueryCursor::CQueryCursor(DashlaneContextInternal& context, std::span<DashlaneQueryContextInternal* const> queries)
+		: m_context(context)
+		, m_queries(queries.begin(), queries.end())
+		, m_queryTypes(queries.size())
+	{
+		// Reserved up front, the batch keeps pointers to the outputs of the items
+		m_items.reserve(QUERY_BATCH_SIZE);
+	}
+
+	EDashlaneError CQueryCursor::Open()
+	{
+		bool anyType = false;
+		for (size_t i = 0; i < m_queries.size(); ++i)
+		{
+			for (const auto& type : m_queries[i]->typeMask)
+				m_queryTypes[i].emplace(nlohmann::ordered_json(type.value));
+
+			anyType |= m_queryTypes[i].empty();
+			m_typeMask.value |= m_queries[i]->typeMask.value;
+		}
+
+		if (anyType)
+			m_typeMask = bitmask<ERawTransactionType>::none();
+
+		return PrepareVaultRead(m_context);
+	}
+
+	EDashlaneError CQueryCursor::Next(bool& hasResult)
+	{
+		hasResult = false;
+
+		std::shared_lock lock(m_context.stateMutex);
+		while (m_rc == EDashlaneError::NoError)
+		{
+			if (m_itemPosition == m_items.size())
+			{
+				m_rc = DecryptWindow();
+				if (m_rc != EDashlaneError::NoError || m_items.empty())
+					break;
+			}
+
+			bool matched = false;
+			m_rc = WriteItem(m_items[m_itemPosition++], matched, lock);
+			if (m_rc == EDashlaneError::NoError && matched)
+			{
+				hasResult = true;
+				break;
+			}
+		}
+
+		lock.unlock();
+
+		if (m_rc == EDashlaneError::InvalidMasterPassword)
+		{
+			std::unique_lock exclusiveLock(m_context.stateMutex);
+			Utility::SecureClear(m_context.secrets.masterPassword);
+		}
+
+		return m_rc;
+	}
+
+	EDashlaneError CQueryCursor::Close()
+	{
+		// Best effort, items that could not be updated (or while a synchronization is writing) are recrypted again by the next query
+		if (!m_recryptedRows.empty())
+		{
+			DASH_STAT_TIMER(m_context.pStats, SqliteWrite);
+			m_context.pDatabase->UpdateRecryptedTransactions(m_context, m_recryptedRows, false);
+			m_recryptedRows.clear();
+		}
+
+		std::unique_lock lock(m_context.stateMutex);
+		if (m_passwordVerified)
+			RemoveStaleDerivedKeys(m_context);
+
+		if (m_rc == EDashlaneError::NoError && m_decryptedAny && m_context.applicationData.shouldUpdateDeviceConfiguration)
+			return UpdateDeviceConfiguration(m_context);
+
+		return m_rc;
+	}
+
+	bool CQueryCursor::AcceptsType(size_t query, const std::string& type) const
+	{
+		return m_queryTypes[query].empty() || m_queryTypes[query].contains(type);
+	}
+
+	EDashlaneError CQueryCursor::FetchPage()
+	{
+		m_page.clear();
+		m_pagePosition = 0;
+
+		DASH_STAT_TIMER(m_context.pStats, SqliteFetch);
+		const EDashlaneError rc = m_context.pDatabase->GetTransactionsPage(m_context, m_typeMask, m_lastIdentifier, QUERY_BATCH_SIZE, m_page);
+		if (rc != EDashlaneError::NoError)
+			return rc;
+
+		m_lastPage = m_page.size() < QUERY_BATCH_SIZE;
+		if (!m_page.empty())
+			m_lastIdentifier = m_page.back().identifier;
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError CQueryCursor::DecryptWindow()
+	{
+		m_items.clear();
+		m_itemPosition = 0;
+		m_batch.Clear();
+		m_arena.Rewind();
+
+		while (m_items.size() < m_windowSize)
+		{
+			if (m_pagePosition == m_page.size())
+			{
+				if (m_lastPage)
+					break;
+
+				if (EDashlaneError rc = FetchPage(); rc != EDashlaneError::NoError)
+					return rc;
+
+				continue;
+			}
+
+			SRawTransactionBackupEdit& transaction = m_page[m_pagePosition++];
+
+			// Decrypt each item once, only when a query accepts its type
+			bool accepted = false;
+			for (size_t i = 0; i < m_queries.size() && !accepted; ++i)
+				accepted = AcceptsType(i, transaction.type);
+
+			if (!accepted)
+				continue;
+
+			SQueryItem& item = m_items.emplace_back(std::move(transaction), &m_arena);
+
+			std::span<const uint8_t> symmetricKey;
+			item.rc = DecodeEnvelope(m_context, item.transaction.content, item.decoded, item.envelope, item.derivedKey, symmetricKey);
+			if (item.rc == EDashlaneError::NoError)
+				item.job = m_batch.Add(symmetricKey, item.envelope, item.decrypted);
+		}
+
+		m_windowSize = std::min(m_windowSize * 2, QUERY_BATCH_SIZE);
+
+		if (m_batch.GetSize() > 0)
+		{
+			DASH_STAT_TIMER(m_context.pStats, Decrypt);
+			DASH_TRACE_SPAN(m_context.pTrace, "DecryptBatch", "crypto");
+			m_batch.Run();
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+	EDashlaneError CQueryCursor::WriteItem(SQueryItem& item, bool& matched, std::shared_lock<std::shared_mutex>& lock)
+	{
+		Utility::CScopedTraceSpan span(m_context.pTrace.get(), "ProcessTransaction", "item");
+		span.AddArg("type", item.transaction.type);
+
+		// A server envelope that does not decrypt means the master password is incorrect, as during a synchronization
+		std::pmr::vector<uint8_t> decompressed(&m_arena);
+		Utility::TransactionFields fields(&m_arena);
+		ETransactionType type = ETransactionType::Unknown;
+		if (item.rc == EDashlaneError::NoError && !m_batch.Succeeded(item.job))
+			item.rc = item.transaction.recrypted ? EDashlaneError::InternalDecryptFailure : EDashlaneError::InvalidMasterPassword;
+
+		if (item.rc == EDashlaneError::NoError)
+			item.rc = DecodeTransactionFields(m_context, item.decrypted, decompressed, fields, type);
+
+		if (item.rc == EDashlaneError::NoError && !item.transaction.recrypted)
+		{
+			std::string recryptedContent;
+			item.rc = EncryptAndSerialize(m_context, item.decrypted, recryptedContent);
+
+			if (item.rc == EDashlaneError::NoError)
+			{
+				const SRawTransactionBackupEdit& transaction = item.transaction;
+				m_recryptedRows.emplace_back(m_context.login, transaction.identifier, transaction.type, transaction.GetActionName(),
+					recryptedContent, transaction.backupDate);
+			}
+		}
+
+		if (item.rc != EDashlaneError::NoError)
+			return item.rc;
+
+		m_decryptedAny = true;
+		m_passwordVerified |= !item.derivedKey.empty();
+
+		// Evaluate every query accepting the type of the item, the JSON and the typed view are only built for a match
+		std::optional<nlohmann::ordered_json> json;
+		std::pmr::string dump(&m_arena);
+		std::optional<DashlaneTransactionView> view;
+		DashlaneAuthentifiantView authentifiantView;
+		DashlaneSecureNoteView secureNoteView;
+		for (size_t i = 0; i < m_queries.size(); ++i)
+		{
+			if (!AcceptsType(i, item.transaction.type))
+				continue;
+
+			const DashlaneQueryContextInternal& query = *m_queries[i];
+			{
+				DASH_STAT_TIMER(m_context.pStats, Filter);
+				if (!MatchesQueryFilters(query, fields))
+					continue;
+			}
+
+			matched = true;
+
+			if (query.typedWriterFunc != nullptr)
+			{
+				if (!view)
+					FillTransactionView(type, fields, authentifiantView, secureNoteView, view.emplace());
+
+				// The item only refers to the cursor buffers, writers run with the context unlocked and may call the API
+				DASH_STAT_TIMER(m_context.pStats, WriterCallback);
+				lock.unlock();
+				query.typedWriterFunc(query.pUserPointer, &*view);
+				lock.lock();
+				continue;
+			}
+
+			if (!json)
+			{
+				DASH_STAT_TIMER(m_context.pStats, JsonBuild);
+				json = Utility::TransactionFieldsToJson(type, fields, &m_arena);
+				Utility::DumpJsonTransaction(*json, dump);
+			}
+
+			DASH_STAT_TIMER(m_context.pStats, WriterCallback);
+			lock.unlock();
+			query.writerFunc(query.pUserPointer, dump.c_str(), static_cast<uint32_t>(dump.size()));
+			lock.lock();
+		}
+
+		return EDashlaneError::NoError;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Dashlane.h"
+#include "Encryption.h"
+#include "Types/Crypto.h"
+#include "Utility/Arena.h"
+
+#include <set>
+
+namespace Dashlane
+{
+
+	// Pull side of the query pipeline. Rows are read from the vault a page at a time, and items are decrypted in
+	// windows that start with a single item and double up to QUERY_BATCH_SIZE, so a consumer stopping after the first
+	// results only pays for the items it pulled while a full scan still goes through the batched crypto backend.
+	// Each match is written to the writer (JSON or typed) of every query it matches.
+	class CQueryCursor : public DashlaneQueryCursor
+	{
+
+	public:
+
+		// The context and the query contexts must outlive the cursor, the cursor API resolves their handles again on every call
+		CQueryCursor(DashlaneContextInternal& context, std::span<DashlaneQueryContextInternal* const> queries);
+		CQueryCursor(const CQueryCursor&) = delete;
+		CQueryCursor(CQueryCursor&&) = delete;
+
+		// Resolves the secrets and applies the sync policy
+		EDashlaneError Open();
+
+		// Writes the next item matching any query, hasResult is false once the vault is exhausted.
+		// The first failure is returned again by every following call
+		EDashlaneError Next(bool& hasResult);
+
+		// Writes back the items recrypted by the cursor and updates the device configuration if needed
+		EDashlaneError Close();
+
+		DashlaneContextInternal& GetContext() const { return m_context; }
+
+	private:
+
+		// Envelopes of a window are decoded first, then verified and decrypted together
+		struct SQueryItem
+		{
+			SQueryItem(SRawTransactionBackupEdit&& transaction, std::pmr::memory_resource* pResource)
+				: transaction(std::move(transaction))
+				, decoded(pResource)
+				, decrypted(pResource)
+			{}
+
+			SRawTransactionBackupEdit transaction;
+			std::pmr::vector<uint8_t> decoded;
+			std::pmr::vector<uint8_t> decrypted;
+			SEncryptedDataView envelope;
+			Utility::SecureBuffer derivedKey;
+			size_t job{ 0 };
+			EDashlaneError rc{ EDashlaneError::NoError };
+		};
+
+		bool AcceptsType(size_t query, const std::string& type) const;
+
+		EDashlaneError FetchPage();
+		EDashlaneError DecryptWindow();
+		// lock is released around the writer calls
+		EDashlaneError WriteItem(SQueryItem& item, bool& matched, std::shared_lock<std::shared_mutex>& lock);
+
+		DashlaneContextInternal& m_context;
+		std::vector<DashlaneQueryContextInternal*> m_queries;
+
+		// Transaction types accepted by each query, empty when the query accepts any type
+		std::vector<std::set<std::string>> m_queryTypes;
+		bitmask<ERawTransactionType> m_typeMask{ bitmask<ERawTransactionType>::none() };
+
+		std::vector<SRawTransactionBackupEdit> m_page;
+		size_t m_pagePosition{ 0 };
+		std::string m_lastIdentifier;
+		bool m_lastPage{ false };
+
+		// Transient buffers of the current window, wiped and reused by the next one
+		Utility::CTransientArena m_arena;
+		std::vector<SQueryItem> m_items;
+		size_t m_itemPosition{ 0 };
+		size_t m_windowSize{ 1 };
+		CBatchDecryption m_batch;
+
+		// Server envelopes stored by a lazy synchronization, recrypted with the local key once decrypted
+		std::vector<STransactionRow> m_recryptedRows;
+
+		bool m_decryptedAny{ false };
+		bool m_passwordVerified{ false };	// An item derived from the master password decrypted
+		EDashlaneError m_rc{ EDashlaneError::NoError };
+
+	};
+
+}
\ No newline at end of file
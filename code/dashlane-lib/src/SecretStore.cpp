@@ -0,0 +1,392 @@
+#include "StdAfx.h"
+#include "SecretStore.h"
+#include "Utility/Cryptography.h"
+#include "Utility/Environment.h"
+#include "Utility/Strings.h"
+
+#include <keychain/keychain.h>
+#include <openssl/evp.h>
+
+#include <fstream>
+#include <mutex>
+
+#if defined(LINUX)
+#include <linux/keyctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace Dashlane
+{
+
+	namespace
+	{
+
+		// OS keychain through the keychain library (libsecret over D-Bus on Linux), secrets are stored base64 encoded
+		class CKeychainSecretStore : public ISecretStore
+		{
+
+		public:
+
+			ESecretStore GetType() const override { return ESecretStore::OSKeychain; }
+
+			bool SetSecret(const std::string& service, const std::string& account, std::span<const uint8_t> secret) override
+			{
+				keychain::Error error;
+
+				std::string encodedSecret = base64pp::encode(secret);
+				keychain::setPassword(service, account, account, encodedSecret, error);
+				Utility::SecureClear(encodedSecret);
+
+				return error.type == keychain::ErrorType::NoError;
+			}
+
+			bool GetSecret(const std::string& service, const std::string& account, Utility::SecureBuffer& secret) override
+			{
+				keychain::Error error;
+
+				std::string encodedSecret = keychain::getPassword(service, account, account, error);
+				if (error.type != keychain::ErrorType::NoError)
+					return false;
+
+				std::optional<std::vector<uint8_t>> decoded = base64pp::decode(encodedSecret);
+				Utility::SecureClear(encodedSecret);
+				if (!decoded)
+					return false;
+
+				secret.assign(decoded->begin(), decoded->end());
+				Utility::SecureClear(*decoded);
+				return true;
+			}
+
+			bool DeleteSecret(const std::string& service, const std::string& account) override
+			{
+				keychain::Error error;
+				keychain::deletePassword(service, account, account, error);
+				return error.type == keychain::ErrorType::NoError;
+			}
+
+		};
+
+#if defined(LINUX)
+		// Linux user keyring, the secret stays in kernel memory until it expires or is deleted. A lookup is a search and a
+		// read system call, without any daemon round-trip, and works on headless systems
+		class CKernelKeyringSecretStore : public ISecretStore
+		{
+
+		public:
+
+			// Expiry of a stored secret, refreshed every time it is stored again
+			static constexpr uint32_t TIMEOUT_SECONDS = 8 * 3600;
+
+			ESecretStore GetType() const override { return ESecretStore::KernelKeyring; }
+
+			bool SetSecret(const std::string& service, const std::string& account, std::span<const uint8_t> secret) override
+			{
+				const std::string description = GetDescription(service, account);
+
+				// Replaces the payload of an existing key with the same description
+				const long serial = syscall(SYS_add_key, "user", description.c_str(), secret.data(), secret.size(), KEY_SPEC_USER_KEYRING);
+				if (serial < 0)
+					return false;
+
+				// Readable by the other processes of the user, not only by the processes possessing the keyring
+				syscall(SYS_keyctl, KEYCTL_SETPERM, serial, KEY_PERMISSIONS);
+				syscall(SYS_keyctl, KEYCTL_SET_TIMEOUT, serial, TIMEOUT_SECONDS);
+
+				return true;
+			}
+
+			bool GetSecret(const std::string& service, const std::string& account, Utility::SecureBuffer& secret) override
+			{
+				const long serial = FindKey(service, account);
+				if (serial < 0)
+					return false;
+
+				secret.resize(MAX_SECRET_SIZE);
+				const long size = syscall(SYS_keyctl, KEYCTL_READ, serial, secret.data(), secret.size());
+				if (size < 0 || static_cast<size_t>(size) > secret.size())
+				{
+					Utility::SecureClear(secret);
+					return false;
+				}
+
+				secret.resize(static_cast<size_t>(size));
+				return true;
+			}
+
+			bool DeleteSecret(const std::string& service, const std::string& account) override
+			{
+				const long serial = FindKey(service, account);
+				if (serial < 0)
+					return false;
+
+				return syscall(SYS_keyctl, KEYCTL_UNLINK, serial, KEY_SPEC_USER_KEYRING) == 0;
+			}
+
+		private:
+
+			// Possessor: all, user: view, read, write, search and link (KEY_POS_ALL | KEY_USR_ALL without setattr)
+			static constexpr uint32_t KEY_PERMISSIONS = 0x3f1f0000;
+			static constexpr size_t MAX_SECRET_SIZE = 1024;
+
+			static std::string GetDescription(const std::string& service, const std::string& account)
+			{
+				return std::format("dashlane:{}:{}", service, account);
+			}
+
+			static long FindKey(const std::string& service, const std::string& account)
+			{
+				const std::string description = GetDescription(service, account);
+				return syscall(SYS_keyctl, KEYCTL_SEARCH, KEY_SPEC_USER_KEYRING, "user", description.c_str(), 0);
+			}
+
+		};
+#endif
+
+		// Secrets kept in the memory of the process, shared by every context using this store. Meant for tests
+		class CMemorySecretStore : public ISecretStore
+		{
+
+		public:
+
+			ESecretStore GetType() const override { return ESecretStore::Memory; }
+
+			bool SetSecret(const std::string& service, const std::string& account, std::span<const uint8_t> secret) override
+			{
+				const std::lock_guard<std::mutex> lock(m_mutex);
+				m_secrets[{ service, account }].assign(secret.begin(), secret.end());
+				return true;
+			}
+
+			bool GetSecret(const std::string& service, const std::string& account, Utility::SecureBuffer& secret) override
+			{
+				const std::lock_guard<std::mutex> lock(m_mutex);
+
+				const auto it = m_secrets.find({ service, account });
+				if (it == m_secrets.end())
+					return false;
+
+				secret = it->second;
+				return true;
+			}
+
+			bool DeleteSecret(const std::string& service, const std::string& account) override
+			{
+				const std::lock_guard<std::mutex> lock(m_mutex);
+				return m_secrets.erase({ service, account }) > 0;
+			}
+
+		private:
+
+			std::mutex m_mutex;
+			std::map<std::pair<std::string, std::string>, Utility::SecureBuffer> m_secrets;
+
+		};
+
+		// One file per secret in the data folder, encrypted with AES-256-GCM under the SHA-256 of DASHLANE_SECRET_STORE_KEY.
+		// For systems without a keychain, the variable is expected to hold a high-entropy key provided by the environment
+		// (e.g. a secret manager). Without it, or with fewer than MIN_KEY_LENGTH characters, the store is unavailable and the
+		// local key is derived from the master password
+		class CEncryptedFileSecretStore : public ISecretStore
+		{
+
+		public:
+
+			explicit CEncryptedFileSecretStore(const std::filesystem::path& dataFolder)
+				: m_folder(dataFolder / "secrets")
+			{}
+
+			ESecretStore GetType() const override { return ESecretStore::EncryptedFile; }
+
+			bool SetSecret(const std::string& service, const std::string& account, std::span<const uint8_t> secret) override
+			{
+				Utility::SecureBuffer fileKey;
+				if (!GetFileKey(fileKey))
+					return false;
+
+				std::vector<uint8_t> content(IV_SIZE + TAG_SIZE + secret.size());
+				if (Utility::OPENSSL_RC_SUCCESS != RAND_bytes(content.data(), IV_SIZE))
+					return false;
+
+				if (!Encrypt(fileKey, GetAssociatedData(service, account), secret, content))
+					return false;
+
+				const std::lock_guard<std::mutex> lock(m_mutex);
+
+				std::error_code error;
+				std::filesystem::create_directories(m_folder, error);
+
+				// Written next to the secret then renamed, a reader never sees a partial file
+				const std::filesystem::path path = GetSecretPath(service, account);
+				std::filesystem::path temporaryPath = path;
+				temporaryPath += ".tmp";
+				{
+					std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+					if (!file.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size())))
+						return false;
+				}
+
+				std::filesystem::permissions(temporaryPath, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+					std::filesystem::perm_options::replace, error);
+				std::filesystem::rename(temporaryPath, path, error);
+
+				return !error;
+			}
+
+			bool GetSecret(const std::string& service, const std::string& account, Utility::SecureBuffer& secret) override
+			{
+				Utility::SecureBuffer fileKey;
+				if (!GetFileKey(fileKey))
+					return false;
+
+				std::vector<uint8_t> content;
+				{
+					const std::lock_guard<std::mutex> lock(m_mutex);
+
+					std::ifstream file(GetSecretPath(service, account), std::ios::binary);
+					if (!file)
+						return false;
+
+					content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+				}
+
+				if (content.size() < IV_SIZE + TAG_SIZE)
+					return false;
+
+				return Decrypt(fileKey, GetAssociatedData(service, account), content, secret);
+			}
+
+			bool DeleteSecret(const std::string& service, const std::string& account) override
+			{
+				const std::lock_guard<std::mutex> lock(m_mutex);
+
+				std::error_code error;
+				return std::filesystem::remove(GetSecretPath(service, account), error);
+			}
+
+		private:
+
+			static constexpr size_t KEY_SIZE = 32;
+			static constexpr size_t MIN_KEY_LENGTH = 32;
+			static constexpr size_t IV_SIZE = 12;
+			static constexpr size_t TAG_SIZE = 16;
+
+			static bool GetFileKey(Utility::SecureBuffer& key)
+			{
+				std::optional<std::string> value = Utility::ReadEnvironmentVariable("DASHLANE_SECRET_STORE_KEY");
+				if (!value)
+					return false;
+
+				// An empty or short value would make the secrets as easy to guess as the value itself
+				if (value->size() < MIN_KEY_LENGTH)
+				{
+					Utility::SecureClear(value.value());
+					return false;
+				}
+
+				std::vector<uint8_t> hash = Utility::SHA256(value.value());
+				Utility::SecureClear(value.value());
+
+				key.assign(hash.begin(), hash.end());
+				Utility::SecureClear(hash);
+
+				return key.size() == KEY_SIZE;
+			}
+
+			// Binds a file to its secret, a file copied over another one does not decrypt
+			static std::string GetAssociatedData(const std::string& service, const std::string& account)
+			{
+				return std::format("{}\n{}", service, account);
+			}
+
+			// Content layout: IV || tag || ciphertext, the IV is filled by the caller
+			static bool Encrypt(std::span<const uint8_t> key, const std::string& associatedData, std::span<const uint8_t> secret,
+				std::vector<uint8_t>& content)
+			{
+				bool success = false;
+
+				if (EVP_CIPHER_CTX* pCtx = EVP_CIPHER_CTX_new())
+				{
+					int written = 0;
+					success = Utility::OPENSSL_RC_SUCCESS == EVP_EncryptInit_ex(pCtx, EVP_aes_256_gcm(), nullptr, key.data(), content.data())
+						&& Utility::OPENSSL_RC_SUCCESS == EVP_EncryptUpdate(pCtx, nullptr, &written,
+							reinterpret_cast<const uint8_t*>(associatedData.data()), static_cast<int>(associatedData.size()))
+						&& Utility::OPENSSL_RC_SUCCESS == EVP_EncryptUpdate(pCtx, content.data() + IV_SIZE + TAG_SIZE, &written,
+							secret.data(), static_cast<int>(secret.size()))
+						&& Utility::OPENSSL_RC_SUCCESS == EVP_EncryptFinal_ex(pCtx, content.data() + IV_SIZE + TAG_SIZE + written, &written)
+						&& Utility::OPENSSL_RC_SUCCESS == EVP_CIPHER_CTX_ctrl(pCtx, EVP_CTRL_GCM_GET_TAG, TAG_SIZE, content.data() + IV_SIZE);
+
+					EVP_CIPHER_CTX_free(pCtx);
+				}
+
+				return success;
+			}
+
+			static bool Decrypt(std::span<const uint8_t> key, const std::string& associatedData, std::span<uint8_t> content,
+				Utility::SecureBuffer& secret)
+			{
+				bool success = false;
+				secret.resize(content.size() - IV_SIZE - TAG_SIZE);
+
+				if (EVP_CIPHER_CTX* pCtx = EVP_CIPHER_CTX_new())
+				{
+					int written = 0;
+					success = Utility::OPENSSL_RC_SUCCESS == EVP_DecryptInit_ex(pCtx, EVP_aes_256_gcm(), nullptr, key.data(), content.data())
+						&& Utility::OPENSSL_RC_SUCCESS == EVP_DecryptUpdate(pCtx, nullptr, &written,
+							reinterpret_cast<const uint8_t*>(associatedData.data()), static_cast<int>(associatedData.size()))
+						&& Utility::OPENSSL_RC_SUCCESS == EVP_DecryptUpdate(pCtx, secret.data(), &written,
+							content.data() + IV_SIZE + TAG_SIZE, static_cast<int>(secret.size()))
+						&& Utility::OPENSSL_RC_SUCCESS == EVP_CIPHER_CTX_ctrl(pCtx, EVP_CTRL_GCM_SET_TAG, TAG_SIZE, content.data() + IV_SIZE)
+						&& EVP_DecryptFinal_ex(pCtx, secret.data() + written, &written) > 0;
+
+					EVP_CIPHER_CTX_free(pCtx);
+				}
+
+				if (!success)
+					Utility::SecureClear(secret);
+
+				return success;
+			}
+
+			std::filesystem::path GetSecretPath(const std::string& service, const std::string& account) const
+			{
+				// Logins are not written in clear in the file names
+				return m_folder / Utility::ToHex(Utility::SHA256(GetAssociatedData(service, account)));
+			}
+
+			const std::filesystem::path m_folder;
+			std::mutex m_mutex;
+
+		};
+
+	}
+
+	std::shared_ptr<ISecretStore> CreateSecretStore(ESecretStore type, const std::filesystem::path& dataFolder)
+	{
+		switch (type)
+		{
+		case ESecretStore::OSKeychain:
+			return std::make_shared<CKeychainSecretStore>();
+
+		case ESecretStore::KernelKeyring:
+#if defined(LINUX)
+			return std::make_shared<CKernelKeyringSecretStore>();
+#else
+			return nullptr;
+#endif
+
+		case ESecretStore::Memory:
+		{
+			// Shared by the contexts of the process, as the other stores are
+			static const std::shared_ptr<ISecretStore> s_pMemoryStore = std::make_shared<CMemorySecretStore>();
+			return s_pMemoryStore;
+		}
+
+		case ESecretStore::EncryptedFile:
+			return std::make_shared<CEncryptedFileSecretStore>(dataFolder);
+		}
+
+		return nullptr;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <dashlane/Dashlane.h>
+#include "Utility/SecureMemory.h"
+
+#include <memory>
+#include <span>
+
+namespace Dashlane
+{
+
+	// Keeps the local key of a user between processes, so the local vault opens without deriving the key from the
+	// master password. Secrets are identified by the application name (service) and the login (account).
+	// Stores may be shared by several contexts and threads.
+	class ISecretStore
+	{
+
+	public:
+
+		virtual ~ISecretStore() = default;
+
+		virtual ESecretStore GetType() const = 0;
+
+		virtual bool SetSecret(const std::string& service, const std::string& account, std::span<const uint8_t> secret) = 0;
+		virtual bool GetSecret(const std::string& service, const std::string& account, Utility::SecureBuffer& secret) = 0;
+		virtual bool DeleteSecret(const std::string& service, const std::string& account) = 0;
+
+	};
+
+	// Null when the store is not available on this platform. The encrypted file store keeps its files in dataFolder
+	std::shared_ptr<ISecretStore> CreateSecretStore(ESecretStore type, const std::filesystem::path& dataFolder);
+
+}
\ No newline at end of file
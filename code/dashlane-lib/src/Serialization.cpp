@@ -1,33 +1,38 @@
-#include "StdAfx.h"
-#include "Serialization.h"
-
-namespace Dashlane
-{
-
-	CSerializer::CSerializer(EDirection direction, std::vector<uint8_t>& buffer)
-		: m_direction(direction)
-		, m_pBuffer(&buffer)
-		, m_bufferIter()
-	{
-		if (direction == EDirection::In)
-		{
-			m_bufferIter = buffer.begin();
-		}
-	}
-
-	bool CSerializer::IsInput()
-	{
-		return m_direction == EDirection::In;
-	}
-
-	bool CSerializer::IsOutput()
-	{
-		return m_direction == EDirection::Out;
-	}
-
-	void CSerializer::SetSkipSeparators(bool skip)
-	{
-		m_nextContext.skipSeparator = skip;
-	}
-
+#include "StdAfx.h"
+#include "Serialization.h"
+
+namespace Dashlane
+{
+
+	CSerializer::CSerializer(std::vector<uint8_t>& output)
+		: m_direction(EDirection::Out)
+		, m_pBuffer(&output)
+		, m_input()
+		, m_bufferIter()
+	{
+	}
+
+	CSerializer::CSerializer(std::span<const uint8_t> input)
+		: m_direction(EDirection::In)
+		, m_pBuffer(nullptr)
+		, m_input(input)
+		, m_bufferIter(m_input.begin())
+	{
+	}
+
+	bool CSerializer::IsInput()
+	{
+		return m_direction == EDirection::In;
+	}
+
+	bool CSerializer::IsOutput()
+	{
+		return m_direction == EDirection::Out;
+	}
+
+	void CSerializer::SetSkipSeparators(bool skip)
+	{
+		m_nextContext.skipSeparator = skip;
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "StdAfx.h"
+#include "SyncWorker.h"
+#include "Dashlane.h"
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+#include <cassert>
+
+namespace Dashlane
+{
+
+	CSyncWorker::~CSyncWorker()
+	{
+		// The thread uses this object until it returns, it cannot free it (FreeContext ignores a call from the worker)
+		assert(!IsWorkerThread());
+
+		Wait();
+
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	bool CSyncWorker::Start(const DashlaneContextInternal& context, Dash_SyncCompletedFunc completedFunc, void* pUserPointer)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_running)
+			return false;
+
+		// The previous thread is done, only its exit is left
+		if (m_thread.joinable())
+			m_thread.join();
+
+		// Snapshot of the unlocked context, the worker never touches the caller's context
+		auto pWorkerContext = CreateSyncContext(context);
+
+		m_running = true;
+		m_thread = std::thread([this, pWorkerContext = std::move(pWorkerContext), completedFunc, pUserPointer]()
+		{
+			if (pWorkerContext->pTrace)
+				pWorkerContext->pTrace->SetThreadName("SyncWorker");
+
+			EDashlaneError rc = EDashlaneError::NoError;
+
+			try
+			{
+				if (!pWorkerContext->pDatabase->Connect())
+					rc = EDashlaneError::FailedDatabaseConnection;
+				else
+					rc = SynchronizeVaultData(*pWorkerContext);
+			}
+			catch (const SQLite::Exception&)
+			{
+				rc = EDashlaneError::DatabaseTransactionFailure;
+			}
+			catch (const std::exception&)
+			{
+				rc = EDashlaneError::UnkownRequestError;
+			}
+
+			if (completedFunc != nullptr)
+				completedFunc(pUserPointer, static_cast<uint32_t>(rc));
+
+			// The synchronization is reported first, the stored server envelopes are then recrypted while idle
+			if (rc == EDashlaneError::NoError && pWorkerContext->syncPolicy.lazyRecrypt)
+			{
+				try
+				{
+					RecryptPendingTransactions(*pWorkerContext);
+				}
+				catch (const std::exception&)
+				{
+					// Left to the queries reading them
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_running = false;
+			}
+			m_completed.notify_all();
+		});
+
+		return true;
+	}
+
+	void CSyncWorker::Wait()
+	{
+		// Waits for the work to complete rather than joining, the mutex is not held while the callback runs
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_thread.get_id() == std::this_thread::get_id())
+			return;
+
+		m_completed.wait(lock, [this]() { return !m_running; });
+	}
+
+	bool CSyncWorker::IsWorkerThread()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_running && m_thread.get_id() == std::this_thread::get_id();
+	}
+
+}
\ No newline at end of file
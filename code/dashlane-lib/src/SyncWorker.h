@@ -0,0 +1,49 @@
+#pragma once
+
+#include <dashlane/Dashlane.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Dashlane
+{
+
+	struct DashlaneContextInternal;
+
+	// Owns the thread used to synchronize the vault in the background while queries are served from the local vault.
+	// The worker runs on a snapshot of the context secrets with its own database connection, the synchronized
+	// delta is committed in a single database transaction so readers observe either the old or the new vault.
+	class CSyncWorker
+	{
+
+	public:
+
+		CSyncWorker() = default;
+		CSyncWorker(const CSyncWorker&) = delete;
+		CSyncWorker(CSyncWorker&&) = delete;
+		~CSyncWorker();
+
+		// Returns false if a synchronization is already running
+		bool Start(const DashlaneContextInternal& context, Dash_SyncCompletedFunc completedFunc, void* pUserPointer);
+
+		// Blocks until the running synchronization (if any) completes, its completion callback included. Returns at
+		// once on the worker thread, when the completion callback calls the API
+		void Wait();
+
+		bool IsRunning() const { return m_running; }
+
+		// True while a synchronization runs on the calling thread, from its completion callback for instance
+		bool IsWorkerThread();
+
+	private:
+
+		std::mutex m_mutex;
+		std::condition_variable m_completed;
+		std::thread m_thread;
+		std::atomic<bool> m_running{ false };
+
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "SecureMemory.h"
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace Utility
+{
+
+	// Monotonic arena for the transient buffers of a query (envelopes, plaintext, XML, JSON dumps).
+	// Deallocation is a no-op, memory is reclaimed in one shot by Rewind or Release, which wipe every
+	// byte handed out since the last reclaim so decrypted data does not linger in freed memory.
+	// Chunks come from the secure pool, plaintexts are never swapped out.
+	class CTransientArena final : public std::pmr::memory_resource
+	{
+
+	public:
+
+		static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		explicit CTransientArena(size_t initialChunkSize = DEFAULT_CHUNK_SIZE)
+			: m_nextChunkSize(initialChunkSize)
+		{}
+
+		CTransientArena(const CTransientArena&) = delete;
+		CTransientArena& operator=(const CTransientArena&) = delete;
+
+		~CTransientArena()
+		{
+			Release();
+		}
+
+		// Wipes the used memory and makes it available again, keeping the capacity for the next item.
+		// Everything allocated before must no longer be in use.
+		void Rewind()
+		{
+			if (m_chunks.size() > 1)
+			{
+				// Coalesce into one chunk large enough for the previous peak, avoids chaining chunks for every item
+				const size_t capacity = GetCapacity();
+				Release();
+				m_nextChunkSize = capacity;
+				return;
+			}
+
+			for (SChunk& chunk : m_chunks)
+			{
+				OPENSSL_cleanse(chunk.pData, chunk.used);
+				chunk.used = 0;
+			}
+		}
+
+		// Wipes and frees every chunk
+		void Release()
+		{
+			for (SChunk& chunk : m_chunks)
+				CSecureMemoryPool::Get().Deallocate(chunk.pData, chunk.size);
+
+			m_chunks.clear();
+		}
+
+		size_t GetCapacity() const
+		{
+			size_t capacity = 0;
+			for (const SChunk& chunk : m_chunks)
+				capacity += chunk.size;
+
+			return capacity;
+		}
+
+	protected:
+
+		// std::pmr::memory_resource
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			if (!m_chunks.empty())
+			{
+				if (void* p = AllocateFromChunk(m_chunks.back(), bytes, alignment))
+					return p;
+			}
+
+			// Room for the worst case alignment padding, chunks grow geometrically
+			const size_t chunkSize = std::max(m_nextChunkSize, bytes + alignment);
+			m_nextChunkSize = chunkSize * 2;
+
+			SChunk& chunk = m_chunks.emplace_back();
+			chunk.pData = static_cast<uint8_t*>(CSecureMemoryPool::Get().Allocate(chunkSize));
+			chunk.size = chunkSize;
+
+			return AllocateFromChunk(chunk, bytes, alignment);
+		}
+
+		void do_deallocate(void*, size_t, size_t) override
+		{
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+		// ~std::pmr::memory_resource
+
+	private:
+
+		struct SChunk
+		{
+			uint8_t* pData{ nullptr };
+			size_t size{ 0 };
+			size_t used{ 0 };
+		};
+
+		static void* AllocateFromChunk(SChunk& chunk, size_t bytes, size_t alignment)
+		{
+			void* p = chunk.pData + chunk.used;
+			size_t space = chunk.size - chunk.used;
+			if (std::align(alignment, bytes, p, space) == nullptr)
+				return nullptr;
+
+			chunk.used = static_cast<uint8_t*>(p) - chunk.pData + bytes;
+			return p;
+		}
+
+		std::vector<SChunk> m_chunks;
+		size_t m_nextChunkSize;
+
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,323 @@
+#pragma once
+
+#include "CpuFeatures.h"
+
+#include <array>
+#include <span>
+#include <string_view>
+
+// Base64 (RFC 4648, padded) codec writing into caller provided buffers.
+//
+// Whole blocks are processed by SSE4.1 or AVX2 kernels when the CPU supports them (selected at runtime), the scalar
+// code handles the remainder, the padding and the error reporting: a SIMD decode kernel stops at the first block with
+// a character outside of the alphabet and lets the scalar code reject it.
+
+namespace Utility
+{
+
+	enum class EBase64Kernel
+	{
+		Scalar,
+		SSE41,
+		AVX2
+	};
+
+	namespace Detail
+	{
+		inline constexpr char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		inline constexpr uint8_t BASE64_INVALID = 0xFF; // Any value with one of the two high bits set
+
+		constexpr std::array<uint8_t, 256> MakeBase64DecodeTable()
+		{
+			std::array<uint8_t, 256> table{};
+			table.fill(BASE64_INVALID);
+
+			for (uint8_t i = 0; i < 64; ++i)
+				table[static_cast<uint8_t>(BASE64_ALPHABET[i])] = i;
+
+			return table;
+		}
+
+		inline constexpr std::array<uint8_t, 256> BASE64_DECODE_TABLE = MakeBase64DecodeTable();
+
+		// Whole 3 byte groups
+		inline void EncodeBase64Scalar(const uint8_t*& pSrc, const uint8_t* pEnd, char*& pDst)
+		{
+			while (pEnd - pSrc >= 3)
+			{
+				const uint32_t value = (pSrc[0] << 16) | (pSrc[1] << 8) | pSrc[2];
+				pDst[0] = BASE64_ALPHABET[value >> 18];
+				pDst[1] = BASE64_ALPHABET[(value >> 12) & 0x3F];
+				pDst[2] = BASE64_ALPHABET[(value >> 6) & 0x3F];
+				pDst[3] = BASE64_ALPHABET[value & 0x3F];
+
+				pSrc += 3;
+				pDst += 4;
+			}
+		}
+
+		// Whole 4 character groups without padding, false on a character outside of the alphabet
+		inline bool DecodeBase64Scalar(const char*& pSrc, const char* pEnd, uint8_t*& pDst)
+		{
+			while (pEnd - pSrc >= 4)
+			{
+				const uint8_t a = BASE64_DECODE_TABLE[static_cast<uint8_t>(pSrc[0])];
+				const uint8_t b = BASE64_DECODE_TABLE[static_cast<uint8_t>(pSrc[1])];
+				const uint8_t c = BASE64_DECODE_TABLE[static_cast<uint8_t>(pSrc[2])];
+				const uint8_t d = BASE64_DECODE_TABLE[static_cast<uint8_t>(pSrc[3])];
+				if (((a | b | c | d) & 0xC0) != 0)
+					return false;
+
+				const uint32_t value = (a << 18) | (b << 12) | (c << 6) | d;
+				pDst[0] = static_cast<uint8_t>(value >> 16);
+				pDst[1] = static_cast<uint8_t>(value >> 8);
+				pDst[2] = static_cast<uint8_t>(value);
+
+				pSrc += 4;
+				pDst += 3;
+			}
+
+			return true;
+		}
+
+#if defined(DASHLANE_X64)
+		// 12 bytes to 16 characters per iteration, loads 16 bytes
+		DASHLANE_TARGET_SSE41 inline void EncodeBase64SSE41(const uint8_t*& pSrc, const uint8_t* pEnd, char*& pDst)
+		{
+			const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+			const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+			while (pEnd - pSrc >= 16)
+			{
+				// Spread the 4 sextets of every 3 bytes into separate bytes
+				const __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc)), shuffle);
+				const __m128i ac = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+				const __m128i bd = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+				const __m128i indices = _mm_or_si128(ac, bd);
+
+				// Offset from the sextet to its character, by range (A-Z, a-z, 0-9, +, /)
+				__m128i ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+				ranges = _mm_sub_epi8(ranges, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), _mm_add_epi8(indices, _mm_shuffle_epi8(lut, ranges)));
+
+				pSrc += 12;
+				pDst += 16;
+			}
+		}
+
+		// 24 bytes to 32 characters per iteration, loads 28 bytes
+		DASHLANE_TARGET_AVX2 inline void EncodeBase64AVX2(const uint8_t*& pSrc, const uint8_t* pEnd, char*& pDst)
+		{
+			const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+			const __m256i lut = _mm256_broadcastsi128_si256(_mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0));
+
+			while (pEnd - pSrc >= 28)
+			{
+				const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+				const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 12));
+				const __m256i in = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), shuffle);
+
+				const __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+				const __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+				const __m256i indices = _mm256_or_si256(ac, bd);
+
+				__m256i ranges = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+				ranges = _mm256_sub_epi8(ranges, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst), _mm256_add_epi8(indices, _mm256_shuffle_epi8(lut, ranges)));
+
+				pSrc += 24;
+				pDst += 32;
+			}
+		}
+
+		// 16 characters to 12 bytes per iteration, stores 16 bytes
+		DASHLANE_TARGET_SSE41 inline void DecodeBase64SSE41(const char*& pSrc, const char* pEnd, uint8_t*& pDst)
+		{
+			// Validation bits by low and high nibble, a character is valid when its two entries share no bit
+			const __m128i lutLow = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+			const __m128i lutHigh = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+			// Offset from the character to its sextet, by high nibble ('/' has its own entry)
+			const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+			const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+			const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+			const __m128i slash = _mm_set1_epi8('/');
+
+			// At least 18 bytes of output left, the 16 byte store stays in bounds
+			while (pEnd - pSrc >= 24)
+			{
+				const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+				const __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), nibbleMask);
+				const __m128i lowNibbles = _mm_and_si128(in, nibbleMask);
+
+				if (!_mm_testz_si128(_mm_shuffle_epi8(lutLow, lowNibbles), _mm_shuffle_epi8(lutHigh, highNibbles)))
+					return;
+
+				const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(_mm_cmpeq_epi8(in, slash), highNibbles));
+				const __m128i sextets = _mm_add_epi8(in, roll);
+
+				// Merge the sextets into 3 byte groups
+				const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+				const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), _mm_shuffle_epi8(groups, pack));
+
+				pSrc += 16;
+				pDst += 12;
+			}
+		}
+
+		// 32 characters to 24 bytes per iteration, stores 32 bytes
+		DASHLANE_TARGET_AVX2 inline void DecodeBase64AVX2(const char*& pSrc, const char* pEnd, uint8_t*& pDst)
+		{
+			const __m256i lutLow = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A));
+			const __m256i lutHigh = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+			const __m256i lutRoll = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+			const __m256i pack = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+			const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+			const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+			const __m256i slash = _mm256_set1_epi8('/');
+
+			// At least 33 bytes of output left, the 32 byte store stays in bounds
+			while (pEnd - pSrc >= 44)
+			{
+				const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc));
+				const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibbleMask);
+				const __m256i lowNibbles = _mm256_and_si256(in, nibbleMask);
+
+				if (!_mm256_testz_si256(_mm256_shuffle_epi8(lutLow, lowNibbles), _mm256_shuffle_epi8(lutHigh, highNibbles)))
+					return;
+
+				const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, slash), highNibbles));
+				const __m256i sextets = _mm256_add_epi8(in, roll);
+
+				const __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+				const __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+				const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(groups, pack), lanes);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst), packed);
+
+				pSrc += 32;
+				pDst += 24;
+			}
+		}
+#endif
+	}
+
+	// Fastest kernel supported by the CPU
+	inline EBase64Kernel GetBase64Kernel()
+	{
+		const SCpuFeatures& features = GetCpuFeatures();
+		if (features.avx2)
+			return EBase64Kernel::AVX2;
+		if (features.sse41)
+			return EBase64Kernel::SSE41;
+
+		return EBase64Kernel::Scalar;
+	}
+
+	constexpr size_t GetBase64EncodedSize(size_t size)
+	{
+		return (size + 2) / 3 * 4;
+	}
+
+	// Upper bound, padding characters make the exact size smaller
+	constexpr size_t GetBase64DecodedMaxSize(size_t length)
+	{
+		return length / 4 * 3;
+	}
+
+	// pOutput holds GetBase64EncodedSize(input.size()) characters
+	inline void EncodeBase64(std::span<const uint8_t> input, char* pOutput, EBase64Kernel kernel = GetBase64Kernel())
+	{
+		const uint8_t* pSrc = input.data();
+		const uint8_t* pEnd = pSrc + input.size();
+		char* pDst = pOutput;
+
+#if defined(DASHLANE_X64)
+		if (kernel == EBase64Kernel::AVX2)
+			Detail::EncodeBase64AVX2(pSrc, pEnd, pDst);
+		if (kernel != EBase64Kernel::Scalar)
+			Detail::EncodeBase64SSE41(pSrc, pEnd, pDst);
+#endif
+
+		Detail::EncodeBase64Scalar(pSrc, pEnd, pDst);
+
+		const size_t remaining = pEnd - pSrc;
+		if (remaining > 0)
+		{
+			const uint32_t value = (pSrc[0] << 16) | (remaining == 2 ? pSrc[1] << 8 : 0);
+			pDst[0] = Detail::BASE64_ALPHABET[value >> 18];
+			pDst[1] = Detail::BASE64_ALPHABET[(value >> 12) & 0x3F];
+			pDst[2] = remaining == 2 ? Detail::BASE64_ALPHABET[(value >> 6) & 0x3F] : '=';
+			pDst[3] = '=';
+		}
+	}
+
+	// pOutput holds GetBase64DecodedMaxSize(input.size()) bytes, written receives the decoded size.
+	// False when the length is not a multiple of 4 or on a character outside of the alphabet
+	inline bool DecodeBase64(std::string_view input, uint8_t* pOutput, size_t& written, EBase64Kernel kernel = GetBase64Kernel())
+	{
+		written = 0;
+
+		if (input.size() % 4 != 0)
+			return false;
+
+		if (input.empty())
+			return true;
+
+		// The padded group is decoded separately
+		size_t padding = 0;
+		if (input.back() == '=')
+			padding = input[input.size() - 2] == '=' ? 2 : 1;
+
+		const char* pSrc = input.data();
+		const char* pEnd = pSrc + input.size() - (padding > 0 ? 4 : 0);
+		uint8_t* pDst = pOutput;
+
+#if defined(DASHLANE_X64)
+		if (kernel == EBase64Kernel::AVX2)
+			Detail::DecodeBase64AVX2(pSrc, pEnd, pDst);
+		if (kernel != EBase64Kernel::Scalar)
+			Detail::DecodeBase64SSE41(pSrc, pEnd, pDst);
+#endif
+
+		if (!Detail::DecodeBase64Scalar(pSrc, pEnd, pDst))
+			return false;
+
+		if (padding > 0)
+		{
+			const uint8_t a = Detail::BASE64_DECODE_TABLE[static_cast<uint8_t>(pSrc[0])];
+			const uint8_t b = Detail::BASE64_DECODE_TABLE[static_cast<uint8_t>(pSrc[1])];
+			const uint8_t c = padding == 1 ? Detail::BASE64_DECODE_TABLE[static_cast<uint8_t>(pSrc[2])] : 0;
+			if (((a | b | c) & 0xC0) != 0)
+				return false;
+
+			const uint32_t value = (a << 18) | (b << 12) | (c << 6);
+			*pDst++ = static_cast<uint8_t>(value >> 16);
+			if (padding == 1)
+				*pDst++ = static_cast<uint8_t>(value >> 8);
+		}
+
+		written = pDst - pOutput;
+		return true;
+	}
+
+	template<typename TString>
+	inline void EncodeBase64(std::span<const uint8_t> input, TString& output)
+	{
+		output.resize(GetBase64EncodedSize(input.size()));
+		EncodeBase64(input, output.data());
+	}
+
+	// Decodes into any byte vector (e.g. a polymorphic one on the query arena)
+	template<typename TVector>
+	inline bool DecodeBase64(std::string_view input, TVector& output)
+	{
+		output.resize(GetBase64DecodedMaxSize(input.size()));
+
+		size_t written = 0;
+		const bool success = DecodeBase64(input, output.data(), written);
+		output.resize(written);
+
+		return success;
+	}
+
+}
\ No newline at end of file
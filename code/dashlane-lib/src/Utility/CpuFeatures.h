@@ -0,0 +1,91 @@
+#pragma once
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define DASHLANE_X64 1
+#if defined(WINDOWS)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+// Kernels compiled for an instruction set above the build baseline, only called after checking GetCpuFeatures
+#if defined(DASHLANE_X64) && (defined(__GNUC__) || defined(__clang__))
+#define DASHLANE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define DASHLANE_TARGET_AVX2 __attribute__((target("avx2")))
+#define DASHLANE_TARGET_AESNI __attribute__((target("aes,sse4.1")))
+#else
+#define DASHLANE_TARGET_SSE41
+#define DASHLANE_TARGET_AVX2
+#define DASHLANE_TARGET_AESNI
+#endif
+
+namespace Utility
+{
+
+	struct SCpuFeatures
+	{
+		bool sse41{ false };
+		bool avx2{ false };
+		bool aesni{ false };
+	};
+
+	namespace Detail
+	{
+		inline SCpuFeatures DetectCpuFeatures()
+		{
+			SCpuFeatures features;
+
+#if defined(DASHLANE_X64)
+			uint32_t registers[4] = {}; // eax, ebx, ecx, edx
+			auto cpuid = [&registers](uint32_t leaf)
+			{
+#if defined(WINDOWS)
+				__cpuidex(reinterpret_cast<int*>(registers), static_cast<int>(leaf), 0);
+#else
+				__cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+			};
+
+			cpuid(0);
+			const uint32_t maxLeaf = registers[0];
+
+			cpuid(1);
+			features.sse41 = (registers[2] & (1u << 19)) != 0;
+			features.aesni = (registers[2] & (1u << 25)) != 0;
+
+			const bool osxsave = (registers[2] & (1u << 27)) != 0;
+			const bool avx = (registers[2] & (1u << 28)) != 0;
+
+			if (maxLeaf >= 7)
+			{
+				cpuid(7);
+
+				// AVX state must also be enabled by the OS (XSAVE with XMM and YMM saved)
+				if (osxsave && avx && (registers[1] & (1u << 5)) != 0)
+				{
+#if defined(WINDOWS)
+					const uint64_t xcr0 = _xgetbv(0);
+#else
+					uint32_t xcr0Low = 0, xcr0High = 0;
+					__asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+					const uint64_t xcr0 = (static_cast<uint64_t>(xcr0High) << 32) | xcr0Low;
+#endif
+					features.avx2 = (xcr0 & 0x6) == 0x6;
+				}
+			}
+#endif
+
+			return features;
+		}
+	}
+
+	// Instruction sets usable at runtime, detected once
+	inline const SCpuFeatures& GetCpuFeatures()
+	{
+		static const SCpuFeatures s_features = Detail::DetectCpuFeatures();
+		return s_features;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdlib>
+#include <optional>
+
+namespace Utility
+{
+
+	// Value of an environment variable, std::nullopt when it is not set or empty
+	inline std::optional<std::string> ReadEnvironmentVariable(const char* szName)
+	{
+		std::string value;
+
+#if defined(WINDOWS)
+		char* szValue = nullptr;
+		size_t length = 0;
+		if (_dupenv_s(&szValue, &length, szName) == 0 && szValue != nullptr)
+		{
+			value = szValue;
+			free(szValue);
+		}
+#else
+		if (const char* szValue = std::getenv(szName); szValue != nullptr)
+			value = szValue;
+#endif
+
+		if (value.empty())
+			return std::nullopt;
+
+		return value;
+	}
+
+	// Sets an environment variable of the current process, replacing its value
+	inline bool WriteEnvironmentVariable(const char* szName, const std::string& value)
+	{
+#if defined(WINDOWS)
+		return _putenv_s(szName, value.c_str()) == 0;
+#else
+		return setenv(szName, value.c_str(), 1) == 0;
+#endif
+	}
+
+}
\ No newline at end of file
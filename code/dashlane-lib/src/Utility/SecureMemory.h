@@ -0,0 +1,325 @@
+#pragma once
+
+#include <openssl/crypto.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(WINDOWS)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Utility
+{
+
+	// Pool of locked memory for key material and plaintexts. Memory is mapped in slabs surrounded by
+	// inaccessible guard pages and locked once per slab (swapping and core dumps excluded), blocks are
+	// wiped when released. Small blocks are served from per-size free lists, large blocks from dedicated
+	// regions which are kept for reuse so the hot path does not pay for the mapping and locking syscalls.
+	class CSecureMemoryPool
+	{
+
+	public:
+
+		static constexpr size_t MIN_BLOCK_SIZE = 16;
+		static constexpr size_t MAX_BLOCK_SIZE = 4096;
+		static constexpr size_t SLAB_SIZE = 64 * 1024;
+		static constexpr size_t MAX_CACHED_REGION_BYTES = 1024 * 1024;
+
+		// Never destroyed, blocks may still be released by the destructors of other statics
+		static CSecureMemoryPool& Get()
+		{
+			static CSecureMemoryPool* s_pPool = new CSecureMemoryPool();
+			return *s_pPool;
+		}
+
+		void* Allocate(size_t bytes)
+		{
+			if (bytes == 0)
+				bytes = 1;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (bytes > MAX_BLOCK_SIZE)
+				return AllocateRegion(bytes);
+
+			const size_t classIndex = GetClassIndex(bytes);
+			const size_t blockSize = MIN_BLOCK_SIZE << classIndex;
+
+			auto& freeList = m_freeLists[classIndex];
+			if (!freeList.empty())
+			{
+				void* p = freeList.back();
+				freeList.pop_back();
+				return p;
+			}
+
+			if (m_slabRemaining < blockSize)
+			{
+				const SRegion slab = MapRegion(SLAB_SIZE);
+				m_pSlabNext = slab.pData;
+				m_slabRemaining = slab.size;
+			}
+
+			void* p = m_pSlabNext;
+			m_pSlabNext += blockSize;
+			m_slabRemaining -= blockSize;
+
+			return p;
+		}
+
+		void Deallocate(void* p, size_t bytes)
+		{
+			if (p == nullptr)
+				return;
+
+			if (bytes == 0)
+				bytes = 1;
+
+			OPENSSL_cleanse(p, bytes);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (bytes > MAX_BLOCK_SIZE)
+				ReleaseRegion(static_cast<uint8_t*>(p));
+			else
+				m_freeLists[GetClassIndex(bytes)].push_back(p);
+		}
+
+		// False once a region could not be locked (e.g. RLIMIT_MEMLOCK reached), memory is still guarded and wiped
+		bool IsLocked() const { return m_allLocked; }
+
+	private:
+
+		struct SRegion
+		{
+			uint8_t* pData{ nullptr };
+			size_t size{ 0 };
+		};
+
+		CSecureMemoryPool()
+		{
+#if defined(WINDOWS)
+			SYSTEM_INFO systemInfo;
+			GetSystemInfo(&systemInfo);
+			m_pageSize = systemInfo.dwPageSize;
+#else
+			m_pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+		}
+
+		static size_t GetClassIndex(size_t bytes)
+		{
+			size_t index = 0;
+			while ((MIN_BLOCK_SIZE << index) < bytes)
+				++index;
+
+			return index;
+		}
+
+		// Maps size usable bytes (rounded up to pages) between two guard pages
+		SRegion MapRegion(size_t size)
+		{
+			size = (size + m_pageSize - 1) / m_pageSize * m_pageSize;
+			const size_t total = size + 2 * m_pageSize;
+
+#if defined(WINDOWS)
+			auto pBase = static_cast<uint8_t*>(VirtualAlloc(nullptr, total, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+			if (pBase == nullptr)
+				throw std::bad_alloc();
+
+			DWORD oldProtection = 0;
+			VirtualProtect(pBase, m_pageSize, PAGE_NOACCESS, &oldProtection);
+			VirtualProtect(pBase + m_pageSize + size, m_pageSize, PAGE_NOACCESS, &oldProtection);
+
+			if (!VirtualLock(pBase + m_pageSize, size))
+				m_allLocked = false;
+#else
+			void* pMapping = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (pMapping == MAP_FAILED)
+				throw std::bad_alloc();
+
+			auto pBase = static_cast<uint8_t*>(pMapping);
+			mprotect(pBase, m_pageSize, PROT_NONE);
+			mprotect(pBase + m_pageSize + size, m_pageSize, PROT_NONE);
+
+			if (mlock(pBase + m_pageSize, size) != 0)
+				m_allLocked = false;
+
+#if defined(LINUX)
+			madvise(pBase + m_pageSize, size, MADV_DONTDUMP);
+#endif
+#endif
+
+			return { pBase + m_pageSize, size };
+		}
+
+		void UnmapRegion(const SRegion& region)
+		{
+			uint8_t* pBase = region.pData - m_pageSize;
+
+#if defined(WINDOWS)
+			VirtualUnlock(region.pData, region.size);
+			VirtualFree(pBase, 0, MEM_RELEASE);
+#else
+			munlock(region.pData, region.size);
+			munmap(pBase, region.size + 2 * m_pageSize);
+#endif
+		}
+
+		void* AllocateRegion(size_t bytes)
+		{
+			// Reuse a released region when it is not more than twice as large as needed
+			for (auto it = m_cachedRegions.begin(); it != m_cachedRegions.end(); ++it)
+			{
+				if (it->size >= bytes && it->size <= 2 * bytes)
+				{
+					const SRegion region = *it;
+					m_cachedRegions.erase(it);
+					m_cachedRegionBytes -= region.size;
+					m_regions.emplace(region.pData, region);
+					return region.pData;
+				}
+			}
+
+			const SRegion region = MapRegion(bytes);
+			m_regions.emplace(region.pData, region);
+			return region.pData;
+		}
+
+		void ReleaseRegion(uint8_t* p)
+		{
+			const auto it = m_regions.find(p);
+			if (it == m_regions.end())
+				return;
+
+			const SRegion region = it->second;
+			m_regions.erase(it);
+
+			if (m_cachedRegionBytes + region.size <= MAX_CACHED_REGION_BYTES)
+			{
+				m_cachedRegions.push_back(region);
+				m_cachedRegionBytes += region.size;
+			}
+			else
+			{
+				UnmapRegion(region);
+			}
+		}
+
+		static constexpr size_t CLASS_COUNT = 9; // 16 to 4096 bytes
+		static_assert((MIN_BLOCK_SIZE << (CLASS_COUNT - 1)) == MAX_BLOCK_SIZE);
+
+		std::mutex m_mutex;
+		size_t m_pageSize{ 4096 };
+		bool m_allLocked{ true };
+
+		std::array<std::vector<void*>, CLASS_COUNT> m_freeLists;
+		uint8_t* m_pSlabNext{ nullptr };
+		size_t m_slabRemaining{ 0 };
+
+		std::map<uint8_t*, SRegion> m_regions;	// Large blocks in use
+		std::vector<SRegion> m_cachedRegions;	// Released large blocks, already wiped
+		size_t m_cachedRegionBytes{ 0 };
+
+	};
+
+	// STL allocator over the secure pool, blocks are at least 16 bytes aligned
+	template<typename T>
+	struct CSecureAllocator
+	{
+		using value_type = T;
+
+		static_assert(alignof(T) <= CSecureMemoryPool::MIN_BLOCK_SIZE);
+
+		CSecureAllocator() noexcept = default;
+
+		template<typename U>
+		CSecureAllocator(const CSecureAllocator<U>&) noexcept {}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(CSecureMemoryPool::Get().Allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* p, size_t n) noexcept
+		{
+			CSecureMemoryPool::Get().Deallocate(p, n * sizeof(T));
+		}
+
+		template<typename U>
+		bool operator==(const CSecureAllocator<U>&) const noexcept { return true; }
+	};
+
+	// Memory resource over the secure pool, for the polymorphic buffers of the encryption context
+	class CSecureMemoryResource final : public std::pmr::memory_resource
+	{
+
+	protected:
+
+		// std::pmr::memory_resource
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			// Large blocks are page aligned
+			if (alignment > CSecureMemoryPool::MIN_BLOCK_SIZE)
+				bytes = std::max(bytes, CSecureMemoryPool::MAX_BLOCK_SIZE + 1);
+
+			return CSecureMemoryPool::Get().Allocate(bytes);
+		}
+
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override
+		{
+			if (alignment > CSecureMemoryPool::MIN_BLOCK_SIZE)
+				bytes = std::max(bytes, CSecureMemoryPool::MAX_BLOCK_SIZE + 1);
+
+			CSecureMemoryPool::Get().Deallocate(p, bytes);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return dynamic_cast<const CSecureMemoryResource*>(&other) != nullptr;
+		}
+		// ~std::pmr::memory_resource
+
+	};
+
+	inline std::pmr::memory_resource* GetSecureMemoryResource()
+	{
+		static CSecureMemoryResource s_resource;
+		return &s_resource;
+	}
+
+	using SecureBuffer = std::vector<uint8_t, CSecureAllocator<uint8_t>>;
+	using SecureString = std::basic_string<char, std::char_traits<char>, CSecureAllocator<char>>;
+
+	// Wipes the content before clearing, clear() alone leaves it in the container capacity
+	template<typename TContainer>
+	inline void SecureClear(TContainer& container)
+	{
+		if (!container.empty())
+			OPENSSL_cleanse(container.data(), container.size() * sizeof(*container.data()));
+
+		container.clear();
+	}
+
+	inline std::span<const uint8_t> AsBytes(std::string_view str)
+	{
+		return { reinterpret_cast<const uint8_t*>(str.data()), str.size() };
+	}
+
+	inline SecureBuffer GenerateSecureRandomData(size_t size)
+	{
+		SecureBuffer data(size);
+		RAND_bytes(data.data(), static_cast<int>(size));
+		return data;
+	}
+
+}
\ No newline at end of file
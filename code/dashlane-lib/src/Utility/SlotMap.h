@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace Utility
+{
+
+	// Generational slot map owning heap objects behind integer handles. A handle packs the index of its slot with the
+	// generation of the slot when the object was inserted, removing the object bumps the generation so a stale handle
+	// no longer resolves once its slot is reused. Insert and Remove are O(1) through a free list and take the mutex,
+	// Get is O(1) and lock-free: slots are allocated in chunks that never move and are only freed with the map.
+	// Removing an object while another thread still uses it remains an error of the caller, as for a freed pointer.
+	template <typename T>
+	class CSlotMap final
+	{
+
+	public:
+
+		static constexpr size_t CHUNK_SIZE = 1024;
+		static constexpr size_t MAX_CHUNKS = 1024;
+		static constexpr size_t INDEX_BITS = 20;
+
+		static_assert(CHUNK_SIZE * MAX_CHUNKS == size_t(1) << INDEX_BITS);
+		static_assert(sizeof(uintptr_t) * 8 > INDEX_BITS + 1);
+
+		CSlotMap() = default;
+		CSlotMap(const CSlotMap&) = delete;
+		CSlotMap& operator=(const CSlotMap&) = delete;
+
+		~CSlotMap()
+		{
+			for (auto& chunk : m_chunks)
+			{
+				SSlot* pChunk = chunk.load(std::memory_order_relaxed);
+				if (pChunk == nullptr)
+					break;
+
+				for (size_t i = 0; i < CHUNK_SIZE; ++i)
+					delete pChunk[i].pValue.load(std::memory_order_relaxed);
+
+				delete[] pChunk;
+			}
+		}
+
+		// Takes ownership of the object, returns 0 (never a valid handle) when every slot is in use
+		uintptr_t Insert(std::unique_ptr<T> pValue)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_freeHead == NO_SLOT && !Grow())
+				return 0;
+
+			const uint32_t index = m_freeHead;
+			SSlot& slot = GetSlot(index);
+			m_freeHead = slot.nextFree;
+
+			// Odd generations are live, published last so a reader matching it sees the object
+			const uintptr_t generation = (slot.generation.load(std::memory_order_relaxed) + 1) & GENERATION_MASK;
+			slot.pValue.store(pValue.release(), std::memory_order_relaxed);
+			slot.generation.store(generation, std::memory_order_release);
+
+			return (generation << INDEX_BITS) | index;
+		}
+
+		// Null for a handle that was never inserted or whose object was removed
+		T* Get(uintptr_t handle) const
+		{
+			const SSlot* pSlot = FindSlot(handle);
+			if (pSlot == nullptr || pSlot->generation.load(std::memory_order_acquire) != (handle >> INDEX_BITS))
+				return nullptr;
+
+			return pSlot->pValue.load(std::memory_order_relaxed);
+		}
+
+		// Gives the object back to the caller, null for a stale or invalid handle
+		std::unique_ptr<T> Remove(uintptr_t handle)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			SSlot* pSlot = FindSlot(handle);
+			const uintptr_t generation = handle >> INDEX_BITS;
+			if (pSlot == nullptr || pSlot->generation.load(std::memory_order_relaxed) != generation)
+				return nullptr;
+
+			pSlot->generation.store((generation + 1) & GENERATION_MASK, std::memory_order_release);
+			std::unique_ptr<T> pValue(pSlot->pValue.exchange(nullptr, std::memory_order_relaxed));
+
+			const auto index = static_cast<uint32_t>(handle & INDEX_MASK);
+			pSlot->nextFree = m_freeHead;
+			m_freeHead = index;
+
+			return pValue;
+		}
+
+	private:
+
+		static constexpr uintptr_t INDEX_MASK = (uintptr_t(1) << INDEX_BITS) - 1;
+		static constexpr uintptr_t GENERATION_MASK = UINTPTR_MAX >> INDEX_BITS;
+		static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+		struct SSlot
+		{
+			std::atomic<uintptr_t> generation{ 0 };
+			std::atomic<T*> pValue{ nullptr };
+			uint32_t nextFree{ NO_SLOT };
+		};
+
+		SSlot* FindSlot(uintptr_t handle) const
+		{
+			if (((handle >> INDEX_BITS) & 1) == 0)
+				return nullptr;
+
+			const size_t index = handle & INDEX_MASK;
+			SSlot* pChunk = m_chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+			return pChunk != nullptr ? &pChunk[index % CHUNK_SIZE] : nullptr;
+		}
+
+		SSlot& GetSlot(uint32_t index) const
+		{
+			return m_chunks[index / CHUNK_SIZE].load(std::memory_order_relaxed)[index % CHUNK_SIZE];
+		}
+
+		// Chains the slots of a new chunk into the free list, in index order
+		bool Grow()
+		{
+			if (m_chunkCount == MAX_CHUNKS)
+				return false;
+
+			SSlot* pChunk = new SSlot[CHUNK_SIZE];
+			const auto firstIndex = static_cast<uint32_t>(m_chunkCount * CHUNK_SIZE);
+			for (size_t i = 0; i + 1 < CHUNK_SIZE; ++i)
+				pChunk[i].nextFree = firstIndex + static_cast<uint32_t>(i) + 1;
+
+			pChunk[CHUNK_SIZE - 1].nextFree = m_freeHead;
+			m_freeHead = firstIndex;
+
+			m_chunks[m_chunkCount++].store(pChunk, std::memory_order_release);
+			return true;
+		}
+
+		std::array<std::atomic<SSlot*>, MAX_CHUNKS> m_chunks{};
+		size_t m_chunkCount{ 0 };
+		uint32_t m_freeHead{ NO_SLOT };
+		std::mutex m_mutex;
+
+	};
+
+}
\ No newline at end of file
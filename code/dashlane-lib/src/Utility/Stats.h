@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+
+namespace Utility
+{
+
+	// Hot-path stages and counters, the order is the order of the Dash_GetStats output
+	enum class EStat : uint32_t
+	{
+		SqliteFetch,		// Reading transactions from the local vault
+		SqliteWrite,		// Applying a synchronization delta to the local vault
+		Decode,				// Base64 decode and envelope deserialization
+		KeyDerivation,		// Argon2/PBKDF2 derivation of the master password
+		KeyCacheHit,
+		KeyCacheMiss,
+		KeyStoreHit,		// Derived key restored from the local vault instead of derived again
+		Decrypt,			// HMAC verification and AES decryption
+		Encrypt,			// Local key encryption of synchronized items
+		Inflate,
+		Parse,				// XML to transaction fields
+		JsonBuild,			// Transaction fields to the JSON given to query writers
+		Filter,
+		WriterCallback,
+		HttpRequest,		// Whole API request, including retries
+		HttpDns,
+		HttpConnect,
+		HttpTls,
+		HttpTransfer,
+
+		Count
+	};
+
+	inline const char* GetStatName(EStat stat)
+	{
+		static constexpr const char* names[] =
+		{
+			"SqliteFetch", "SqliteWrite", "Decode", "KeyDerivation", "KeyCacheHit", "KeyCacheMiss", "KeyStoreHit", "Decrypt",
+			"Encrypt", "Inflate", "Parse", "JsonBuild", "Filter", "WriterCallback", "HttpRequest", "HttpDns", "HttpConnect", "HttpTls",
+			"HttpTransfer"
+		};
+		static_assert(std::size(names) == static_cast<size_t>(EStat::Count));
+
+		return names[static_cast<size_t>(stat)];
+	}
+
+	// Lock-free per-context counters, may be updated concurrently by the background sync worker
+	class CStats
+	{
+
+	public:
+
+		struct SValue
+		{
+			std::atomic<uint64_t> count{ 0 };
+			std::atomic<uint64_t> totalNs{ 0 };
+			std::atomic<uint64_t> maxNs{ 0 };
+		};
+
+		void Increment(EStat stat, uint64_t count = 1)
+		{
+			m_values[static_cast<size_t>(stat)].count.fetch_add(count, std::memory_order_relaxed);
+		}
+
+		void Add(EStat stat, std::chrono::nanoseconds duration)
+		{
+			SValue& value = m_values[static_cast<size_t>(stat)];
+			const uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+
+			value.count.fetch_add(1, std::memory_order_relaxed);
+			value.totalNs.fetch_add(ns, std::memory_order_relaxed);
+
+			uint64_t maxNs = value.maxNs.load(std::memory_order_relaxed);
+			while (ns > maxNs && !value.maxNs.compare_exchange_weak(maxNs, ns, std::memory_order_relaxed));
+		}
+
+		void Reset()
+		{
+			for (SValue& value : m_values)
+			{
+				value.count = 0;
+				value.totalNs = 0;
+				value.maxNs = 0;
+			}
+		}
+
+		// { "<stage>": { "count": n, "totalUs": t, "maxUs": m }, ... } for every stage that was hit
+		nlohmann::ordered_json ToJson() const
+		{
+			nlohmann::ordered_json json = nlohmann::ordered_json::object();
+
+			for (size_t i = 0; i < m_values.size(); ++i)
+			{
+				const SValue& value = m_values[i];
+				const uint64_t count = value.count.load(std::memory_order_relaxed);
+				if (count == 0)
+					continue;
+
+				nlohmann::ordered_json& entry = json[GetStatName(static_cast<EStat>(i))];
+				entry["count"] = count;
+
+				if (const uint64_t totalNs = value.totalNs.load(std::memory_order_relaxed); totalNs > 0)
+				{
+					entry["totalUs"] = totalNs / 1000;
+					entry["maxUs"] = value.maxNs.load(std::memory_order_relaxed) / 1000;
+				}
+			}
+
+			return json;
+		}
+
+	private:
+
+		std::array<SValue, static_cast<size_t>(EStat::Count)> m_values;
+
+	};
+
+	class CScopedStatTimer
+	{
+
+	public:
+
+		CScopedStatTimer(CStats& stats, EStat stat)
+			: m_stats(stats)
+			, m_stat(stat)
+			, m_start(std::chrono::steady_clock::now())
+		{}
+
+		~CScopedStatTimer()
+		{
+			m_stats.Add(m_stat, std::chrono::steady_clock::now() - m_start);
+		}
+
+	private:
+
+		CStats& m_stats;
+		const EStat m_stat;
+		const std::chrono::steady_clock::time_point m_start;
+
+	};
+
+}
+
+// Instrumentation compiles to nothing unless the library is built with DASHLANE_ENABLE_STATS
+#if defined(DASHLANE_ENABLE_STATS) && DASHLANE_ENABLE_STATS
+#define DASH_STATS_CONCAT_IMPL(a, b) a##b
+#define DASH_STATS_CONCAT(a, b) DASH_STATS_CONCAT_IMPL(a, b)
+#define DASH_STAT_TIMER(pStats, stat) Utility::CScopedStatTimer DASH_STATS_CONCAT(statTimer_, __LINE__)(*(pStats), Utility::EStat::stat)
+#define DASH_STAT_INCREMENT(pStats, stat) (pStats)->Increment(Utility::EStat::stat)
+#define DASH_STAT_ADD(pStats, stat, duration) (pStats)->Add(Utility::EStat::stat, duration)
+#else
+#define DASH_STAT_TIMER(pStats, stat) (void)0
+#define DASH_STAT_INCREMENT(pStats, stat) (void)0
+#define DASH_STAT_ADD(pStats, stat, duration) (void)0
+#endif
\ No newline at end of file
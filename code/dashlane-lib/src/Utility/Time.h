@@ -1,16 +1,69 @@
-#pragma once
-
-namespace Utility
-{
-
-	inline uint64_t GetUnixTimestamp()
-	{
-		using TSystemClock = std::chrono::system_clock;
-		using TSeconds = std::chrono::seconds;
-		using TDuration = std::chrono::system_clock::duration;
-
-		const TDuration span = TSystemClock::now().time_since_epoch();
-		return std::chrono::duration_cast<TSeconds>(span).count();
-	}
-
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+
+namespace Utility
+{
+
+	inline uint64_t GetUnixTimestamp()
+	{
+		using TSystemClock = std::chrono::system_clock;
+		using TSeconds = std::chrono::seconds;
+		using TDuration = std::chrono::system_clock::duration;
+
+		const TDuration span = TSystemClock::now().time_since_epoch();
+		return std::chrono::duration_cast<TSeconds>(span).count();
+	}
+
+	// Parses an IMF-fixdate as used by the HTTP 'Date' header (e.g. "Sun, 06 Nov 1994 08:49:37 GMT")
+	// Returns the unix timestamp, or 0 if the date could not be parsed
+	inline int64_t ParseHttpDate(std::string_view date)
+	{
+		static constexpr std::string_view months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+		// Skip the day name
+		if (const size_t comma = date.find(','); comma != std::string_view::npos)
+			date.remove_prefix(comma + 1);
+
+		while (!date.empty() && date.front() == ' ')
+			date.remove_prefix(1);
+
+		// "06 Nov 1994 08:49:37 GMT"
+		if (date.size() < 20)
+			return 0;
+
+		const auto toNumber = [](std::string_view token, int& value)
+		{
+			const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+			return result.ec == std::errc() && result.ptr == token.data() + token.size();
+		};
+
+		int day = 0, year = 0, hours = 0, minutes = 0, seconds = 0;
+		if (!toNumber(date.substr(0, 2), day) ||
+			!toNumber(date.substr(7, 4), year) ||
+			!toNumber(date.substr(12, 2), hours) ||
+			!toNumber(date.substr(15, 2), minutes) ||
+			!toNumber(date.substr(18, 2), seconds))
+		{
+			return 0;
+		}
+
+		const auto monthIt = std::find(std::begin(months), std::end(months), date.substr(3, 3));
+		if (monthIt == std::end(months))
+			return 0;
+
+		const std::chrono::year_month_day ymd{
+			std::chrono::year(year),
+			std::chrono::month(static_cast<unsigned>(std::distance(std::begin(months), monthIt) + 1)),
+			std::chrono::day(static_cast<unsigned>(day)) };
+
+		if (!ymd.ok())
+			return 0;
+
+		const auto days = std::chrono::sys_days(ymd).time_since_epoch();
+		return std::chrono::duration_cast<std::chrono::seconds>(days).count() + hours * 3600 + minutes * 60 + seconds;
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Utility
+{
+
+	// Collects spans as Chrome trace events and writes them as a JSON trace file (chrome://tracing, ui.perfetto.dev).
+	// Events are buffered in memory and written when the writer is flushed or destroyed.
+	class CTraceWriter
+	{
+
+	public:
+
+		using Clock = std::chrono::steady_clock;
+
+		explicit CTraceWriter(const std::filesystem::path& path)
+			: m_path(path)
+			, m_origin(Clock::now())
+		{}
+
+		CTraceWriter(const CTraceWriter& other) = delete;
+		CTraceWriter& operator=(const CTraceWriter& other) = delete;
+
+		~CTraceWriter()
+		{
+			Flush();
+		}
+
+		// Writer of the file, shared by every context tracing to it so that a flush keeps the spans of all of them
+		static std::shared_ptr<CTraceWriter> Acquire(const std::filesystem::path& path)
+		{
+			static std::mutex s_writersMutex;
+			static std::map<std::filesystem::path, std::weak_ptr<CTraceWriter>> s_writers;
+
+			const std::filesystem::path key = std::filesystem::absolute(path).lexically_normal();
+
+			const std::lock_guard<std::mutex> lock(s_writersMutex);
+
+			std::erase_if(s_writers, [](const auto& writer) { return writer.second.expired(); });
+
+			std::shared_ptr<CTraceWriter> pWriter = s_writers[key].lock();
+			if (!pWriter)
+			{
+				pWriter = std::make_shared<CTraceWriter>(path);
+				s_writers[key] = pWriter;
+			}
+
+			return pWriter;
+		}
+
+		const std::filesystem::path& GetPath() const { return m_path; }
+
+		void AddSpan(const char* szName, const char* szCategory, Clock::time_point start, Clock::time_point end, nlohmann::ordered_json args = nullptr)
+		{
+			nlohmann::ordered_json event{
+				{ "name", szName },
+				{ "cat", szCategory },
+				{ "ph", "X" },
+				{ "ts", std::chrono::duration<double, std::micro>(start - m_origin).count() },
+				{ "dur", std::chrono::duration<double, std::micro>(end - start).count() },
+				{ "pid", 1 }
+			};
+
+			if (!args.is_null())
+				event["args"] = std::move(args);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			event["tid"] = GetThreadId();
+			m_events.emplace_back(std::move(event));
+		}
+
+		// Labels the calling thread in the trace viewer
+		void SetThreadName(const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_threadNames[GetThreadId()] = name;
+		}
+
+		bool Flush()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			nlohmann::ordered_json events = nlohmann::ordered_json::array();
+			for (const auto& [tid, name] : m_threadNames)
+			{
+				events.push_back({ { "name", "thread_name" }, { "ph", "M" }, { "pid", 1 }, { "tid", tid }, { "args", { { "name", name } } } });
+			}
+
+			for (const nlohmann::ordered_json& event : m_events)
+				events.push_back(event);
+
+			std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+			if (!file)
+				return false;
+
+			file << nlohmann::ordered_json{ { "displayTimeUnit", "ms" }, { "traceEvents", std::move(events) } }.dump();
+			return file.good();
+		}
+
+	private:
+
+		// Small sequential identifiers read better in the viewer than native thread ids, must be called with the lock held
+		uint32_t GetThreadId()
+		{
+			const auto [it, inserted] = m_threadIds.try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(m_threadIds.size() + 1));
+			if (inserted)
+				m_threadNames.try_emplace(it->second, std::format("Thread {}", it->second));
+
+			return it->second;
+		}
+
+		const std::filesystem::path m_path;
+		const Clock::time_point m_origin;
+
+		std::mutex m_mutex;
+		std::vector<nlohmann::ordered_json> m_events;
+		std::unordered_map<std::thread::id, uint32_t> m_threadIds;
+		std::map<uint32_t, std::string> m_threadNames;
+
+	};
+
+	// Records a span covering its scope, does nothing when tracing is disabled (null writer)
+	class CScopedTraceSpan
+	{
+
+	public:
+
+		CScopedTraceSpan(CTraceWriter* pTrace, const char* szName, const char* szCategory)
+			: m_pTrace(pTrace)
+			, m_szName(szName)
+			, m_szCategory(szCategory)
+		{
+			if (m_pTrace != nullptr)
+				m_start = CTraceWriter::Clock::now();
+		}
+
+		~CScopedTraceSpan()
+		{
+			if (m_pTrace != nullptr)
+				m_pTrace->AddSpan(m_szName, m_szCategory, m_start, CTraceWriter::Clock::now(), std::move(m_args));
+		}
+
+		template<typename T>
+		void AddArg(const char* szKey, T&& value)
+		{
+			if (m_pTrace != nullptr)
+				m_args[szKey] = std::forward<T>(value);
+		}
+
+	private:
+
+		CTraceWriter* const m_pTrace;
+		const char* const m_szName;
+		const char* const m_szCategory;
+		CTraceWriter::Clock::time_point m_start;
+		nlohmann::ordered_json m_args;
+
+	};
+
+}
+
+#define DASH_TRACE_CONCAT_IMPL(a, b) a##b
+#define DASH_TRACE_CONCAT(a, b) DASH_TRACE_CONCAT_IMPL(a, b)
+#define DASH_TRACE_SPAN(pTrace, name, category) Utility::CScopedTraceSpan DASH_TRACE_CONCAT(traceSpan_, __LINE__)((pTrace).get(), name, category)
\ No newline at end of file
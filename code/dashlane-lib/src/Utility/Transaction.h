@@ -1,71 +1,155 @@
-#pragma once
-
-#include <Types/transactions.h>
-#include <pugixml.hpp>
-
-namespace Utility
-{
-
-	namespace detail
-	{
-		inline void MapTransactionKeyValuePairs(const pugi::xml_node& node, std::unordered_map<std::string, std::string>& mappedPairs)
-		{
-			for (const auto& child : node.children())
-			{
-				mappedPairs[child.attribute("key").value()] = child.child_value();
-			}
-		}
-	}
-
-	inline std::unique_ptr<Dashlane::ITransactionBase> XmlToTransaction(const std::vector<uint8_t>& xmlBuffer)
-	{
-		pugi::xml_document doc;
-		pugi::xml_parse_result result = doc.load_buffer(xmlBuffer.data(), xmlBuffer.size());
-
-		const pugi::xml_node& root = doc.child("root");
-
-		if (root)
-		{
-			std::unordered_map<std::string, std::string> mappedPairs;
-			if (const pugi::xml_node& authentifiant = root.child("KWAuthentifiant"))
-			{
-				detail::MapTransactionKeyValuePairs(authentifiant, mappedPairs);
-				const nlohmann::ordered_json json(mappedPairs);
-				return std::make_unique<Dashlane::STransactionAuthentifiant>(json.get<Dashlane::STransactionAuthentifiant>());
-			}
-			else if (const pugi::xml_node& authentifiant = root.child("KWSecureNote"))
-			{
-				detail::MapTransactionKeyValuePairs(authentifiant, mappedPairs);
-				const nlohmann::ordered_json json(mappedPairs);
-				return std::make_unique<Dashlane::STransactionSecureNote>(json.get<Dashlane::STransactionSecureNote>());
-			}
-		}
-
-		return std::make_unique<Dashlane::STransactionUnknown>();
-	}
-
-	inline nlohmann::ordered_json XmlToJsonTransaction(const std::vector<uint8_t>& xmlBuffer)
-	{
-		pugi::xml_document doc;
-		pugi::xml_parse_result result = doc.load_buffer(xmlBuffer.data(), xmlBuffer.size());
-
-		const pugi::xml_node& root = doc.child("root");
-		if (root)
-		{
-			std::unordered_map<std::string, std::string> mappedPairs;
-			if (const pugi::xml_node& authentifiant = root.child("KWAuthentifiant"))
-			{
-				detail::MapTransactionKeyValuePairs(authentifiant, mappedPairs);
-				return nlohmann::ordered_json(mappedPairs);
-			}
-			else if (const pugi::xml_node& secureNote = root.child("KWSecureNote"))
-			{
-				detail::MapTransactionKeyValuePairs(secureNote, mappedPairs);
-				return nlohmann::ordered_json(mappedPairs);
-			}
-		}
-
-		return {};
-	}
-
+#pragma once
+
+#include <dashlane/Dashlane.h>
+#include <Types/transactions.h>
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <memory_resource>
+
+namespace Utility
+{
+
+	namespace detail
+	{
+		template<typename TMap>
+		inline void MapTransactionKeyValuePairs(const pugi::xml_node& node, TMap& mappedPairs)
+		{
+			for (const auto& child : node.children())
+			{
+				mappedPairs[child.attribute("key").value()] = child.child_value();
+			}
+		}
+	}
+
+	inline std::unique_ptr<Dashlane::ITransactionBase> XmlToTransaction(const std::vector<uint8_t>& xmlBuffer)
+	{
+		pugi::xml_document doc;
+		pugi::xml_parse_result result = doc.load_buffer(xmlBuffer.data(), xmlBuffer.size());
+
+		const pugi::xml_node& root = doc.child("root");
+
+		if (root)
+		{
+			std::unordered_map<std::string, std::string> mappedPairs;
+			if (const pugi::xml_node& authentifiant = root.child("KWAuthentifiant"))
+			{
+				detail::MapTransactionKeyValuePairs(authentifiant, mappedPairs);
+				const nlohmann::ordered_json json(mappedPairs);
+				return std::make_unique<Dashlane::STransactionAuthentifiant>(json.get<Dashlane::STransactionAuthentifiant>());
+			}
+			else if (const pugi::xml_node& authentifiant = root.child("KWSecureNote"))
+			{
+				detail::MapTransactionKeyValuePairs(authentifiant, mappedPairs);
+				const nlohmann::ordered_json json(mappedPairs);
+				return std::make_unique<Dashlane::STransactionSecureNote>(json.get<Dashlane::STransactionSecureNote>());
+			}
+		}
+
+		return std::make_unique<Dashlane::STransactionUnknown>();
+	}
+
+	inline nlohmann::ordered_json XmlToJsonTransaction(const std::vector<uint8_t>& xmlBuffer)
+	{
+		pugi::xml_document doc;
+		pugi::xml_parse_result result = doc.load_buffer(xmlBuffer.data(), xmlBuffer.size());
+
+		const pugi::xml_node& root = doc.child("root");
+		if (root)
+		{
+			std::unordered_map<std::string, std::string> mappedPairs;
+			if (const pugi::xml_node& authentifiant = root.child("KWAuthentifiant"))
+			{
+				detail::MapTransactionKeyValuePairs(authentifiant, mappedPairs);
+				return nlohmann::ordered_json(mappedPairs);
+			}
+			else if (const pugi::xml_node& secureNote = root.child("KWSecureNote"))
+			{
+				detail::MapTransactionKeyValuePairs(secureNote, mappedPairs);
+				return nlohmann::ordered_json(mappedPairs);
+			}
+		}
+
+		return {};
+	}
+
+	// Key/value pairs of a transaction item, viewing the XML buffer parsed in place. Keys are unique, the last value wins
+	using TransactionFields = std::pmr::vector<std::pair<std::string_view, std::string_view>>;
+
+	// Parses in place, xmlBuffer is modified and must outlive the fields
+	inline ETransactionType XmlToTransactionFields(std::span<uint8_t> xmlBuffer, TransactionFields& fields)
+	{
+		fields.clear();
+
+		// UTF-8 is forced, any conversion would leave the values in a buffer owned by the document
+		pugi::xml_document doc;
+		doc.load_buffer_inplace(xmlBuffer.data(), xmlBuffer.size(), pugi::parse_default, pugi::encoding_utf8);
+
+		const pugi::xml_node& root = doc.child("root");
+		if (!root)
+			return ETransactionType::Unknown;
+
+		ETransactionType type = ETransactionType::Authentifiant;
+		pugi::xml_node item = root.child("KWAuthentifiant");
+		if (!item)
+		{
+			type = ETransactionType::SecureNote;
+			item = root.child("KWSecureNote");
+		}
+
+		if (!item)
+			return ETransactionType::Unknown;
+
+		for (const auto& child : item.children())
+		{
+			const std::string_view key = child.attribute("key").value();
+			const std::string_view value = child.child_value();
+
+			const auto it = std::ranges::find(fields, key, &TransactionFields::value_type::first);
+			if (it != fields.end())
+				it->second = value;
+			else
+				fields.emplace_back(key, value);
+		}
+
+		return type;
+	}
+
+	// JSON of the fields, null for an unknown item. Members keep the order of the key/value map the JSON was
+	// always built from, so the dump does not change
+	inline nlohmann::ordered_json TransactionFieldsToJson(ETransactionType type, const TransactionFields& fields, std::pmr::memory_resource* pResource)
+	{
+		if (type == ETransactionType::Unknown)
+			return {};
+
+		std::pmr::unordered_map<std::pmr::string, std::string_view> mappedPairs(pResource);
+		for (const auto& [key, value] : fields)
+			mappedPairs.emplace(std::pmr::string(key, pResource), value);
+
+		nlohmann::ordered_json json = nlohmann::ordered_json::object();
+		for (const auto& [key, value] : mappedPairs)
+			json.emplace(std::string(key), std::string(value));
+
+		return json;
+	}
+
+	// Parses in place, xmlBuffer is modified and the transient key/value map is allocated from pResource
+	inline nlohmann::ordered_json XmlToJsonTransaction(std::span<uint8_t> xmlBuffer, std::pmr::memory_resource* pResource)
+	{
+		TransactionFields fields(pResource);
+		const ETransactionType type = XmlToTransactionFields(xmlBuffer, fields);
+
+		return TransactionFieldsToJson(type, fields, pResource);
+	}
+
+	// Compact dump, same output as nlohmann::ordered_json::dump() but into a string of the caller's allocator
+	inline void DumpJsonTransaction(const nlohmann::ordered_json& json, std::pmr::string& output)
+	{
+		output.clear();
+
+		nlohmann::detail::serializer<nlohmann::ordered_json> serializer(
+			nlohmann::detail::output_adapter<char, std::pmr::string>(output), ' ', nlohmann::ordered_json::error_handler_t::strict);
+		serializer.dump(json, false, false, 0);
+	}
+
 }
\ No newline at end of file
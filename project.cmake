@@ -1,16 +1,31 @@
-set(DCCLI_CLI_DIR ${OCT_BASE_DIR}/code/dashlane-cli)
-set(DCCLI_LIB_DIR ${OCT_BASE_DIR}/code/dashlane-lib)
-message(STATUS "DCCLI_CLI_DIR = ${DCCLI_CLI_DIR}")
-message(STATUS "DCCLI_LIB_DIR = ${DCCLI_LIB_DIR}")
-
-# Build chain
-add_subdirectory(${OCT_EXT_LIBS_DIR}/argon2)
-add_subdirectory(${OCT_EXT_LIBS_DIR}/base64pp)
-add_subdirectory(${OCT_EXT_LIBS_DIR}/clip)
-add_subdirectory(${OCT_EXT_LIBS_DIR}/curl)
-add_subdirectory(${OCT_EXT_LIBS_DIR}/keychain)
-add_subdirectory(${OCT_EXT_LIBS_DIR}/pugixml)
-add_subdirectory(${OCT_EXT_LIBS_DIR}/sqlite3cpp)
-add_subdirectory(${OCT_EXT_LIBS_DIR}/zlib)
-add_subdirectory(${DCCLI_LIB_DIR})
-add_subdirectory(${DCCLI_CLI_DIR})
\ No newline at end of file
+set(DCCLI_CLI_DIR ${OCT_BASE_DIR}/code/dashlane-cli)
+set(DCCLI_LIB_DIR ${OCT_BASE_DIR}/code/dashlane-lib)
+set(DCCLI_BENCH_DIR ${OCT_BASE_DIR}/code/dashlane-bench)
+message(STATUS "DCCLI_CLI_DIR = ${DCCLI_CLI_DIR}")
+message(STATUS "DCCLI_LIB_DIR = ${DCCLI_LIB_DIR}")
+message(STATUS "DCCLI_BENCH_DIR = ${DCCLI_BENCH_DIR}")
+
+# The benchmark SDK is not part of the sdks.7z archive, the mock server and dashlane-check are built either way
+option(DCCLI_BUILD_BENCHMARKS "Build the dashlane-bench target (requires the benchmark SDK)" OFF)
+if(DCCLI_BUILD_BENCHMARKS AND NOT EXISTS ${OCT_SDKS_DIR}/benchmark/_src)
+	message(FATAL_ERROR "DCCLI_BUILD_BENCHMARKS requires the benchmark SDK in ${OCT_SDKS_DIR}/benchmark/_src")
+endif()
+
+# dashlane-check is registered with CTest
+enable_testing()
+
+# Build chain
+add_subdirectory(${OCT_EXT_LIBS_DIR}/argon2)
+add_subdirectory(${OCT_EXT_LIBS_DIR}/base64pp)
+if(DCCLI_BUILD_BENCHMARKS)
+	add_subdirectory(${OCT_EXT_LIBS_DIR}/benchmark)
+endif()
+add_subdirectory(${OCT_EXT_LIBS_DIR}/clip)
+add_subdirectory(${OCT_EXT_LIBS_DIR}/curl)
+add_subdirectory(${OCT_EXT_LIBS_DIR}/keychain)
+add_subdirectory(${OCT_EXT_LIBS_DIR}/pugixml)
+add_subdirectory(${OCT_EXT_LIBS_DIR}/sqlite3cpp)
+add_subdirectory(${OCT_EXT_LIBS_DIR}/zlib)
+add_subdirectory(${DCCLI_LIB_DIR})
+add_subdirectory(${DCCLI_CLI_DIR})
+add_subdirectory(${DCCLI_BENCH_DIR})
\ No newline at end of file